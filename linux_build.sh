@@ -0,0 +1,55 @@
+#!/bin/sh
+# Copyright (c) 2025 Traian Avram. All rights reserved.
+# This source file is part of the PvZ-Remake project and is distributed under the MIT license.
+
+cd "$(dirname "$0")" || exit 1
+mkdir -p "build"
+cd "build" || exit 1
+
+SourceFiles="../source/pvz.cpp \
+             ../source/pvz_asset.cpp \
+             ../source/pvz_memory.cpp \
+             ../source/pvz_renderer.cpp \
+             ../source/pvz_task_queue.cpp \
+             ../source/pvz_linux.cpp"
+
+#
+# Description of the common compiler flags used below:
+#   -std=c++17          - Use C++ 17 as the standard.
+#   -fno-rtti           - Disables runtime type information (RTTI).
+#   -fno-exceptions     - Disables exception handling.
+#   -g                  - Generate debug information.
+#   -O0                 - (Optional) Do not perform any optimizations.
+#   -O2                 - (Optional) Perform full optimizations.
+#
+CommonCompilerDefines="-DPVZ_LINUX -DPVZ_INTERNAL"
+CommonCompilerFlags="-std=c++17 -fno-rtti -fno-exceptions -g -O2"
+CommonLinkerFlags="-pthread"
+Compiler="${CXX:-c++}"
+
+echo "Compiling game source..."
+$Compiler $CommonCompilerFlags $CommonCompilerDefines $SourceFiles $CommonLinkerFlags -o PVZ-Remake || exit 1
+echo "Done."
+
+echo
+echo "Verifying the span kernels..."
+./PVZ-Remake --verify-kernels 20000 --seed 1 || exit 1
+echo "Done."
+
+echo
+echo "Compiling tools source..."
+if $Compiler $CommonCompilerFlags $CommonCompilerDefines ../source/tools/pvzt_bap.cpp $CommonLinkerFlags -o bap; then
+    BAPCompiledSuccessfully=1
+else
+    BAPCompiledSuccessfully=0
+fi
+echo "Done."
+
+echo
+if [ "$BAPCompiledSuccessfully" -eq 1 ]; then
+    echo "Building the asset pack..."
+    ./bap "../assets" "PVZ-Remake-Assets.data"
+    echo "Done."
+else
+    echo "The asset pack build tool was not successfully compiled. Skipping asset pack building!"
+fi
@@ -379,12 +379,19 @@ struct game_config
     game_projectile_config              Projectiles [PROJECTILE_TYPE_MAX_COUNT];
 };
 
+// NOTE(Traian): Viewports larger than this don't use the static layer, and render the static content every frame.
+#define GAME_STATIC_LAYER_MAX_SIZE_X (2560)
+#define GAME_STATIC_LAYER_MAX_SIZE_Y (1600)
+
 struct game_state
 {
     memory_arena*                       PermanentArena;
     memory_arena*                       TransientArena;
     game_assets                         Assets;
     renderer                            Renderer;
+    // NOTE(Traian): Caches the content that doesn't change between frames (the background and the frames of the
+    // user interface), which is then copied at the start of each frame instead of being rasterized again.
+    renderer_layer                      StaticLayer;
     game_camera                         Camera;
     game_garden_grid                    GardenGrid;
     game_sun_counter                    SunCounter;
@@ -643,7 +650,7 @@ Game_SetDefaultConfiguration(game_state* GameState)
 }
 
 function struct game_state*
-Game_Initialize(platform_game_memory* GameMemory)
+Game_Initialize(platform_game_memory* GameMemory, platform_task_queue* TaskQueue)
 {
     game_state* GameState = PUSH(GameMemory->PermanentArena, game_state);
     GameState->PermanentArena = GameMemory->PermanentArena;
@@ -660,13 +667,34 @@ Game_Initialize(platform_game_memory* GameMemory)
     {
         PANIC("Failed to open the asset file!");
     }
-    Asset_Initialize(&GameState->Assets, GameState->TransientArena, AssetFileHandle);
+    Asset_Initialize(&GameState->Assets, GameState->TransientArena, AssetFileHandle, TaskQueue);
+
+    // NOTE(Traian): Atlas textures are only queued once the sprite atlas is ready, so the atlas is loaded right away
+    // (which, when the asset file is mapped, only decodes the headers of its pages). It is not present at all in asset
+    // packs whose sprites are stored as standalone (tiled) textures.
+    if (Asset_IsPresent(&GameState->Assets, GAME_ASSET_ID_SPRITE_ATLAS))
+    {
+        Asset_LoadSync(&GameState->Assets, GAME_ASSET_ID_SPRITE_ATLAS);
+    }
+
+    // NOTE(Traian): Start loading all assets in the background. The render code never waits for an asset, and instead
+    // skips drawing it until the asset is ready.
+    for (u32 AssetID = GAME_ASSET_ID_NONE + 1; AssetID < GAME_ASSET_ID_MAX_COUNT; ++AssetID)
+    {
+        if (AssetID == GAME_ASSET_ID_SPRITE_ATLAS)
+        {
+            continue;
+        }
+        Asset_LoadAsync(&GameState->Assets, (game_asset_id)AssetID, TaskQueue);
+    }
 
     //
     // NOTE(Traian): Initialize the renderer.
     //
 
     Renderer_Initialize(&GameState->Renderer, GameState->PermanentArena);
+    Renderer_CreateLayer(&GameState->StaticLayer, GameState->PermanentArena,
+                         GAME_STATIC_LAYER_MAX_SIZE_X, GAME_STATIC_LAYER_MAX_SIZE_Y);
 
     //
     // NOTE(Traian): Initialize the game layers.
@@ -686,18 +714,58 @@ Game_Initialize(platform_game_memory* GameMemory)
 //----------------------------------------------------- UPDATING -----------------------------------------------------//
 //====================================================================================================================//
 
+internal void
+Game_RenderStatic(game_state* GameState, game_platform_state* PlatformState)
+{
+    Renderer_PushPrimitive(&GameState->Renderer, Vec2(0, 0), Vec2(1, 1), -1.0F, Color4(0.1F, 0.1F, 0.1F));
+
+    GameGardenGrid_RenderStatic(GameState, PlatformState);
+    GameSunCounter_RenderStatic(GameState, PlatformState);
+    GamePlantSelector_RenderStatic(GameState, PlatformState);
+    GameShovel_RenderStatic(GameState, PlatformState);
+}
+
 function void
 Game_UpdateAndRender(game_state* GameState, game_platform_state* PlatformState, f32 DeltaTime)
 {
     Game_UpdateCamera(GameState, PlatformState->RenderTarget);
-    Renderer_BeginFrame(&GameState->Renderer, PlatformState->RenderTarget->SizeX, PlatformState->RenderTarget->SizeY);
-    Renderer_PushPrimitive(&GameState->Renderer, Vec2(0, 0), Vec2(1, 1), -1.0F, Color4(0.1F, 0.1F, 0.1F));
 
     GameGardenGrid_Update(GameState, PlatformState, DeltaTime);
     GameSunCounter_Update(GameState, PlatformState, DeltaTime);
     GamePlantSelector_Update(GameState, PlatformState, DeltaTime);
     GameShovel_Update(GameState, PlatformState, DeltaTime);
 
+    const u32 ViewportSizeX = PlatformState->RenderTarget->SizeX;
+    const u32 ViewportSizeY = PlatformState->RenderTarget->SizeY;
+    const u32 ThreadCount = PlatformTaskQueue_GetThreadCount(PlatformState->TaskQueue);
+    Renderer_SetIncrementalMode(&GameState->Renderer, PlatformState->UseIncrementalRendering);
+
+    //
+    // NOTE(Traian): Render the static content into its layer, but only when the layer was invalidated (which happens
+    // when the viewport is resized). All static content is drawn below the dynamic content, so the frame looks exactly
+    // the same as when everything is rendered in a single pass.
+    //
+
+    const b8 UseStaticLayer = Renderer_PrepareLayer(&GameState->StaticLayer, ViewportSizeX, ViewportSizeY);
+    if (UseStaticLayer && !GameState->StaticLayer.IsValid)
+    {
+        Renderer_BeginFrame(&GameState->Renderer, ViewportSizeX, ViewportSizeY, ThreadCount);
+        Game_RenderStatic(GameState, PlatformState);
+        Renderer_EndFrame(&GameState->Renderer);
+        Renderer_DispatchClusters(&GameState->Renderer, &GameState->StaticLayer.Image, PlatformState->TaskQueue);
+        Renderer_MarkLayerRendered(&GameState->StaticLayer);
+    }
+
+    Renderer_BeginFrame(&GameState->Renderer, ViewportSizeX, ViewportSizeY, ThreadCount);
+    if (UseStaticLayer)
+    {
+        Renderer_SetBackgroundLayer(&GameState->Renderer, &GameState->StaticLayer);
+    }
+    else
+    {
+        Game_RenderStatic(GameState, PlatformState);
+    }
+
     GameGardenGrid_Render(GameState, PlatformState);
     GameSunCounter_Render(GameState, PlatformState);
     GamePlantSelector_Render(GameState, PlatformState);
@@ -10,36 +10,167 @@
 internal void
 Asset_ReadTextureFromStream(asset* Asset, memory_stream* AssetStream, memory_arena* Arena)
 {
-    ZERO_STRUCT_POINTER(Asset);
-    Asset->Type = ASSET_TYPE_TEXTURE;
+    ASSERT(Asset->Type == ASSET_TYPE_TEXTURE);
+    ZERO_STRUCT_POINTER(&Asset->Texture);
 
     const asset_header_texture* TextureHeader = CONSUME(AssetStream, asset_header_texture);
-    renderer_image Image = {};
-    Image.SizeX = TextureHeader->SizeX;
-    Image.SizeY = TextureHeader->SizeY;
-    // TODO(Traian): Read the texture format from the asset file!
-    Image.Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
+    if (TextureHeader->BytesPerPixel != 4)
+    {
+        PANIC("Invalid texture BPP read from the asset file!");
+    }
+    if (TextureHeader->MipCount == 0)
+    {
+        PANIC("Invalid texture mip count read from the asset file!");
+    }
 
-    const memory_size PixelBufferByteCount = (memory_size)TextureHeader->SizeX *
-                                             (memory_size)TextureHeader->SizeY *
-                                             TextureHeader->BytesPerPixel;
-    if (TextureHeader->BytesPerPixel == 4)
+    // NOTE(Traian): The mip chain is generated by the asset packer, so the mips simply reference the pixels that were
+    // read from the asset file, without any processing.
+    renderer_image* Mips = PUSH_ARRAY(Arena, renderer_image, TextureHeader->MipCount);
+    for (u32 MipLevel = 0; MipLevel < TextureHeader->MipCount; ++MipLevel)
     {
-        Image.PixelBuffer = CONSUME_ARRAY(AssetStream, u32, PixelBufferByteCount / sizeof(u32));
+        renderer_image* Mip = Mips + MipLevel;
+        ZERO_STRUCT_POINTER(Mip);
+        Mip->SizeX = TextureHeader->SizeX >> MipLevel;
+        Mip->SizeY = TextureHeader->SizeY >> MipLevel;
+        // TODO(Traian): Read the texture format from the asset file!
+        Mip->Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
+        Mip->IsAlphaPremultiplied = (TextureHeader->Flags & ASSET_TEXTURE_FLAG_PREMULTIPLIED_ALPHA) != 0;
+        // NOTE(Traian): The asset packer bakes the border of each mip.
+        Mip->IsPadded = true;
+
+        memory_size PixelBufferByteCount;
+        if (TextureHeader->Flags & ASSET_TEXTURE_FLAG_TILED)
+        {
+            Mip->Layout = RENDERER_IMAGE_LAYOUT_TILED;
+            Mip->Stride = Image_GetTiledStride(Mip->SizeX);
+            PixelBufferByteCount = Image_GetTiledBufferByteCount(Mip->SizeX, Mip->SizeY, Mip->Format);
+        }
+        else
+        {
+            Mip->Layout = RENDERER_IMAGE_LAYOUT_LINEAR;
+            Mip->Stride = Mip->SizeX + 1;
+            PixelBufferByteCount = Image_GetPaddedBufferByteCount(Mip->SizeX, Mip->SizeY, Mip->Format);
+        }
+        Mip->PixelBuffer = CONSUME_ARRAY(AssetStream, u32, PixelBufferByteCount / sizeof(u32));
     }
-    else
+
+    for (u32 MipLevel = 0; MipLevel < TextureHeader->MipCount; ++MipLevel)
     {
-        PANIC("Invalid texture BPP read from the asset file!");
+        renderer_image* Mip = Mips + MipLevel;
+        Mip->RowSpans = CONSUME_ARRAY(AssetStream, renderer_image_row_span, Mip->SizeY);
+    }
+
+    Texture_CreateFromMipChain(&Asset->Texture.RendererTexture, Mips, TextureHeader->MipCount);
+    Asset->Texture.RendererTexture.IsOpaque = (TextureHeader->Flags & ASSET_TEXTURE_FLAG_OPAQUE) != 0;
+}
+
+internal void
+Asset_ReadSpriteAtlasFromStream(asset* Asset, memory_stream* AssetStream, memory_arena* Arena)
+{
+    ASSERT(Asset->Type == ASSET_TYPE_SPRITE_ATLAS);
+    ZERO_STRUCT_POINTER(&Asset->SpriteAtlas);
+
+    const asset_header_sprite_atlas* AtlasHeader = CONSUME(AssetStream, asset_header_sprite_atlas);
+    if (AtlasHeader->PageCount == 0 || AtlasHeader->MipCount == 0)
+    {
+        PANIC("Invalid sprite atlas read from the asset file!");
     }
 
-    Texture_Create(&Asset->Texture.RendererTexture, Arena, &Image, 6);
+    asset_sprite_atlas* Atlas = &Asset->SpriteAtlas;
+    Atlas->PageCount = AtlasHeader->PageCount;
+    Atlas->MipCount = AtlasHeader->MipCount;
+    Atlas->PageMips = PUSH_ARRAY(Arena, renderer_image, Atlas->PageCount * Atlas->MipCount);
+
+    const asset_sprite_atlas_page_header* PageHeaders = CONSUME_ARRAY(AssetStream, asset_sprite_atlas_page_header,
+                                                                      Atlas->PageCount);
+    for (u32 PageIndex = 0; PageIndex < Atlas->PageCount; ++PageIndex)
+    {
+        const asset_sprite_atlas_page_header* PageHeader = PageHeaders + PageIndex;
+        if ((PageHeader->SizeX >> (Atlas->MipCount - 1)) == 0 || (PageHeader->SizeY >> (Atlas->MipCount - 1)) == 0)
+        {
+            PANIC("Invalid sprite atlas page read from the asset file!");
+        }
+
+        // NOTE(Traian): Just like for regular textures, the mips simply reference the pixels read from the asset file.
+        for (u32 MipLevel = 0; MipLevel < Atlas->MipCount; ++MipLevel)
+        {
+            renderer_image* Mip = Atlas->PageMips + (PageIndex * Atlas->MipCount) + MipLevel;
+            ZERO_STRUCT_POINTER(Mip);
+            Mip->SizeX = PageHeader->SizeX >> MipLevel;
+            Mip->SizeY = PageHeader->SizeY >> MipLevel;
+            Mip->Stride = Mip->SizeX + 1;
+            Mip->Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
+            Mip->Layout = RENDERER_IMAGE_LAYOUT_LINEAR;
+            Mip->IsAlphaPremultiplied = true;
+            Mip->IsPadded = true;
+
+            const memory_size PixelBufferByteCount = Image_GetPaddedBufferByteCount(Mip->SizeX, Mip->SizeY,
+                                                                                    Mip->Format);
+            Mip->PixelBuffer = CONSUME_ARRAY(AssetStream, u32, PixelBufferByteCount / sizeof(u32));
+        }
+    }
+}
+
+internal void
+Asset_ReadAtlasTextureFromStream(asset* Asset, memory_stream* AssetStream, memory_arena* Arena,
+                                 const asset_sprite_atlas* Atlas)
+{
+    ASSERT(Asset->Type == ASSET_TYPE_ATLAS_TEXTURE);
+    ZERO_STRUCT_POINTER(&Asset->Texture);
+
+    const asset_header_atlas_texture* TextureHeader = CONSUME(AssetStream, asset_header_atlas_texture);
+    if (TextureHeader->PageIndex >= Atlas->PageCount)
+    {
+        PANIC("Invalid atlas texture page read from the asset file!");
+    }
+    if (TextureHeader->MipCount == 0 || TextureHeader->MipCount > Atlas->MipCount)
+    {
+        PANIC("Invalid atlas texture mip count read from the asset file!");
+    }
+
+    const renderer_image* PageMips = Atlas->PageMips + (TextureHeader->PageIndex * Atlas->MipCount);
+    if ((TextureHeader->SizeX >> (TextureHeader->MipCount - 1)) == 0 ||
+        (TextureHeader->SizeY >> (TextureHeader->MipCount - 1)) == 0 ||
+        TextureHeader->OffsetX + TextureHeader->SizeX + 2 > PageMips[0].SizeX ||
+        TextureHeader->OffsetY + TextureHeader->SizeY + 2 > PageMips[0].SizeY)
+    {
+        PANIC("Invalid atlas texture rectangle read from the asset file!");
+    }
+
+    // NOTE(Traian): Each mip is a view into the corresponding mip of the page. The texels that follow the rectangle in
+    // the page replicate its edges, so the view is padded just like a standalone mip.
+    renderer_image* Mips = PUSH_ARRAY(Arena, renderer_image, TextureHeader->MipCount);
+    for (u32 MipLevel = 0; MipLevel < TextureHeader->MipCount; ++MipLevel)
+    {
+        const renderer_image* PageMip = PageMips + MipLevel;
+        renderer_image* Mip = Mips + MipLevel;
+        ZERO_STRUCT_POINTER(Mip);
+        Mip->SizeX = TextureHeader->SizeX >> MipLevel;
+        Mip->SizeY = TextureHeader->SizeY >> MipLevel;
+        Mip->Stride = PageMip->Stride;
+        Mip->Format = PageMip->Format;
+        Mip->Layout = PageMip->Layout;
+        Mip->IsAlphaPremultiplied = PageMip->IsAlphaPremultiplied;
+        Mip->IsPadded = true;
+        Mip->PixelBuffer = (void*)Image_GetPixelAddress(PageMip, TextureHeader->OffsetX >> MipLevel,
+                                                        TextureHeader->OffsetY >> MipLevel);
+    }
+
+    for (u32 MipLevel = 0; MipLevel < TextureHeader->MipCount; ++MipLevel)
+    {
+        renderer_image* Mip = Mips + MipLevel;
+        Mip->RowSpans = CONSUME_ARRAY(AssetStream, renderer_image_row_span, Mip->SizeY);
+    }
+
+    Texture_CreateFromMipChain(&Asset->Texture.RendererTexture, Mips, TextureHeader->MipCount);
+    Asset->Texture.RendererTexture.IsOpaque = (TextureHeader->Flags & ASSET_TEXTURE_FLAG_OPAQUE) != 0;
 }
 
 internal void
 Asset_ReadFontFromStream(asset* Asset, memory_stream* AssetStream, memory_arena* Arena)
 {
-    ZERO_STRUCT_POINTER(Asset);
-    Asset->Type = ASSET_TYPE_FONT;
+    ASSERT(Asset->Type == ASSET_TYPE_FONT);
+    ZERO_STRUCT_POINTER(&Asset->Font);
 
     const asset_header_font* FontHeader = CONSUME(AssetStream, asset_header_font);
     Asset->Font.Height = FontHeader->Height;
@@ -47,10 +178,15 @@ Asset_ReadFontFromStream(asset* Asset, memory_stream* AssetStream, memory_arena*
     Asset->Font.Descent = FontHeader->Descent;
     Asset->Font.LineGap = FontHeader->LineGap;
     Asset->Font.GlyphCount = FontHeader->GlyphCount;
+    Asset->Font.FirstCodepoint = FontHeader->FirstCodepoint;
+    Asset->Font.CodepointCount = FontHeader->CodepointCount;
 
-    Asset->Font.Glyphs = PUSH_ARRAY(Arena, asset_font_glyph, Asset->Font.GlyphCount);
-    Asset->Font.KerningTable = PUSH_ARRAY(Arena, s32, Asset->Font.GlyphCount * Asset->Font.GlyphCount);
+    if (FontHeader->AtlasMipCount == 0 || FontHeader->AtlasSizeX == 0 || FontHeader->AtlasSizeY == 0)
+    {
+        PANIC("Invalid font atlas read from the asset file!");
+    }
 
+    Asset->Font.Glyphs = PUSH_ARRAY(Arena, asset_font_glyph, Asset->Font.GlyphCount);
     for (u32 GlyphIndex = 0; GlyphIndex < FontHeader->GlyphCount; ++GlyphIndex)
     {
         asset_font_glyph* Glyph = Asset->Font.Glyphs + GlyphIndex;
@@ -61,35 +197,266 @@ Asset_ReadFontFromStream(asset* Asset, memory_stream* AssetStream, memory_arena*
         Glyph->LeftSideBearing = GlyphHeader->LeftSideBearing;
         Glyph->TextureOffsetX = GlyphHeader->TextureOffsetX;
         Glyph->TextureOffsetY = GlyphHeader->TextureOffsetY;
+        Glyph->SizeX = GlyphHeader->SizeX;
+        Glyph->SizeY = GlyphHeader->SizeY;
 
-        const renderer_image_format GLYPH_IMAGE_FORMAT = RENDERER_IMAGE_FORMAT_A8;        
-        renderer_image GlyphImage = {};
-        GlyphImage.SizeX = GlyphHeader->TextureSizeX;
-        GlyphImage.SizeY = GlyphHeader->TextureSizeY;
-        GlyphImage.Format = GLYPH_IMAGE_FORMAT;
+        if (GlyphHeader->AtlasOffsetX + GlyphHeader->SizeX > FontHeader->AtlasSizeX ||
+            GlyphHeader->AtlasOffsetY + GlyphHeader->SizeY > FontHeader->AtlasSizeY)
+        {
+            PANIC("Invalid glyph atlas rectangle read from the asset file!");
+        }
+        const f32 InverseAtlasSizeX = 1.0F / (f32)FontHeader->AtlasSizeX;
+        const f32 InverseAtlasSizeY = 1.0F / (f32)FontHeader->AtlasSizeY;
+        Glyph->AtlasMinUV = Vec2((f32)GlyphHeader->AtlasOffsetX * InverseAtlasSizeX,
+                                 (f32)GlyphHeader->AtlasOffsetY * InverseAtlasSizeY);
+        Glyph->AtlasMaxUV = Vec2((f32)(GlyphHeader->AtlasOffsetX + GlyphHeader->SizeX) * InverseAtlasSizeX,
+                                 (f32)(GlyphHeader->AtlasOffsetY + GlyphHeader->SizeY) * InverseAtlasSizeY);
+    }
 
-        const memory_size PixelBufferByteCount = (memory_size)GlyphHeader->TextureSizeX *
-                                                 (memory_size)GlyphHeader->TextureSizeY *
-                                                 Image_GetBytesPerPixelForFormat(GLYPH_IMAGE_FORMAT);
-        GlyphImage.PixelBuffer = CONSUME_ARRAY(AssetStream, u8, PixelBufferByteCount / sizeof(u8));
+    Asset->Font.GlyphIndices = CONSUME_ARRAY(AssetStream, u32, Asset->Font.CodepointCount);
 
-        Texture_Create(&Glyph->RendererTexture, Arena, &GlyphImage, 4);
+    // NOTE(Traian): Just like regular textures, the mip chain of the atlas is generated by the asset packer.
+    const renderer_image_format ATLAS_IMAGE_FORMAT = RENDERER_IMAGE_FORMAT_A8;
+    renderer_image* AtlasMips = PUSH_ARRAY(Arena, renderer_image, FontHeader->AtlasMipCount);
+    for (u32 MipLevel = 0; MipLevel < FontHeader->AtlasMipCount; ++MipLevel)
+    {
+        renderer_image* AtlasMip = AtlasMips + MipLevel;
+        ZERO_STRUCT_POINTER(AtlasMip);
+        AtlasMip->SizeX = FontHeader->AtlasSizeX >> MipLevel;
+        AtlasMip->SizeY = FontHeader->AtlasSizeY >> MipLevel;
+        AtlasMip->Format = ATLAS_IMAGE_FORMAT;
+        AtlasMip->Stride = AtlasMip->SizeX + 1;
+        AtlasMip->IsPadded = true;
+
+        const memory_size PixelBufferByteCount = Image_GetPaddedBufferByteCount(AtlasMip->SizeX, AtlasMip->SizeY,
+                                                                                ATLAS_IMAGE_FORMAT);
+        AtlasMip->PixelBuffer = CONSUME_ARRAY(AssetStream, u8, PixelBufferByteCount / sizeof(u8));
     }
+    Texture_CreateFromMipChain(&Asset->Font.AtlasTexture, AtlasMips, FontHeader->AtlasMipCount);
 
-    Asset->Font.KerningTable = CONSUME_ARRAY(AssetStream, s32, Asset->Font.GlyphCount * Asset->Font.GlyphCount);
+    Asset->Font.KerningPairCount = FontHeader->KerningPairCount;
+    Asset->Font.KerningPairOffsets = CONSUME_ARRAY(AssetStream, u32, Asset->Font.GlyphCount + 1);
+    Asset->Font.KerningPairs = CONSUME_ARRAY(AssetStream, asset_font_kerning_pair, Asset->Font.KerningPairCount);
+    if (Asset->Font.KerningPairOffsets[Asset->Font.GlyphCount] != Asset->Font.KerningPairCount)
+    {
+        PANIC("Invalid kerning pairs read from the asset file!");
+    }
+}
+
+//====================================================================================================================//
+//------------------------------------------------- ASSET COMPRESSION ------------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): Decodes a block in the LZ4 block format. The block is a sequence of (literals, match) pairs, where
+// each pair starts with a token that stores the literal length in the high nibble and the match length (minus the
+// minimum match length of 4) in the low nibble. A nibble value of 15 means that the length continues in the following
+// bytes, each one adding its value until a byte different from 255 is found. The last sequence only contains literals.
+// Returns false if the block is malformed or doesn't decompress to exactly 'DstByteCount' bytes.
+//
+internal b8
+Asset_DecompressLZ4(const u8* Src, memory_size SrcByteCount, u8* Dst, memory_size DstByteCount)
+{
+    const u8* SrcEnd = Src + SrcByteCount;
+    u8* DstBegin = Dst;
+    u8* DstEnd = Dst + DstByteCount;
+
+    while (Src < SrcEnd)
+    {
+        const u8 Token = *Src++;
+
+        memory_size LiteralLength = Token >> 4;
+        if (LiteralLength == 15)
+        {
+            u8 LengthByte;
+            do
+            {
+                if (Src >= SrcEnd)
+                {
+                    return false;
+                }
+                LengthByte = *Src++;
+                LiteralLength += LengthByte;
+            }
+            while (LengthByte == 255);
+        }
+
+        if (LiteralLength > (memory_size)(SrcEnd - Src) || LiteralLength > (memory_size)(DstEnd - Dst))
+        {
+            return false;
+        }
+        CopyMemory(Dst, Src, LiteralLength);
+        Src += LiteralLength;
+        Dst += LiteralLength;
+
+        // NOTE(Traian): The last sequence of the block has no match.
+        if (Src == SrcEnd)
+        {
+            break;
+        }
+
+        if (SrcEnd - Src < 2)
+        {
+            return false;
+        }
+        const memory_size MatchOffset = (memory_size)Src[0] | ((memory_size)Src[1] << 8);
+        Src += 2;
+        if (MatchOffset == 0 || MatchOffset > (memory_size)(Dst - DstBegin))
+        {
+            return false;
+        }
+
+        memory_size MatchLength = Token & 15;
+        if (MatchLength == 15)
+        {
+            u8 LengthByte;
+            do
+            {
+                if (Src >= SrcEnd)
+                {
+                    return false;
+                }
+                LengthByte = *Src++;
+                MatchLength += LengthByte;
+            }
+            while (LengthByte == 255);
+        }
+        MatchLength += 4;
+
+        if (MatchLength > (memory_size)(DstEnd - Dst))
+        {
+            return false;
+        }
+
+        const u8* Match = Dst - MatchOffset;
+        if (MatchOffset >= MatchLength)
+        {
+            CopyMemory(Dst, Match, MatchLength);
+        }
+        else
+        {
+            // NOTE(Traian): The match overlaps the bytes that are being written (which is how runs are encoded), so it
+            // must be copied byte by byte.
+            for (memory_size ByteIndex = 0; ByteIndex < MatchLength; ++ByteIndex)
+            {
+                Dst[ByteIndex] = Match[ByteIndex];
+            }
+        }
+        Dst += MatchLength;
+    }
+
+    return (Dst == DstEnd);
+}
+
+struct asset_decompress_chunks_data
+{
+    const u8*                       EntryData;
+    memory_size                     EntryByteCount;
+    const asset_compressed_chunk*   Chunks;
+    u8*                             UncompressedData;
+    memory_size                     UncompressedByteCount;
+};
+
+internal void
+Asset_DecompressChunks(s32 LogicalThreadIndex, u32 FirstChunkIndex, u32 EndChunkIndex, void* UserData)
+{
+    const asset_decompress_chunks_data* Data = (const asset_decompress_chunks_data*)UserData;
+    for (u32 ChunkIndex = FirstChunkIndex; ChunkIndex < EndChunkIndex; ++ChunkIndex)
+    {
+        const asset_compressed_chunk* Chunk = Data->Chunks + ChunkIndex;
+        if ((memory_size)Chunk->ByteOffset + (memory_size)Chunk->ByteCount > Data->EntryByteCount)
+        {
+            PANIC("The provided asset file contains an invalid compressed chunk and is most likely corrupted!");
+        }
+
+        const memory_size UncompressedByteOffset = ChunkIndex * ASSET_COMPRESSION_CHUNK_BYTE_COUNT;
+        memory_size UncompressedByteCount = Data->UncompressedByteCount - UncompressedByteOffset;
+        if (UncompressedByteCount > ASSET_COMPRESSION_CHUNK_BYTE_COUNT)
+        {
+            UncompressedByteCount = ASSET_COMPRESSION_CHUNK_BYTE_COUNT;
+        }
+
+        if (!Asset_DecompressLZ4(Data->EntryData + Chunk->ByteOffset, Chunk->ByteCount,
+                                 Data->UncompressedData + UncompressedByteOffset, UncompressedByteCount))
+        {
+            PANIC("Failed to decompress an asset from the asset file, which is most likely corrupted!");
+        }
+    }
+}
+
+//
+// NOTE(Traian): Decompresses all chunks of an entry, using every thread of the task queue. No memory is allocated,
+// so this can be executed without holding the load lock.
+//
+internal void
+Asset_DecompressEntry(asset* Asset, const void* EntryData, void* UncompressedData, platform_task_queue* TaskQueue)
+{
+    if (Asset->Compression != ASSET_COMPRESSION_LZ4)
+    {
+        PANIC("The provided asset file contains an entry with an unknown compression and is most likely corrupted!");
+    }
+
+    // NOTE(Traian): The chunk table is stored at the start of the entry and is aligned relative to the asset file,
+    // exactly as it was written by the asset packer.
+    const u32 ChunkCount = (u32)((Asset->AssetFileUncompressedByteCount + ASSET_COMPRESSION_CHUNK_BYTE_COUNT - 1) /
+                                 ASSET_COMPRESSION_CHUNK_BYTE_COUNT);
+    memory_stream EntryStream = {};
+    EntryStream.MemoryBlock = (u8*)EntryData - Asset->AssetFileByteOffset;
+    EntryStream.ByteCount = Asset->AssetFileByteOffset + Asset->AssetFileByteCount;
+    EntryStream.ByteOffset = Asset->AssetFileByteOffset;
+
+    asset_decompress_chunks_data Data = {};
+    Data.EntryData = (const u8*)EntryData;
+    Data.EntryByteCount = Asset->AssetFileByteCount;
+    Data.Chunks = CONSUME_ARRAY(&EntryStream, asset_compressed_chunk, ChunkCount);
+    Data.UncompressedData = (u8*)UncompressedData;
+    Data.UncompressedByteCount = Asset->AssetFileUncompressedByteCount;
+
+    PlatformTaskQueue_ParallelFor(TaskQueue, ChunkCount, 1, Asset_DecompressChunks, &Data);
 }
 
 //====================================================================================================================//
 //---------------------------------------------------- GAME ASSETS ---------------------------------------------------//
 //====================================================================================================================//
 
+internal platform_read_file_result
+Asset_ReadFromAssetFile(game_assets* GameAssets, memory_size ReadOffset, memory_size ReadByteCount,
+                        memory_arena* Arena)
+{
+    platform_read_file_result Result = {};
+    if (GameAssets->MappedAssetFile)
+    {
+        // NOTE(Traian): The asset file is mapped, so just point into it. The arena is not touched at all.
+        if (ReadOffset + ReadByteCount <= GameAssets->MappedAssetFileByteCount)
+        {
+            Result.IsValid = true;
+            Result.ReadData = (u8*)GameAssets->MappedAssetFile + ReadOffset;
+            Result.ReadByteCount = ReadByteCount;
+        }
+    }
+    else
+    {
+        Result = Platform_ReadFromFile(GameAssets->AssetFileHandle, ReadOffset, ReadByteCount, Arena);
+    }
+    return Result;
+}
+
 function void
-Asset_Initialize(game_assets* GameAssets, memory_arena* TransientArena, platform_file_handle AssetFileHandle)
+Asset_Initialize(game_assets* GameAssets, memory_arena* TransientArena,
+                 platform_file_handle AssetFileHandle, platform_task_queue* TaskQueue)
 {
     ZERO_STRUCT_POINTER(GameAssets);
+    GameAssets->TaskQueue = TaskQueue;
     GameAssets->TransientArena = TransientArena;
     GameAssets->AssetFileHandle = AssetFileHandle;
 
+    const platform_map_file_result MapResult = Platform_MapFile(GameAssets->AssetFileHandle);
+    if (MapResult.IsValid)
+    {
+        GameAssets->MappedAssetFile = MapResult.MappedData;
+        GameAssets->MappedAssetFileByteCount = MapResult.MappedByteCount;
+    }
+
     // NOTE(Traian): The memory used when reading from the asset file when decoding the asset pack header and the entry
     // headers is not required to be kept alive after the initialization process finishes, and thus we use a temporary
     // arena to allocate it. This temporary arena is 'ended' at the end of the function.
@@ -100,9 +467,8 @@ Asset_Initialize(game_assets* GameAssets, memory_arena* TransientArena, platform
     // NOTE(Traian): Read asset pack header.
     //
 
-    platform_read_file_result ReadHeaderResult = Platform_ReadFromFile(GameAssets->AssetFileHandle,
-                                                                       0, sizeof(asset_pack_header),
-                                                                       ReadAssetPackArena.Arena);
+    platform_read_file_result ReadHeaderResult = Asset_ReadFromAssetFile(GameAssets, 0, sizeof(asset_pack_header),
+                                                                         ReadAssetPackArena.Arena);
     if (!ReadHeaderResult.IsValid)
     {
         PANIC("Failed to read (asset pack header) from the asset file!");
@@ -120,10 +486,10 @@ Asset_Initialize(game_assets* GameAssets, memory_arena* TransientArena, platform
     // NOTE(Traian): Read all asset pack entry headers.
     //
 
-    platform_read_file_result ReadEntriesResult = Platform_ReadFromFile(GameAssets->AssetFileHandle,
-                                                                        Stream.ByteCount,
-                                                                        AssetPackHeader.EntryCount * sizeof(asset_pack_entry_header),
-                                                                        ReadAssetPackArena.Arena);
+    platform_read_file_result ReadEntriesResult = Asset_ReadFromAssetFile(GameAssets,
+                                                                          Stream.ByteCount,
+                                                                          AssetPackHeader.EntryCount * sizeof(asset_pack_entry_header),
+                                                                          ReadAssetPackArena.Arena);
     if (!ReadEntriesResult.IsValid)
     {
         PANIC("Failed to read (asset pack entry headers) from the asset file!");   
@@ -152,23 +518,239 @@ Asset_Initialize(game_assets* GameAssets, memory_arena* TransientArena, platform
 
         asset* Asset = &GameAssets->Assets[EntryHeader.AssetID];
         Asset->Type = EntryHeader.Type;
+        Asset->Compression = EntryHeader.Compression;
         Asset->AssetFileByteOffset = EntryHeader.ByteOffset;
         Asset->AssetFileByteCount = EntryHeader.ByteCount;
+        Asset->AssetFileUncompressedByteCount = EntryHeader.UncompressedByteCount;
+
+        if (Asset->Compression == ASSET_COMPRESSION_NONE && Asset->AssetFileUncompressedByteCount != Asset->AssetFileByteCount)
+        {
+            PANIC("The provided asset file contains an uncompressed asset with an invalid size and is most likely corrupted!");
+        }
     }
 
     MemoryArena_EndTemporary(&ReadAssetPackArena);
 }
 
+//
+// NOTE(Traian): The load lock is unlocked (0), locked (1) or locked with (possibly) blocked waiters (2). A thread that
+// finds the lock taken spins for a short while, with an exponential backoff, as the lock is usually held only for a
+// short time. After that, it blocks on the address of the lock until it is woken up by the unlocking thread, so that
+// it doesn't steal the processor from the thread that does the work (for example, when the asset file can't be mapped
+// and the lock is held while reading from the disk).
+//
+
+#define ASSET_LOAD_LOCK_UNLOCKED            (0)
+#define ASSET_LOAD_LOCK_LOCKED              (1)
+#define ASSET_LOAD_LOCK_LOCKED_WITH_WAITERS (2)
+#define ASSET_LOAD_LOCK_MAX_SPIN_COUNT      (1024)
+
+internal inline void
+Asset_LockLoading(game_assets* GameAssets)
+{
+    for (u32 SpinCount = 1; SpinCount <= ASSET_LOAD_LOCK_MAX_SPIN_COUNT; SpinCount *= 2)
+    {
+        if (Platform_AtomicCompareExchange32(&GameAssets->LoadLock, ASSET_LOAD_LOCK_LOCKED,
+                                             ASSET_LOAD_LOCK_UNLOCKED) == ASSET_LOAD_LOCK_UNLOCKED)
+        {
+            return;
+        }
+
+        for (u32 SpinIndex = 0; SpinIndex < SpinCount; ++SpinIndex)
+        {
+            Platform_SpinPause();
+        }
+    }
+
+    // NOTE(Traian): Mark the lock as having waiters before blocking, so that the unlocking thread wakes this thread up.
+    // A thread that acquires the lock this way keeps the mark, as it can't know whether other threads are blocked.
+    while (Platform_AtomicExchange32(&GameAssets->LoadLock, ASSET_LOAD_LOCK_LOCKED_WITH_WAITERS) !=
+           ASSET_LOAD_LOCK_UNLOCKED)
+    {
+        Platform_WaitOnAddress32(&GameAssets->LoadLock, ASSET_LOAD_LOCK_LOCKED_WITH_WAITERS);
+    }
+}
+
+internal inline void
+Asset_UnlockLoading(game_assets* GameAssets)
+{
+    if (Platform_AtomicExchange32(&GameAssets->LoadLock, ASSET_LOAD_LOCK_UNLOCKED) ==
+        ASSET_LOAD_LOCK_LOCKED_WITH_WAITERS)
+    {
+        Platform_WakeOneOnAddress32(&GameAssets->LoadLock);
+    }
+}
+
+internal b8
+Asset_TryClaimLoad(asset* Asset)
+{
+    // NOTE(Traian): Both unloaded and queued assets can be claimed. Whichever thread changes the state to 'loading'
+    // is the one that performs the load.
+    if (Platform_AtomicCompareExchange32(&Asset->State, ASSET_STATE_LOADING, ASSET_STATE_QUEUED) == ASSET_STATE_QUEUED)
+    {
+        return true;
+    }
+    if (Platform_AtomicCompareExchange32(&Asset->State, ASSET_STATE_LOADING, ASSET_STATE_UNLOADED) == ASSET_STATE_UNLOADED)
+    {
+        return true;
+    }
+    return false;
+}
+
+internal void
+Asset_LoadClaimed(game_assets* GameAssets, asset* Asset)
+{
+    ASSERT(Platform_AtomicLoad32(&Asset->State) == ASSET_STATE_LOADING);
+
+    // NOTE(Traian): Atlas textures reference the pixels of the sprite atlas. Their loads are only started once the
+    // atlas is ready (see 'Asset_LoadSync' and 'Asset_LoadAsync'), so a load never waits for another asset.
+    const asset* SpriteAtlasAsset = NULL;
+    if (Asset->Type == ASSET_TYPE_ATLAS_TEXTURE)
+    {
+        ASSERT(Asset_GetState(GameAssets, GAME_ASSET_ID_SPRITE_ATLAS) == ASSET_STATE_READY);
+        SpriteAtlasAsset = &GameAssets->Assets[GAME_ASSET_ID_SPRITE_ATLAS];
+        if (SpriteAtlasAsset->Type != ASSET_TYPE_SPRITE_ATLAS)
+        {
+            PANIC("The provided asset file contains an invalid sprite atlas and is most likely corrupted!");
+        }
+    }
+
+    Asset_LockLoading(GameAssets);
+
+    platform_read_file_result ReadAssetFileResult = Asset_ReadFromAssetFile(GameAssets,
+                                                                            Asset->AssetFileByteOffset,
+                                                                            Asset->AssetFileByteCount,
+                                                                            GameAssets->TransientArena);
+    if (ReadAssetFileResult.IsValid)
+    {
+        void* AssetData = ReadAssetFileResult.ReadData;
+        if (Asset->Compression != ASSET_COMPRESSION_NONE)
+        {
+            // NOTE(Traian): The uncompressed data is placed at the same offset (modulo the allocation alignment) as
+            // the data of an uncompressed entry would be placed in the mapped asset file, so that all arrays inside the
+            // asset remain aligned.
+            const memory_size ALIGNMENT = 64;
+            u8* UncompressedBlock = (u8*)MemoryArena_Allocate(GameAssets->TransientArena,
+                                                              Asset->AssetFileUncompressedByteCount + ALIGNMENT,
+                                                              ALIGNMENT);
+            AssetData = UncompressedBlock + (Asset->AssetFileByteOffset % ALIGNMENT);
+
+            // NOTE(Traian): Decompressing doesn't allocate any memory, so the lock is released in the meantime. This
+            // allows other loads (and the decompression of their chunks) to make progress on the other threads.
+            // When the asset file is not mapped, the compressed data that was read into the arena is never released,
+            // but that is just a fallback path.
+            Asset_UnlockLoading(GameAssets);
+            Asset_DecompressEntry(Asset, ReadAssetFileResult.ReadData, AssetData, GameAssets->TaskQueue);
+            Asset_LockLoading(GameAssets);
+        }
+
+        // NOTE(Traian): Emulate a single asset file stream that contains the entire asset file data at once.
+        // This ensures that writing and reading from the asset file are equivalent from an alignment perspective.
+        memory_stream AssetFileStream = {};
+        AssetFileStream.MemoryBlock = (u8*)AssetData - Asset->AssetFileByteOffset;
+        AssetFileStream.ByteCount = Asset->AssetFileByteOffset + Asset->AssetFileUncompressedByteCount;
+        AssetFileStream.ByteOffset = Asset->AssetFileByteOffset;
+
+        switch (Asset->Type)
+        {
+            case ASSET_TYPE_TEXTURE:
+            {
+                Asset_ReadTextureFromStream(Asset, &AssetFileStream, GameAssets->TransientArena);
+            }
+            break;
+            case ASSET_TYPE_FONT:
+            {
+                Asset_ReadFontFromStream(Asset, &AssetFileStream, GameAssets->TransientArena);
+            }
+            break;
+            case ASSET_TYPE_SPRITE_ATLAS:
+            {
+                Asset_ReadSpriteAtlasFromStream(Asset, &AssetFileStream, GameAssets->TransientArena);
+            }
+            break;
+            case ASSET_TYPE_ATLAS_TEXTURE:
+            {
+                Asset_ReadAtlasTextureFromStream(Asset, &AssetFileStream, GameAssets->TransientArena,
+                                                 &SpriteAtlasAsset->SpriteAtlas);
+            }
+            break;
+        }
+
+        if (AssetFileStream.ByteOffset != AssetFileStream.ByteCount)
+        {
+            PANIC("Loading an asset from the asset file didn't consume the entire memory block!");
+        }
+    }
+
+    Asset_UnlockLoading(GameAssets);
+
+    // NOTE(Traian): The store has release semantics, so the loaded data is visible to any thread that observes the
+    // asset as being ready. The threads that are blocked in 'Asset_LoadSync' waiting for this load are woken up.
+    Platform_AtomicStore32(&Asset->State, ASSET_STATE_READY);
+    Platform_WakeAllOnAddress32(&Asset->State);
+}
+
+internal void
+Asset_LoadTask(s32 LogicalThreadIndex, void* UserData)
+{
+    asset_load_task* LoadTask = (asset_load_task*)UserData;
+    asset* Asset = &LoadTask->GameAssets->Assets[LoadTask->AssetID];
+
+    // NOTE(Traian): The load might have been claimed by a synchronous load in the meantime, in which case there is
+    // nothing left to do.
+    if (Platform_AtomicCompareExchange32(&Asset->State, ASSET_STATE_LOADING, ASSET_STATE_QUEUED) == ASSET_STATE_QUEUED)
+    {
+        Asset_LoadClaimed(LoadTask->GameAssets, Asset);
+    }
+}
+
 function asset_state
 Asset_GetState(game_assets* GameAssets, game_asset_id AssetID)
 {
     ASSERT(AssetID != GAME_ASSET_ID_NONE);
     ASSERT(AssetID < GAME_ASSET_ID_MAX_COUNT);
     asset* Asset = &GameAssets->Assets[AssetID];
-    const asset_state State = Asset->State;
+    const asset_state State = (asset_state)Platform_AtomicLoad32(&Asset->State);
     return State; 
 }
 
+function b8
+Asset_IsPresent(game_assets* GameAssets, game_asset_id AssetID)
+{
+    ASSERT(AssetID != GAME_ASSET_ID_NONE);
+    ASSERT(AssetID < GAME_ASSET_ID_MAX_COUNT);
+    const b8 Result = (GameAssets->Assets[AssetID].Type != ASSET_TYPE_UNKNOWN);
+    return Result;
+}
+
+function s32
+Asset_GetFontKerning(const asset_font* Font, u32 FirstGlyphIndex, u32 SecondGlyphIndex)
+{
+    ASSERT(FirstGlyphIndex < Font->GlyphCount);
+
+    // NOTE(Traian): Binary search among the pairs of the first glyph, which are sorted by the second glyph.
+    u32 LowIndex = Font->KerningPairOffsets[FirstGlyphIndex];
+    u32 HighIndex = Font->KerningPairOffsets[FirstGlyphIndex + 1];
+    while (LowIndex < HighIndex)
+    {
+        const u32 MiddleIndex = LowIndex + ((HighIndex - LowIndex) / 2);
+        const asset_font_kerning_pair* KerningPair = Font->KerningPairs + MiddleIndex;
+        if (KerningPair->SecondGlyphIndex == SecondGlyphIndex)
+        {
+            return KerningPair->Advance;
+        }
+        else if (KerningPair->SecondGlyphIndex < SecondGlyphIndex)
+        {
+            LowIndex = MiddleIndex + 1;
+        }
+        else
+        {
+            HighIndex = MiddleIndex;
+        }
+    }
+    return 0;
+}
+
 function asset*
 Asset_Get(game_assets* GameAssets, game_asset_id AssetID)
 {
@@ -177,66 +759,54 @@ Asset_Get(game_assets* GameAssets, game_asset_id AssetID)
     return Asset;
 }
 
+function asset*
+Asset_GetIfReady(game_assets* GameAssets, game_asset_id AssetID)
+{
+    if (Asset_GetState(GameAssets, AssetID) == ASSET_STATE_READY)
+    {
+        asset* Asset = &GameAssets->Assets[AssetID];
+        return Asset;
+    }
+    else
+    {
+        Asset_LoadAsync(GameAssets, AssetID, GameAssets->TaskQueue);
+        return NULL;
+    }
+}
+
 function asset_state
 Asset_LoadSync(game_assets* GameAssets, game_asset_id AssetID)
 {
     ASSERT(AssetID != GAME_ASSET_ID_NONE);
     ASSERT(AssetID < GAME_ASSET_ID_MAX_COUNT);
     asset* Asset = &GameAssets->Assets[AssetID];
-    const asset_state InitialAssetState = Asset->State;
+    const asset_state InitialAssetState = (asset_state)Platform_AtomicLoad32(&Asset->State);
 
     if (Asset->Type == ASSET_TYPE_UNKNOWN)
     {
         PANIC("Trying to load an asset that is not present in the asset pack!");
     }
 
-    if (Asset->State == ASSET_STATE_UNLOADED)
+    if (Asset->Type == ASSET_TYPE_ATLAS_TEXTURE)
     {
-        //
-        // NOTE(Traian): Load the asset from the asset file.
-        //
-
-        Asset->State = ASSET_STATE_LOADING;
-        platform_read_file_result ReadAssetFileResult = Platform_ReadFromFile(GameAssets->AssetFileHandle,
-                                                                              Asset->AssetFileByteOffset,
-                                                                              Asset->AssetFileByteCount,
-                                                                              GameAssets->TransientArena);
-        if (ReadAssetFileResult.IsValid)
-        {
-            // NOTE(Traian): Emulate a single asset file stream that contains the entire asset file data at once.
-            // This ensures that writing and reading from the asset file are equivalent from an alignment perspective.
-            memory_stream AssetFileStream = {};
-            AssetFileStream.MemoryBlock = (u8*)ReadAssetFileResult.ReadData - Asset->AssetFileByteOffset;
-            AssetFileStream.ByteCount = Asset->AssetFileByteOffset + ReadAssetFileResult.ReadByteCount;
-            AssetFileStream.ByteOffset = Asset->AssetFileByteOffset;
-
-            switch (Asset->Type)
-            {
-                case ASSET_TYPE_TEXTURE:
-                {
-                    Asset_ReadTextureFromStream(Asset, &AssetFileStream, GameAssets->TransientArena);
-                }
-                break;
-                case ASSET_TYPE_FONT:
-                {
-                    Asset_ReadFontFromStream(Asset, &AssetFileStream, GameAssets->TransientArena);
-                }
-                break;
-            }
-
-            if (AssetFileStream.ByteOffset != AssetFileStream.ByteCount)
-            {
-                PANIC("Loading an asset from the asset file didn't consume the entire memory block!");
-            }
-        }
+        Asset_LoadSync(GameAssets, GAME_ASSET_ID_SPRITE_ATLAS);
+    }
 
-        Asset->State = ASSET_STATE_READY;
+    if (Asset_TryClaimLoad(Asset))
+    {
+        Asset_LoadClaimed(GameAssets, Asset);
     }
-    else if (Asset->State == ASSET_STATE_LOADING)
+    else
     {
-        // NOTE(Traian): Wait until the asset is marked as ready by the thread that currently loads it.
-        // Unfortunately, without more complex synchronization mechanisms this thread will have to busy-wait.
-        while (Asset->State != ASSET_STATE_READY) {}
+        // NOTE(Traian): Either the asset is already ready, or another thread is executing its load right now (queued
+        // loads are always claimed above). In the latter case, block until the loading thread wakes this one up, as
+        // the load might take a while (when the asset is decompressed, for example).
+        asset_state State = (asset_state)Platform_AtomicLoad32(&Asset->State);
+        while (State != ASSET_STATE_READY)
+        {
+            Platform_WaitOnAddress32(&Asset->State, State);
+            State = (asset_state)Platform_AtomicLoad32(&Asset->State);
+        }
     }
 
     return InitialAssetState;
@@ -245,5 +815,38 @@ Asset_LoadSync(game_assets* GameAssets, game_asset_id AssetID)
 function asset_state
 Asset_LoadAsync(game_assets* GameAssets, game_asset_id AssetID, platform_task_queue* TaskQueue)
 {
-    return ASSET_STATE_UNLOADED;
+    ASSERT(AssetID != GAME_ASSET_ID_NONE);
+    ASSERT(AssetID < GAME_ASSET_ID_MAX_COUNT);
+    asset* Asset = &GameAssets->Assets[AssetID];
+
+    if (Asset->Type == ASSET_TYPE_UNKNOWN)
+    {
+        PANIC("Trying to load an asset that is not present in the asset pack!");
+    }
+
+    // NOTE(Traian): Atlas textures are only queued once the sprite atlas is ready. Until then the atlas is queued
+    // instead, and the texture stays unloaded, so that a later request (the next frame asking for it again) queues it.
+    // This way the load task of an atlas texture never has to wait for the atlas to be loaded by another task.
+    if (Asset->Type == ASSET_TYPE_ATLAS_TEXTURE &&
+        Asset_GetState(GameAssets, GAME_ASSET_ID_SPRITE_ATLAS) != ASSET_STATE_READY)
+    {
+        Asset_LoadAsync(GameAssets, GAME_ASSET_ID_SPRITE_ATLAS, TaskQueue);
+        const asset_state Result = (asset_state)Platform_AtomicLoad32(&Asset->State);
+        return Result;
+    }
+
+    // NOTE(Traian): Only the thread that moves the asset out of the unloaded state pushes the load task, so each asset
+    // is queued at most once. The task storage is owned by the asset system, so it outlives the task.
+    const asset_state InitialAssetState = (asset_state)Platform_AtomicCompareExchange32(&Asset->State,
+                                                                                         ASSET_STATE_QUEUED,
+                                                                                         ASSET_STATE_UNLOADED);
+    if (InitialAssetState == ASSET_STATE_UNLOADED)
+    {
+        asset_load_task* LoadTask = &GameAssets->LoadTasks[AssetID];
+        LoadTask->GameAssets = GameAssets;
+        LoadTask->AssetID = AssetID;
+        PlatformTaskQueue_Push(TaskQueue, Asset_LoadTask, LoadTask);
+    }
+
+    return InitialAssetState;
 }
@@ -16,12 +16,22 @@ enum asset_type : u8
     ASSET_TYPE_UNKNOWN = 0,
     ASSET_TYPE_TEXTURE,
     ASSET_TYPE_FONT,
+    ASSET_TYPE_SPRITE_ATLAS,
+    // NOTE(Traian): A texture whose pixels are stored in a page of the sprite atlas. Once loaded, it is an
+    // 'asset_texture' just like the regular textures.
+    ASSET_TYPE_ATLAS_TEXTURE,
     ASSET_TYPE_MAX_COUNT,
 };
 
+//
+// NOTE(Traian): An asset is 'queued' after an asynchronous load was requested, but before a thread actually started
+// loading it. A queued load can still be claimed by a synchronous load (which then performs it on the calling thread),
+// so waiting for an asset never depends on a task that might be sitting in the queue of the waiting thread.
+//
 enum asset_state : u8
 {
     ASSET_STATE_UNLOADED = 0,
+    ASSET_STATE_QUEUED,
     ASSET_STATE_LOADING,
     ASSET_STATE_READY,
 };
@@ -31,6 +41,20 @@ struct asset_texture
     renderer_texture RendererTexture;
 };
 
+//
+// NOTE(Traian): The sprites are packed by the asset packer into a few large pages, so the sprites drawn in a frame
+// share their memory (and cache lines) instead of being scattered across many small textures. Each page has its own
+// (padded) mip chain, built from the mips of the sprites it contains. The mips of an atlas texture are views into
+// the mips of its page, which use the stride of the page.
+//
+struct asset_sprite_atlas
+{
+    u32                 PageCount;
+    u32                 MipCount;
+    // NOTE(Traian): 'MipCount' mips for each page, one page after another.
+    renderer_image*     PageMips;
+};
+
 struct asset_font_glyph
 {
     u32                 Codepoint;
@@ -38,30 +62,65 @@ struct asset_font_glyph
     s32                 LeftSideBearing;
     s32                 TextureOffsetX;
     s32                 TextureOffsetY;
-    renderer_texture    RendererTexture;
+    // NOTE(Traian): The size (in texels) of the glyph and the rectangle it occupies in the font atlas texture.
+    u32                 SizeX;
+    u32                 SizeY;
+    vec2                AtlasMinUV;
+    vec2                AtlasMaxUV;
+};
+
+// NOTE(Traian): Stored in the codepoint to glyph index table for the codepoints that don't have a glyph.
+#define ASSET_FONT_INVALID_GLYPH_INDEX (0xFFFFFFFF)
+
+struct asset_font_kerning_pair
+{
+    u32 SecondGlyphIndex;
+    s32 Advance;
 };
 
 struct asset_font
 {
-    f32                 Height;
-    s32                 Ascent;
-    s32                 Descent;
-    s32                 LineGap;
-    u32                 GlyphCount;
-    asset_font_glyph*   Glyphs;
-    s32*                KerningTable;
+    f32                         Height;
+    s32                         Ascent;
+    s32                         Descent;
+    s32                         LineGap;
+    u32                         GlyphCount;
+    asset_font_glyph*           Glyphs;
+    // NOTE(Traian): Only the glyph pairs with a non-zero kerning advance are stored. The pairs that start with the
+    // glyph 'I' are in the ['KerningPairOffsets[I]', 'KerningPairOffsets[I + 1]') range, sorted by the second glyph.
+    u32*                        KerningPairOffsets;
+    u32                         KerningPairCount;
+    asset_font_kerning_pair*    KerningPairs;
+    // NOTE(Traian): Maps each codepoint in the ['FirstCodepoint', 'FirstCodepoint' + 'CodepointCount') range directly
+    // to the index of its glyph (or to 'ASSET_FONT_INVALID_GLYPH_INDEX').
+    u32                         FirstCodepoint;
+    u32                         CodepointCount;
+    u32*                        GlyphIndices;
+    // NOTE(Traian): All glyphs are packed into a single texture, so the glyphs of a text share their cache lines.
+    renderer_texture            AtlasTexture;
+};
+
+enum asset_compression : u8
+{
+    ASSET_COMPRESSION_NONE = 0,
+    ASSET_COMPRESSION_LZ4,
 };
 
 struct asset
 {
     asset_type          Type;
-    asset_state         State;
+    // NOTE(Traian): Stores an 'asset_state' value. It is accessed only through atomic operations, as the asset can be
+    // loaded by any thread. The loaded data is visible to all threads once the state has become 'ASSET_STATE_READY'.
+    volatile u32        State;
+    asset_compression   Compression;
     memory_size         AssetFileByteOffset;
     memory_size         AssetFileByteCount;
+    memory_size         AssetFileUncompressedByteCount;
     union
     {
-        asset_texture   Texture;
-        asset_font      Font;
+        asset_texture       Texture;
+        asset_font          Font;
+        asset_sprite_atlas  SpriteAtlas;
     };
 };
 
@@ -80,10 +139,40 @@ struct asset_pack_header
 
 struct asset_pack_entry_header
 {
-    u32         AssetID;
-    asset_type  Type;
-    memory_size ByteOffset;
-    memory_size ByteCount;
+    u32                 AssetID;
+    asset_type          Type;
+    asset_compression   Compression;
+    memory_size         ByteOffset;
+    // NOTE(Traian): The number of bytes the entry occupies in the asset file. For uncompressed entries it is always
+    // equal to the uncompressed byte count.
+    memory_size         ByteCount;
+    memory_size         UncompressedByteCount;
+};
+
+//
+// NOTE(Traian): A compressed entry starts with a table of 'asset_compressed_chunk', followed by the compressed data of
+// each chunk. Every chunk (except the last one) decompresses to exactly 'ASSET_COMPRESSION_CHUNK_BYTE_COUNT' bytes and
+// is compressed independently, so the chunks of an entry can be decompressed in parallel.
+// The uncompressed data has exactly the same layout as the entry would have if it wasn't compressed at all.
+//
+#define ASSET_COMPRESSION_CHUNK_BYTE_COUNT KILOBYTES(128)
+
+struct asset_compressed_chunk
+{
+    // NOTE(Traian): Relative to the byte offset of the entry.
+    u32 ByteOffset;
+    u32 ByteCount;
+};
+
+enum asset_texture_flags : u32
+{
+    ASSET_TEXTURE_FLAG_NONE                 = 0,
+    // NOTE(Traian): The color channels of the pixels are already multiplied by the alpha channel.
+    ASSET_TEXTURE_FLAG_PREMULTIPLIED_ALPHA  = (1 << 0),
+    // NOTE(Traian): The alpha channel of every pixel is 255.
+    ASSET_TEXTURE_FLAG_OPAQUE               = (1 << 1),
+    // NOTE(Traian): The mips are stored in the tiled layout ('RENDERER_IMAGE_LAYOUT_TILED').
+    ASSET_TEXTURE_FLAG_TILED                = (1 << 2),
 };
 
 struct asset_header_texture
@@ -91,8 +180,53 @@ struct asset_header_texture
     u32         SizeX;
     u32         SizeY;
     memory_size BytesPerPixel;
+    u32         Flags;
+    // NOTE(Traian): The pixels of all mips are stored after the header, starting with the full resolution mip. The
+    // size of each mip is half (rounded down) the size of the previous one. Each mip is padded with a one pixel border
+    // (see 'renderer_image::IsPadded'), extended to whole tiles when the mips are tiled. The pixels are followed by the row spans ('renderer_image_row_span') of all
+    // mips, in the same order.
+    u32         MipCount;
+};
+
+//
+// NOTE(Traian): The atlas header is followed by the page headers and then by the pixels of each page: all of its mips,
+// each one padded with a one pixel border, starting with the full resolution one. Pages always use the linear layout,
+// so that the atlas textures can reference their rectangles directly.
+//
+struct asset_header_sprite_atlas
+{
+    u32 PageCount;
+    u32 MipCount;
+};
+
+struct asset_sprite_atlas_page_header
+{
+    u32 SizeX;
+    u32 SizeY;
+};
+
+//
+// NOTE(Traian): The rectangle occupied by the full resolution mip in its page. The rectangle of each following mip
+// starts at half the offset and has half the size (both rounded down) of the previous one. Every rectangle is followed
+// (to the right and above) by at least two texels that replicate its edges, which act as the border of the mip. The
+// header is followed by the row spans of all mips, just like for regular textures.
+//
+struct asset_header_atlas_texture
+{
+    u32 PageIndex;
+    u32 OffsetX;
+    u32 OffsetY;
+    u32 SizeX;
+    u32 SizeY;
+    u32 Flags;
+    u32 MipCount;
 };
 
+//
+// NOTE(Traian): The font header is followed by the glyph headers, the codepoint to glyph index table, the pixels of all
+// mips of the (A8) atlas texture (padded, just like the mips of regular textures) and, finally, the kerning pair
+// offsets (one per glyph, plus one) and the kerning pairs.
+//
 struct asset_header_font
 {
     f32 Height;
@@ -100,6 +234,12 @@ struct asset_header_font
     s32 Descent;
     s32 LineGap;
     u32 GlyphCount;
+    u32 FirstCodepoint;
+    u32 CodepointCount;
+    u32 AtlasSizeX;
+    u32 AtlasSizeY;
+    u32 AtlasMipCount;
+    u32 KerningPairCount;
 };
 
 struct asset_font_glyph_header
@@ -109,8 +249,10 @@ struct asset_font_glyph_header
     s32 LeftSideBearing;
     s32 TextureOffsetX;
     s32 TextureOffsetY;
-    u32 TextureSizeX;
-    u32 TextureSizeY;
+    u32 AtlasOffsetX;
+    u32 AtlasOffsetY;
+    u32 SizeX;
+    u32 SizeY;
 };
 
 //====================================================================================================================//
@@ -120,6 +262,7 @@ struct asset_font_glyph_header
 enum game_asset_id : u32
 {
     GAME_ASSET_ID_NONE = 0,
+    GAME_ASSET_ID_SPRITE_ATLAS,
     GAME_ASSET_ID_FONT_COMIC_SANS,
     GAME_ASSET_ID_PLANT_SUNFLOWER,
     GAME_ASSET_ID_PLANT_PEASHOOTER,
@@ -142,20 +285,47 @@ enum game_asset_id : u32
     GAME_ASSET_ID_MAX_COUNT,
 };
 
+struct asset_load_task
+{
+    struct game_assets*     GameAssets;
+    game_asset_id           AssetID;
+};
+
 struct game_assets
 {
     asset                   Assets[GAME_ASSET_ID_MAX_COUNT];
+    asset_load_task         LoadTasks[GAME_ASSET_ID_MAX_COUNT];
+    platform_task_queue*    TaskQueue;
+    // NOTE(Traian): Loading an asset allocates from the transient arena, which is not thread-safe. The lock serializes
+    // the loads, which is cheap as loading an asset from the mapped asset file only decodes its headers. Compressed
+    // assets are decompressed without holding the lock.
+    volatile u32            LoadLock;
     memory_arena*           TransientArena;
     platform_file_handle    AssetFileHandle;
+    // NOTE(Traian): When the asset file could be mapped into memory, the assets are resolved directly from the mapped
+    // bytes (without being read or copied). Otherwise, they are read from the file into the transient arena.
+    void*                   MappedAssetFile;
+    memory_size             MappedAssetFileByteCount;
 };
 
 function void           Asset_Initialize    (game_assets* GameAssets, memory_arena* TransientArena,
-                                             platform_file_handle AssetFileHandle);
+                                             platform_file_handle AssetFileHandle, platform_task_queue* TaskQueue);
 
 function asset_state    Asset_GetState      (game_assets* GameAssets, game_asset_id AssetID);
 
+// NOTE(Traian): Returns whether the asset file contains the asset at all.
+function b8             Asset_IsPresent     (game_assets* GameAssets, game_asset_id AssetID);
+
+// NOTE(Traian): Returns the kerning advance (in pixels) between two glyphs of the font, or zero if the pair has none.
+function s32            Asset_GetFontKerning(const asset_font* Font, u32 FirstGlyphIndex, u32 SecondGlyphIndex);
+
+// NOTE(Traian): Returns the asset, loading it on the calling thread first if required.
 function asset*         Asset_Get           (game_assets* GameAssets, game_asset_id AssetID);
 
+// NOTE(Traian): Never blocks. Returns the asset if it is ready, otherwise requests it to be loaded asynchronously and
+// returns NULL, in which case the caller should skip drawing it (or draw a placeholder) for the current frame.
+function asset*         Asset_GetIfReady    (game_assets* GameAssets, game_asset_id AssetID);
+
 function asset_state    Asset_LoadSync      (game_assets* GameAssets, game_asset_id AssetID);
 
 function asset_state    Asset_LoadAsync     (game_assets* GameAssets, game_asset_id AssetID,
@@ -51,18 +51,17 @@ GameDraw_Rectangle(game_state* GameState, vec2 MinPoint, vec2 MaxPoint, f32 Bord
 //------------------------------------------------------- TEXT -------------------------------------------------------//
 //====================================================================================================================//
 
-internal u32
+internal inline u32
 GameDraw_GetFontGlyphIndex(const asset_font* Font, u32 Codepoint)
 {
-    u32 GlyphIndex;
-    for (GlyphIndex = 0; GlyphIndex < Font->GlyphCount; ++GlyphIndex)
+    // NOTE(Traian): Codepoints outside of the range covered by the font wrap around to a large offset, so a single
+    // comparison rejects them. Returns a value greater than or equal to the glyph count if there is no such glyph.
+    const u32 CodepointOffset = Codepoint - Font->FirstCodepoint;
+    if (CodepointOffset < Font->CodepointCount)
     {
-        if (Font->Glyphs[GlyphIndex].Codepoint == Codepoint)
-        {
-            break;
-        }
+        return Font->GlyphIndices[CodepointOffset];
     }
-    return GlyphIndex;
+    return ASSET_FONT_INVALID_GLYPH_INDEX;
 }
 
 internal rect2D
@@ -83,17 +82,24 @@ GameDraw_GetTextBoundingBox(const game_camera* Camera, const asset* FontAsset,
     // NOTE(Traian): Descent has a negative value.
     CursorY -= Scale * FontAsset->Font.Descent;
 
+    // NOTE(Traian): The glyph index of the next character is required for kerning, so it is looked up only once and
+    // carried over to the next iteration.
+    u32 NextGlyphIndex = (CharacterCount > 0) ? GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[0]) : 0;
     for (u32 CharacterIndex = 0; CharacterIndex < CharacterCount; ++CharacterIndex)
     {
-        const u32 GlyphIndex = GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[CharacterIndex]);
+        const u32 GlyphIndex = NextGlyphIndex;
+        NextGlyphIndex = ((CharacterIndex + 1) < CharacterCount)
+                             ? GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[CharacterIndex + 1])
+                             : ASSET_FONT_INVALID_GLYPH_INDEX;
+
         if (GlyphIndex < FontAsset->Font.GlyphCount)
         {
             const asset_font_glyph* Glyph = FontAsset->Font.Glyphs + GlyphIndex;
 
             const s32 GlyphMinX = CursorX + Scale * Glyph->TextureOffsetX;
             const s32 GlyphMinY = CursorY + Scale * Glyph->TextureOffsetY;
-            const s32 GlyphMaxX = GlyphMinX + Scale * Glyph->RendererTexture.SizeX;
-            const s32 GlyphMaxY = GlyphMinY + Scale * Glyph->RendererTexture.SizeY;
+            const s32 GlyphMaxX = GlyphMinX + Scale * Glyph->SizeX;
+            const s32 GlyphMaxY = GlyphMinY + Scale * Glyph->SizeY;
 
             BoundingBoxMinX = Min(BoundingBoxMinX, GlyphMinX);
             BoundingBoxMinY = Min(BoundingBoxMinY, GlyphMinY);
@@ -101,14 +107,9 @@ GameDraw_GetTextBoundingBox(const game_camera* Camera, const asset* FontAsset,
             BoundingBoxMaxY = Max(BoundingBoxMaxY, GlyphMaxY);
 
             CursorX += Scale * Glyph->AdvanceWidth;
-            if ((CharacterIndex + 1) < CharacterCount)
+            if (NextGlyphIndex < FontAsset->Font.GlyphCount)
             {
-                const u32 NextGlyphIndex = GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[CharacterIndex + 1]);
-                if (NextGlyphIndex < FontAsset->Font.GlyphCount)
-                {
-                    const u32 KerningIndex = (GlyphIndex * FontAsset->Font.GlyphCount) + NextGlyphIndex;
-                    CursorX += Scale * FontAsset->Font.KerningTable[KerningIndex];
-                }
+                CursorX += Scale * Asset_GetFontKerning(&FontAsset->Font, GlyphIndex, NextGlyphIndex);
             }
         }
     }
@@ -155,35 +156,39 @@ GameDraw_Text(renderer* Renderer, const game_camera* Camera, const asset* FontAs
     // NOTE(Traian): Descent has a negative value.
     CursorY -= Scale * FontAsset->Font.Descent;
 
+    u32 NextGlyphIndex = (CharacterCount > 0) ? GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[0]) : 0;
     for (u32 CharacterIndex = 0; CharacterIndex < CharacterCount; ++CharacterIndex)
     {
-        const u32 GlyphIndex = GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[CharacterIndex]);
+        const u32 GlyphIndex = NextGlyphIndex;
+        NextGlyphIndex = ((CharacterIndex + 1) < CharacterCount)
+                             ? GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[CharacterIndex + 1])
+                             : ASSET_FONT_INVALID_GLYPH_INDEX;
+
         if (GlyphIndex < FontAsset->Font.GlyphCount)
         {
             const asset_font_glyph* Glyph = FontAsset->Font.Glyphs + GlyphIndex;
 
             const s32 GlyphMinX = CursorX + Scale * Glyph->TextureOffsetX;
             const s32 GlyphMinY = CursorY + Scale * Glyph->TextureOffsetY;
-            const s32 GlyphMaxX = GlyphMinX + Scale * Glyph->RendererTexture.SizeX;
-            const s32 GlyphMaxY = GlyphMinY + Scale * Glyph->RendererTexture.SizeY;
+            const s32 GlyphMaxX = GlyphMinX + Scale * Glyph->SizeX;
+            const s32 GlyphMaxY = GlyphMinY + Scale * Glyph->SizeY;
 
-            const f32 NDCGlyphMinX = (f32)GlyphMinX / (f32)Camera->ViewportPixelCountX;
-            const f32 NDCGlyphMinY = (f32)GlyphMinY / (f32)Camera->ViewportPixelCountY;
-            const f32 NDCGlyphMaxX = (f32)GlyphMaxX / (f32)Camera->ViewportPixelCountX;
-            const f32 NDCGlyphMaxY = (f32)GlyphMaxY / (f32)Camera->ViewportPixelCountY;
-            Renderer_PushPrimitive(Renderer, Vec2(NDCGlyphMinX, NDCGlyphMinY), Vec2(NDCGlyphMaxX, NDCGlyphMaxY),
-                                   ZOffset, Color,
-                                   Vec2(0.0F), Vec2(1.0F), &Glyph->RendererTexture);
+            // NOTE(Traian): Glyphs without any pixels (such as the space) only advance the cursor.
+            if (Glyph->SizeX > 0 && Glyph->SizeY > 0)
+            {
+                const f32 NDCGlyphMinX = (f32)GlyphMinX / (f32)Camera->ViewportPixelCountX;
+                const f32 NDCGlyphMinY = (f32)GlyphMinY / (f32)Camera->ViewportPixelCountY;
+                const f32 NDCGlyphMaxX = (f32)GlyphMaxX / (f32)Camera->ViewportPixelCountX;
+                const f32 NDCGlyphMaxY = (f32)GlyphMaxY / (f32)Camera->ViewportPixelCountY;
+                Renderer_PushPrimitive(Renderer, Vec2(NDCGlyphMinX, NDCGlyphMinY), Vec2(NDCGlyphMaxX, NDCGlyphMaxY),
+                                       ZOffset, Color,
+                                       Glyph->AtlasMinUV, Glyph->AtlasMaxUV, &FontAsset->Font.AtlasTexture);
+            }
 
             CursorX += Scale * Glyph->AdvanceWidth;
-            if ((CharacterIndex + 1) < CharacterCount)
+            if (NextGlyphIndex < FontAsset->Font.GlyphCount)
             {
-                const u32 NextGlyphIndex = GameDraw_GetFontGlyphIndex(&FontAsset->Font, Characters[CharacterIndex + 1]);
-                if (NextGlyphIndex < FontAsset->Font.GlyphCount)
-                {
-                    const u32 KerningIndex = (GlyphIndex * FontAsset->Font.GlyphCount) + NextGlyphIndex;
-                    CursorX += Scale * FontAsset->Font.KerningTable[KerningIndex];
-                }
+                CursorX += Scale * Asset_GetFontKerning(&FontAsset->Font, GlyphIndex, NextGlyphIndex);
             }
         }
     }
@@ -1105,7 +1105,7 @@ GameGardenGrid_RenderPlants(game_state* GameState, game_platform_state* Platform
 
                 if (!PlantConfig->UseCustomRenderProcedure)
                 {
-                    asset* TextureAsset = Asset_Get(&GameState->Assets, PlantConfig->AssetID);
+                    asset* TextureAsset = Asset_GetIfReady(&GameState->Assets, PlantConfig->AssetID);
                     if (TextureAsset)
                     {
                         Renderer_PushPrimitive(&GameState->Renderer,
@@ -1131,7 +1131,7 @@ GameGardenGrid_RenderPlants(game_state* GameState, game_platform_state* Platform
                                 case 2: { TextureAssetID = GAME_ASSET_ID_PLANT_WALLNUT_CRACKED_2; } break;
                             }
 
-                            asset* TextureAsset = Asset_Get(&GameState->Assets, TextureAssetID);
+                            asset* TextureAsset = Asset_GetIfReady(&GameState->Assets, TextureAssetID);
                             if (TextureAsset)
                             {
                                 Renderer_PushPrimitive(&GameState->Renderer,
@@ -1182,7 +1182,7 @@ GameGardenGrid_RenderZombies(game_state* GameState, game_platform_state* Platfor
 
                 if (!ZombieConfig->UseCustomRenderProcedure)
                 {
-                    asset* TextureAsset = Asset_Get(&GameState->Assets, ZombieConfig->AssetID);
+                    asset* TextureAsset = Asset_GetIfReady(&GameState->Assets, ZombieConfig->AssetID);
                     if (TextureAsset)
                     {
                         Renderer_PushPrimitive(&GameState->Renderer,
@@ -1208,7 +1208,7 @@ GameGardenGrid_RenderZombies(game_state* GameState, game_platform_state* Platfor
                                 case 3: { BucketTextureAssetID = GAME_ASSET_ID_NONE; }                      break;
                             }
 
-                            asset* ZombieTextureAsset = Asset_Get(&GameState->Assets, ZombieConfig->AssetID);
+                            asset* ZombieTextureAsset = Asset_GetIfReady(&GameState->Assets, ZombieConfig->AssetID);
                             if (ZombieTextureAsset)
                             {
                                 Renderer_PushPrimitive(&GameState->Renderer,
@@ -1221,7 +1221,7 @@ GameGardenGrid_RenderZombies(game_state* GameState, game_platform_state* Platfor
 
                             if (BucketTextureAssetID != GAME_ASSET_ID_NONE)
                             {
-                            asset* BucketTextureAsset = Asset_Get(&GameState->Assets, BucketTextureAssetID);
+                            asset* BucketTextureAsset = Asset_GetIfReady(&GameState->Assets, BucketTextureAssetID);
                                 if (BucketTextureAsset)
                                 {
                                     const vec2 BucketDimensions = Vec2(ZOMBIE_BUCKETHEAD_BUCKET_DIMENSIONS_X,
@@ -1276,7 +1276,7 @@ GameGardenGrid_RenderProjectiles(game_state* GameState, game_platform_state* Pla
                                   Vec2(RenderOffset.X * RenderOffsetScale.X, RenderOffset.Y * RenderOffsetScale.Y);
             const vec2 MaxPoint = MinPoint + RenderDimensions;
 
-            asset* TextureAsset = Asset_Get(&GameState->Assets, ProjectileConfig->AssetID);
+            asset* TextureAsset = Asset_GetIfReady(&GameState->Assets, ProjectileConfig->AssetID);
             if (TextureAsset)
             {
                 Renderer_PushPrimitive(&GameState->Renderer,
@@ -1289,8 +1289,9 @@ GameGardenGrid_RenderProjectiles(game_state* GameState, game_platform_state* Pla
     }
 }
 
+// NOTE(Traian): Renders the content of the garden grid that is cached in the static layer.
 internal void
-GameGardenGrid_Render(game_state* GameState, game_platform_state* PlatformState)
+GameGardenGrid_RenderStatic(game_state* GameState, game_platform_state* PlatformState)
 {
     game_garden_grid* GardenGrid = &GameState->GardenGrid;
     const f32 InvCellCountX = 1.0F / (f32)GardenGrid->CellCountX;
@@ -1324,7 +1325,11 @@ GameGardenGrid_Render(game_state* GameState, game_platform_state* PlatformState)
                                    GARDEN_GRID_GRASS_TILE_GRID_Z_OFFSET, GRASS_CELL_COLOR_TABLE[CellColorIndex]);
         }
     }
+}
 
+internal void
+GameGardenGrid_Render(game_state* GameState, game_platform_state* PlatformState)
+{
     //
     // NOTE(Traian): Render components.
     //
@@ -372,12 +372,15 @@ GamePlantSelector_RenderSeedPacket(game_state* GameState, u32 SeedPacketIndex)
         TintColor = PLANT_SELECTOR_SEED_PACKET_IN_COOLDOWN_TINT_COLOR;
     }
 
-    asset* SeedPacketTexture = Asset_Get(&GameState->Assets, GAME_ASSET_ID_UI_SEED_PACKET);
-    Renderer_PushPrimitive(&GameState->Renderer,
-                           Game_TransformGamePointToNDC(&GameState->Camera, SeedPacketRectangle.Min),
-                           Game_TransformGamePointToNDC(&GameState->Camera, SeedPacketRectangle.Max),
-                           PLANT_SELECTOR_SEED_PACKET_BACKGROUND_OFFSET_Z, TintColor, Vec2(0.0F), Vec2(1.0F),
-                           &SeedPacketTexture->Texture.RendererTexture);
+    asset* SeedPacketTexture = Asset_GetIfReady(&GameState->Assets, GAME_ASSET_ID_UI_SEED_PACKET);
+    if (SeedPacketTexture)
+    {
+        Renderer_PushPrimitive(&GameState->Renderer,
+                               Game_TransformGamePointToNDC(&GameState->Camera, SeedPacketRectangle.Min),
+                               Game_TransformGamePointToNDC(&GameState->Camera, SeedPacketRectangle.Max),
+                               PLANT_SELECTOR_SEED_PACKET_BACKGROUND_OFFSET_Z, TintColor, Vec2(0.0F), Vec2(1.0F),
+                               &SeedPacketTexture->Texture.RendererTexture);
+    }
 
     //
     // NOTE(Traian): Render the seed packet thumbnail.
@@ -394,12 +397,15 @@ GamePlantSelector_RenderSeedPacket(game_state* GameState, u32 SeedPacketIndex)
     const game_asset_id ThumbnailTextureAssetID = GameState->Config.Plants[SeedPacket->PlantType].AssetID;
     if (ThumbnailTextureAssetID != GAME_ASSET_ID_NONE)
     {
-        asset* ThumbnailTextureAsset = Asset_Get(&GameState->Assets, ThumbnailTextureAssetID);
-        Renderer_PushPrimitive(&GameState->Renderer,
-                               Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter - 0.5F * ThumbnailSize),
-                               Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter + 0.5F * ThumbnailSize),
-                               PLANT_SELECTOR_SEED_PACKET_THUMBNAIL_OFFSET_Z, TintColor, Vec2(0.0F), Vec2(1.0F),
-                               &ThumbnailTextureAsset->Texture.RendererTexture);
+        asset* ThumbnailTextureAsset = Asset_GetIfReady(&GameState->Assets, ThumbnailTextureAssetID);
+        if (ThumbnailTextureAsset)
+        {
+            Renderer_PushPrimitive(&GameState->Renderer,
+                                   Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter - 0.5F * ThumbnailSize),
+                                   Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter + 0.5F * ThumbnailSize),
+                                   PLANT_SELECTOR_SEED_PACKET_THUMBNAIL_OFFSET_Z, TintColor, Vec2(0.0F), Vec2(1.0F),
+                                   &ThumbnailTextureAsset->Texture.RendererTexture);
+        }
     }
 
     //
@@ -414,11 +420,14 @@ GamePlantSelector_RenderSeedPacket(game_state* GameState, u32 SeedPacketIndex)
     SunCostCenter.X = Math_Lerp(SeedPacketRectangle.Min.X, SeedPacketRectangle.Max.X, SeedPacket->SunCostCenterPercentage.X);
     SunCostCenter.Y = Math_Lerp(SeedPacketRectangle.Min.Y, SeedPacketRectangle.Max.Y, SeedPacket->SunCostCenterPercentage.Y);
 
-    asset* FontAsset = Asset_Get(&GameState->Assets, GAME_ASSET_ID_FONT_COMIC_SANS);
-    GameDraw_TextCentered(&GameState->Renderer, &GameState->Camera, FontAsset, SunCostCharacters, SunCostCharacterCount,
-                          SunCostCenter, PLANT_SELECTOR_SEED_PACKET_COST_OFFSET_Z,
-                          SeedPacket->SunCostHeightPercentage * PlantSelector->SeedPacketSize.Y,
-                          PLANT_SELECTOR_SEED_PACKET_COST_TEXT_COLOR);
+    asset* FontAsset = Asset_GetIfReady(&GameState->Assets, GAME_ASSET_ID_FONT_COMIC_SANS);
+    if (FontAsset)
+    {
+        GameDraw_TextCentered(&GameState->Renderer, &GameState->Camera, FontAsset, SunCostCharacters, SunCostCharacterCount,
+                              SunCostCenter, PLANT_SELECTOR_SEED_PACKET_COST_OFFSET_Z,
+                              SeedPacket->SunCostHeightPercentage * PlantSelector->SeedPacketSize.Y,
+                              PLANT_SELECTOR_SEED_PACKET_COST_TEXT_COLOR);
+    }
 
     //
     // NOTE(Traian): Render the seed packet cooldown cover.
@@ -464,7 +473,7 @@ GamePlantSelector_RenderPlantPreview(game_state* GameState, vec2 GameMousePositi
         const vec2 PreviewMinPoint = PlantSelector->PlantPreviewCenterPosition - 0.5F * RenderDimensions + RenderOffset;
         const vec2 PreviewMaxPoint = PreviewMinPoint + RenderDimensions;
         
-        asset* PreviewTextureAsset = Asset_Get(&GameState->Assets, PlantConfig->AssetID);
+        asset* PreviewTextureAsset = Asset_GetIfReady(&GameState->Assets, PlantConfig->AssetID);
         if (PreviewTextureAsset)
         {
             Renderer_PushPrimitive(&GameState->Renderer,
@@ -477,8 +486,9 @@ GamePlantSelector_RenderPlantPreview(game_state* GameState, vec2 GameMousePositi
     }
 }
 
+// NOTE(Traian): Renders the content of the plant selector that is cached in the static layer.
 internal void
-GamePlantSelector_Render(game_state* GameState, game_platform_state* PlatformState)
+GamePlantSelector_RenderStatic(game_state* GameState, game_platform_state* PlatformState)
 {
     game_plant_selector* PlantSelector = &GameState->PlantSelector;
 
@@ -493,6 +503,12 @@ GamePlantSelector_Render(game_state* GameState, game_platform_state* PlatformSta
                              PlantSelector->MinPoint + Vec2(PlantSelector->BorderThickness),
                              PlantSelector->MaxPoint - Vec2(PlantSelector->BorderThickness),
                              PLANT_SELECTOR_FRAME_OFFSET_Z, PLANT_SELECTOR_FRAME_BACKGROUND_COLOR);
+}
+
+internal void
+GamePlantSelector_Render(game_state* GameState, game_platform_state* PlatformState)
+{
+    game_plant_selector* PlantSelector = &GameState->PlantSelector;
 
     //
     // NOTE(Traian): Render the plant selector seed packets.
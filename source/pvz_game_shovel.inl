@@ -137,29 +137,36 @@ GameShovel_Update(game_state* GameState, game_platform_state* PlatformState, f32
 //------------------------------------------------------ RENDER ------------------------------------------------------//
 //====================================================================================================================//
 
+internal const f32 SHOVEL_FRAME_OFFSET_Z                 = 1.0F;
+internal const color4 SHOVEL_FRAME_BORDER_COLOR         = Color4_FromLinear(LinearColor(80, 50, 10));
+internal const color4 SHOVEL_FRAME_BACKGROUND_COLOR     = Color4_FromLinear(LinearColor(110, 80, 40));
+
+// NOTE(Traian): Renders the content of the shovel that is cached in the static layer.
 internal void
-GameShovel_Render(game_state* GameState, game_platform_state* PlatformState)
+GameShovel_RenderStatic(game_state* GameState, game_platform_state* PlatformState)
 {
     game_shovel* Shovel = &GameState->Shovel;
 
-    const f32 FRAME_OFFSET_Z            = 1.0F;
-    const f32 THUMBNAIL_OFFSET_Z        = 2.0F;
-    const f32 TOOL_OFFSET_Z             = 10.0F;
-
-    const color4 FRAME_BORDER_COLOR     = Color4_FromLinear(LinearColor(80, 50, 10));
-    const color4 FRAME_BACKGROUND_COLOR = Color4_FromLinear(LinearColor(110, 80, 40));
-
     //
     // NOTE(Traian): Render the shovel frame.
     //
 
     GameDraw_Rectangle(GameState, Shovel->MinPoint, Shovel->MaxPoint, Shovel->BorderThickness,
-                       FRAME_OFFSET_Z, Color4_FromLinear(LinearColor(80, 50, 10)));
+                       SHOVEL_FRAME_OFFSET_Z, SHOVEL_FRAME_BORDER_COLOR);
     
     GameDraw_RectangleFilled(GameState,
                              Shovel->MinPoint + Vec2(Shovel->BorderThickness),
                              Shovel->MaxPoint - Vec2(Shovel->BorderThickness),
-                             FRAME_OFFSET_Z, FRAME_BACKGROUND_COLOR);
+                             SHOVEL_FRAME_OFFSET_Z, SHOVEL_FRAME_BACKGROUND_COLOR);
+}
+
+internal void
+GameShovel_Render(game_state* GameState, game_platform_state* PlatformState)
+{
+    game_shovel* Shovel = &GameState->Shovel;
+
+    const f32 THUMBNAIL_OFFSET_Z        = 2.0F;
+    const f32 TOOL_OFFSET_Z             = 10.0F;
 
     //
     // NOTE(Traian): Render the shovel thumbnail.
@@ -167,12 +174,15 @@ GameShovel_Render(game_state* GameState, game_platform_state* PlatformState)
 
     if (!Shovel->IsSelected)
     {
-        asset* ThumbnailTexture = Asset_Get(&GameState->Assets, GAME_ASSET_ID_UI_SHOVEL);
-        Renderer_PushPrimitive(&GameState->Renderer,
-                               Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ThumbnailCenterPosition - 0.5F * Shovel->ThumbnailDimensions),
-                               Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ThumbnailCenterPosition + 0.5F * Shovel->ThumbnailDimensions),
-                               THUMBNAIL_OFFSET_Z, Color4(1.0F), Vec2(0.0F), Vec2(1.0F),
-                               &ThumbnailTexture->Texture.RendererTexture);
+        asset* ThumbnailTexture = Asset_GetIfReady(&GameState->Assets, GAME_ASSET_ID_UI_SHOVEL);
+        if (ThumbnailTexture)
+        {
+            Renderer_PushPrimitive(&GameState->Renderer,
+                                   Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ThumbnailCenterPosition - 0.5F * Shovel->ThumbnailDimensions),
+                                   Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ThumbnailCenterPosition + 0.5F * Shovel->ThumbnailDimensions),
+                                   THUMBNAIL_OFFSET_Z, Color4(1.0F), Vec2(0.0F), Vec2(1.0F),
+                                   &ThumbnailTexture->Texture.RendererTexture);
+        }
     }
 
     //
@@ -181,11 +191,14 @@ GameShovel_Render(game_state* GameState, game_platform_state* PlatformState)
 
     if (Shovel->IsSelected)
     {
-        asset* ThumbnailTexture = Asset_Get(&GameState->Assets, GAME_ASSET_ID_UI_SHOVEL);
-        Renderer_PushPrimitive(&GameState->Renderer,
-                               Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ToolCenterPosition - 0.5F * Shovel->ThumbnailDimensions),
-                               Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ToolCenterPosition + 0.5F * Shovel->ThumbnailDimensions),
-                               TOOL_OFFSET_Z, Color4(1.0F), Vec2(0.0F), Vec2(1.0F),
-                               &ThumbnailTexture->Texture.RendererTexture);
+        asset* ThumbnailTexture = Asset_GetIfReady(&GameState->Assets, GAME_ASSET_ID_UI_SHOVEL);
+        if (ThumbnailTexture)
+        {
+            Renderer_PushPrimitive(&GameState->Renderer,
+                                   Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ToolCenterPosition - 0.5F * Shovel->ThumbnailDimensions),
+                                   Game_TransformGamePointToNDC(&GameState->Camera, Shovel->ToolCenterPosition + 0.5F * Shovel->ThumbnailDimensions),
+                                   TOOL_OFFSET_Z, Color4(1.0F), Vec2(0.0F), Vec2(1.0F),
+                                   &ThumbnailTexture->Texture.RendererTexture);
+        }
     }
 }
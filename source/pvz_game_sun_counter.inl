@@ -49,33 +49,41 @@ GameSunCounter_Update(game_state* GameState, game_platform_state* PlatformState,
 //------------------------------------------------------ RENDER ------------------------------------------------------//
 //====================================================================================================================//
 
+internal const f32 SUN_COUNTER_FRAME_OFFSET_Z                = 1.0F;
+internal const color4 SUN_COUNTER_FRAME_BORDER_COLOR        = Color4_FromLinear(LinearColor(80, 50, 10));
+internal const color4 SUN_COUNTER_FRAME_BACKGROUND_COLOR    = Color4_FromLinear(LinearColor(110, 80, 40));
+
+// NOTE(Traian): Renders the content of the sun counter that is cached in the static layer.
 internal void
-GameSunCounter_Render(game_state* GameState, game_platform_state* PlatformState)
+GameSunCounter_RenderStatic(game_state* GameState, game_platform_state* PlatformState)
 {
     game_sun_counter* SunCounter = &GameState->SunCounter;
 
-    const f32 FRAME_OFFSET_Z                = 1.0F;
-    const f32 SUN_THUMBNAIL_OFFSET_Z        = 2.0F;
-    const f32 SUN_AMOUNT_SHELF_OFFSET_Z     = 3.0F;
-    const f32 SUN_AMOUNT_TEXT_OFFSET_Z      = 4.0F;
-
-    const color4 FRAME_BORDER_COLOR         = Color4_FromLinear(LinearColor(80, 50, 10));
-    const color4 FRAME_BACKGROUND_COLOR     = Color4_FromLinear(LinearColor(110, 80, 40));
-    const color4 SUN_AMOUNT_SHELF_COLOR     = Color4_FromLinear(LinearColor(210, 230, 190));
-    const color4 SUN_AMOUNT_TEXT_COLOR      = Color4_FromLinear(LinearColor(15, 10, 5));
-
     //
     // NOTE(Traian): Render the sun counter frame.
     //
 
     GameDraw_Rectangle(GameState, SunCounter->MinPoint, SunCounter->MaxPoint, SunCounter->BorderThickness,
-                       FRAME_OFFSET_Z, Color4_FromLinear(LinearColor(80, 50, 10)));
+                       SUN_COUNTER_FRAME_OFFSET_Z, SUN_COUNTER_FRAME_BORDER_COLOR);
     
     GameDraw_RectangleFilled(GameState,
                              SunCounter->MinPoint + Vec2(SunCounter->BorderThickness),
                              SunCounter->MaxPoint - Vec2(SunCounter->BorderThickness),
-                             FRAME_OFFSET_Z, FRAME_BACKGROUND_COLOR);
-    
+                             SUN_COUNTER_FRAME_OFFSET_Z, SUN_COUNTER_FRAME_BACKGROUND_COLOR);
+}
+
+internal void
+GameSunCounter_Render(game_state* GameState, game_platform_state* PlatformState)
+{
+    game_sun_counter* SunCounter = &GameState->SunCounter;
+
+    const f32 SUN_THUMBNAIL_OFFSET_Z        = 2.0F;
+    const f32 SUN_AMOUNT_SHELF_OFFSET_Z     = 3.0F;
+    const f32 SUN_AMOUNT_TEXT_OFFSET_Z      = 4.0F;
+
+    const color4 SUN_AMOUNT_SHELF_COLOR     = Color4_FromLinear(LinearColor(210, 230, 190));
+    const color4 SUN_AMOUNT_TEXT_COLOR      = Color4_FromLinear(LinearColor(15, 10, 5));
+
     //
     // NOTE(Traian): Render the sun thumbnail.
     //
@@ -88,12 +96,15 @@ GameSunCounter_Render(game_state* GameState, game_platform_state* PlatformState)
     ThumbnailSize.X = SunCounter->SunThumbnailSizePercentage.X * (SunCounter->MaxPoint.X - SunCounter->MinPoint.X);
     ThumbnailSize.Y = SunCounter->SunThumbnailSizePercentage.Y * (SunCounter->MaxPoint.Y - SunCounter->MinPoint.Y);
 
-    asset* SunThumbnailTexture = Asset_Get(&GameState->Assets, GAME_ASSET_ID_PROJECTILE_SUN);
-    Renderer_PushPrimitive(&GameState->Renderer,
-                           Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter - 0.5F * ThumbnailSize),
-                           Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter + 0.5F * ThumbnailSize),
-                           SUN_THUMBNAIL_OFFSET_Z, Color4(1.0F), Vec2(0.0F), Vec2(1.0F),
-                           &SunThumbnailTexture->Texture.RendererTexture);
+    asset* SunThumbnailTexture = Asset_GetIfReady(&GameState->Assets, GAME_ASSET_ID_PROJECTILE_SUN);
+    if (SunThumbnailTexture)
+    {
+        Renderer_PushPrimitive(&GameState->Renderer,
+                               Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter - 0.5F * ThumbnailSize),
+                               Game_TransformGamePointToNDC(&GameState->Camera, ThumbnailCenter + 0.5F * ThumbnailSize),
+                               SUN_THUMBNAIL_OFFSET_Z, Color4(1.0F), Vec2(0.0F), Vec2(1.0F),
+                               &SunThumbnailTexture->Texture.RendererTexture);
+    }
     
     //
     // NOTE(Traian): Render the sun amount shelf.
@@ -125,7 +136,10 @@ GameSunCounter_Render(game_state* GameState, game_platform_state* PlatformState)
     SunAmountCenter.X = Math_Lerp(SunCounter->MinPoint.X, SunCounter->MaxPoint.X, SunCounter->SunAmountCenterPercentage.X);
     SunAmountCenter.Y = Math_Lerp(SunCounter->MinPoint.Y, SunCounter->MaxPoint.Y, SunCounter->SunAmountCenterPercentage.Y);
 
-    asset* FontAsset = Asset_Get(&GameState->Assets, GAME_ASSET_ID_FONT_COMIC_SANS);
-    GameDraw_TextCentered(&GameState->Renderer, &GameState->Camera, FontAsset, SunAmountCharacters, SunAmountCharacterCount,
-                          SunAmountCenter, SUN_AMOUNT_TEXT_OFFSET_Z, TextHeight, SUN_AMOUNT_TEXT_COLOR);
+    asset* FontAsset = Asset_GetIfReady(&GameState->Assets, GAME_ASSET_ID_FONT_COMIC_SANS);
+    if (FontAsset)
+    {
+        GameDraw_TextCentered(&GameState->Renderer, &GameState->Camera, FontAsset, SunAmountCharacters, SunAmountCharacterCount,
+                              SunAmountCenter, SUN_AMOUNT_TEXT_OFFSET_Z, TextHeight, SUN_AMOUNT_TEXT_COLOR);
+    }
 }
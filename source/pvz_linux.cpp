@@ -0,0 +1,660 @@
+// Copyright (c) 2025 Traian Avram. All rights reserved.
+// This source file is part of the PvZ-Remake project and is distributed under the MIT license.
+
+#include "pvz_math.h"
+#include "pvz_memory.h"
+#include "pvz_platform.h"
+#include "pvz_renderer.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+//
+// NOTE(Traian): The Linux platform layer is headless - there is no window and no input. The game is updated and
+// rendered into an offscreen image for a fixed number of frames, which makes it suitable for measuring the throughput
+// of the simulation and the renderer (and for capturing frames for regression testing) on machines without a display.
+//
+
+[[noreturn]] function void
+Platform_Panic(const char* Message)
+{
+    fprintf(stderr, "PVZ-Remake has crashed: %s\n", Message);
+    fflush(stderr);
+    abort();
+}
+
+//====================================================================================================================//
+//------------------------------------------------------ ATOMICS -----------------------------------------------------//
+//====================================================================================================================//
+
+function u32
+Platform_AtomicCompareExchange32(volatile u32* Destination, u32 Exchange, u32 Comparand)
+{
+    u32 Expected = Comparand;
+    __atomic_compare_exchange_n(Destination, &Expected, Exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return Expected;
+}
+
+function u32
+Platform_AtomicExchange32(volatile u32* Destination, u32 Value)
+{
+    const u32 Result = __atomic_exchange_n(Destination, Value, __ATOMIC_SEQ_CST);
+    return Result;
+}
+
+function u32
+Platform_AtomicAdd32(volatile u32* Destination, u32 Addend)
+{
+    const u32 Result = __atomic_add_fetch(Destination, Addend, __ATOMIC_SEQ_CST);
+    return Result;
+}
+
+function u32
+Platform_AtomicLoad32(volatile u32* Source)
+{
+    const u32 Result = __atomic_load_n(Source, __ATOMIC_ACQUIRE);
+    return Result;
+}
+
+function void
+Platform_AtomicStore32(volatile u32* Destination, u32 Value)
+{
+    __atomic_store_n(Destination, Value, __ATOMIC_RELEASE);
+}
+
+function u64
+Platform_AtomicCompareExchange64(volatile u64* Destination, u64 Exchange, u64 Comparand)
+{
+    u64 Expected = Comparand;
+    __atomic_compare_exchange_n(Destination, &Expected, Exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return Expected;
+}
+
+function u64
+Platform_AtomicAdd64(volatile u64* Destination, u64 Addend)
+{
+    const u64 Result = __atomic_add_fetch(Destination, Addend, __ATOMIC_SEQ_CST);
+    return Result;
+}
+
+function u64
+Platform_AtomicLoad64(volatile u64* Source)
+{
+    const u64 Result = __atomic_load_n(Source, __ATOMIC_ACQUIRE);
+    return Result;
+}
+
+function void
+Platform_AtomicStore64(volatile u64* Destination, u64 Value)
+{
+    __atomic_store_n(Destination, Value, __ATOMIC_RELEASE);
+}
+
+function void
+Platform_MemoryBarrier()
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+function void
+Platform_SpinPause()
+{
+    __builtin_ia32_pause();
+}
+
+//====================================================================================================================//
+//----------------------------------------------------- THREADING ----------------------------------------------------//
+//====================================================================================================================//
+
+function void
+Platform_WaitOnAddress32(volatile u32* Address, u32 ExpectedValue)
+{
+    // NOTE(Traian): The futex returns immediately if the value has already changed, and might also be interrupted by a
+    // signal. Both cases are covered by the caller checking the value again.
+    syscall(SYS_futex, Address, FUTEX_WAIT_PRIVATE, ExpectedValue, NULL, NULL, 0);
+}
+
+function void
+Platform_WakeOneOnAddress32(volatile u32* Address)
+{
+    syscall(SYS_futex, Address, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+function void
+Platform_WakeAllOnAddress32(volatile u32* Address)
+{
+    syscall(SYS_futex, Address, FUTEX_WAKE_PRIVATE, S32_MAX, NULL, NULL, 0);
+}
+
+internal void*
+Linux_ThreadProcedure(void* OpaqueThread)
+{
+    platform_thread* Thread = (platform_thread*)OpaqueThread;
+    Thread->ThreadFunction(Thread->UserData);
+    return NULL;
+}
+
+function void
+Platform_CreateThread(platform_thread* Thread)
+{
+    pthread_t Handle;
+    pthread_attr_t ThreadAttributes;
+    pthread_attr_init(&ThreadAttributes);
+    pthread_attr_setstacksize(&ThreadAttributes, MEGABYTES(1));
+    pthread_attr_setdetachstate(&ThreadAttributes, PTHREAD_CREATE_DETACHED);
+    const int CreateResult = pthread_create(&Handle, &ThreadAttributes, Linux_ThreadProcedure, Thread);
+    pthread_attr_destroy(&ThreadAttributes);
+
+    if (CreateResult != 0)
+    {
+        PANIC("Failed to create a POSIX thread!");
+    }
+}
+
+function u32
+Platform_GetProcessorCount()
+{
+    const long ProcessorCount = sysconf(_SC_NPROCESSORS_ONLN);
+    const u32 Result = (ProcessorCount > 0) ? (u32)ProcessorCount : 1;
+    return Result;
+}
+
+//====================================================================================================================//
+//----------------------------------------------------- FILE API -----------------------------------------------------//
+//====================================================================================================================//
+
+struct linux_file_descriptor
+{
+    // NOTE(Traian): Zero is a valid POSIX file descriptor, so an explicit flag is required to tell apart a valid
+    // descriptor from a zero-initialized (invalid) file handle.
+    b8                      IsOpen;
+    s32                     FileDescriptor;
+    memory_size             FileSize;
+    platform_file_access    Access;
+};
+static_assert(sizeof(linux_file_descriptor) <= sizeof(platform_file_handle));
+
+internal inline platform_file_handle
+Linux_GetFileHandleFromDescriptor(linux_file_descriptor Descriptor)
+{
+    platform_file_handle Result = {};
+    CopyMemory(&Result, &Descriptor, sizeof(linux_file_descriptor));
+    return Result;
+}
+
+internal inline linux_file_descriptor
+Linux_GetDescriptorFromFileHandle(platform_file_handle FileHandle)
+{
+    linux_file_descriptor Result = {};
+    CopyMemory(&Result, &FileHandle, sizeof(linux_file_descriptor));
+    return Result;
+}
+
+function platform_file_handle
+Platform_OpenFile(const char* FileName, platform_file_access Access, b8 CreateIfMissing, b8 Truncate)
+{
+    int OpenFlags = 0;
+    if (Access == PLATFORM_FILE_ACCESS_READWRITE)   { OpenFlags = O_RDWR; }
+    else if (Access & PLATFORM_FILE_ACCESS_WRITE)   { OpenFlags = O_WRONLY; }
+    else                                            { OpenFlags = O_RDONLY; }
+
+    if (CreateIfMissing)    { OpenFlags |= O_CREAT; }
+    if (Truncate)           { OpenFlags |= O_TRUNC; }
+
+    platform_file_handle ResultHandle = {};
+    const int FileDescriptor = open(FileName, OpenFlags | O_CLOEXEC, 0644);
+    if (FileDescriptor >= 0)
+    {
+        struct stat FileStatus = {};
+        if (fstat(FileDescriptor, &FileStatus) == 0)
+        {
+            linux_file_descriptor Descriptor = {};
+            Descriptor.IsOpen = true;
+            Descriptor.FileDescriptor = FileDescriptor;
+            Descriptor.FileSize = (memory_size)FileStatus.st_size;
+            Descriptor.Access = Access;
+            ResultHandle = Linux_GetFileHandleFromDescriptor(Descriptor);
+        }
+        else
+        {
+            close(FileDescriptor);
+        }
+    }
+
+    return ResultHandle;
+}
+
+function void
+Platform_CloseFile(platform_file_handle FileHandle)
+{
+    linux_file_descriptor Descriptor = Linux_GetDescriptorFromFileHandle(FileHandle);
+    if (Descriptor.IsOpen)
+    {
+        close(Descriptor.FileDescriptor);
+    }
+}
+
+function memory_size
+Platform_GetFileSize(platform_file_handle FileHandle)
+{
+    linux_file_descriptor Descriptor = Linux_GetDescriptorFromFileHandle(FileHandle);
+    const memory_size Result = Descriptor.FileSize;
+    return Result;
+}
+
+function platform_read_file_result
+Platform_ReadEntireFile(platform_file_handle FileHandle, memory_arena* Arena)
+{
+    linux_file_descriptor Descriptor = Linux_GetDescriptorFromFileHandle(FileHandle);
+    const platform_read_file_result Result = Platform_ReadFromFile(FileHandle, 0, Descriptor.FileSize, Arena);
+    return Result;
+}
+
+function platform_read_file_result
+Platform_ReadFromFile(platform_file_handle FileHandle,
+                      memory_size ReadOffset, memory_size ReadByteCount,
+                      memory_arena* Arena)
+{
+    linux_file_descriptor Descriptor = Linux_GetDescriptorFromFileHandle(FileHandle);
+    platform_read_file_result Result = {};
+    Result.IsValid = false;
+
+    if (Descriptor.IsOpen && ReadOffset + ReadByteCount <= Descriptor.FileSize)
+    {
+        // NOTE(Traian): This temporary arena is more used as a marker - if the read operation is successful, then this
+        // temporary arena is never ended. Otherwise, 'MemoryArena_EndTemporary' is called at the end of the function.
+        memory_temporary_arena ReadArena = MemoryArena_BeginTemporary(Arena);
+        u8* ReadData = (u8*)MemoryArena_Allocate(ReadArena.Arena, ReadByteCount, sizeof(void*));
+
+        // NOTE(Traian): A single 'pread' call is allowed to read fewer bytes than requested (and is capped by the
+        // kernel at around 2GB), so keep reading until all of the bytes have been transferred.
+        memory_size RemainingNumberOfBytes = ReadByteCount;
+        while (RemainingNumberOfBytes > 0)
+        {
+            const memory_size ReadPosition = ReadByteCount - RemainingNumberOfBytes;
+            const ssize_t NumberOfBytesRead = pread(Descriptor.FileDescriptor, ReadData + ReadPosition,
+                                                    RemainingNumberOfBytes, (off_t)(ReadOffset + ReadPosition));
+            if (NumberOfBytesRead > 0)
+            {
+                RemainingNumberOfBytes -= (memory_size)NumberOfBytesRead;
+            }
+            else if (NumberOfBytesRead < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        if (RemainingNumberOfBytes == 0)
+        {
+            // NOTE(Traian): If there are no more bytes left to read, the operation is considered successful.
+            Result.IsValid = true;
+            Result.ReadData = ReadData;
+            Result.ReadByteCount = ReadByteCount;
+        }
+        else
+        {
+            // NOTE(Traian): If there are bytes left to read, one of the read operation has failed.
+            MemoryArena_EndTemporary(&ReadArena);
+        }
+    }
+
+    return Result;
+}
+
+function platform_map_file_result
+Platform_MapFile(platform_file_handle FileHandle)
+{
+    linux_file_descriptor Descriptor = Linux_GetDescriptorFromFileHandle(FileHandle);
+    platform_map_file_result Result = {};
+    Result.IsValid = false;
+
+    // NOTE(Traian): Mapping a zero-sized file is not allowed by 'mmap'.
+    if (Descriptor.IsOpen && Descriptor.FileSize > 0)
+    {
+        void* MappedData = mmap(NULL, Descriptor.FileSize, PROT_READ, MAP_SHARED, Descriptor.FileDescriptor, 0);
+        if (MappedData != MAP_FAILED)
+        {
+            Result.IsValid = true;
+            Result.MappedData = MappedData;
+            Result.MappedByteCount = Descriptor.FileSize;
+        }
+    }
+
+    return Result;
+}
+
+function void
+Platform_UnmapFile(void* MappedData, memory_size MappedByteCount)
+{
+    if (MappedData)
+    {
+        munmap(MappedData, MappedByteCount);
+    }
+}
+
+//====================================================================================================================//
+//----------------------------------------------------- GAME LOOP ----------------------------------------------------//
+//====================================================================================================================//
+
+internal u64
+Linux_GetTimeInNanoseconds()
+{
+    struct timespec TimeSpec = {};
+    if (clock_gettime(CLOCK_MONOTONIC, &TimeSpec) == 0)
+    {
+        const u64 Result = ((u64)TimeSpec.tv_sec * 1000000000ull) + (u64)TimeSpec.tv_nsec;
+        return Result;
+    }
+    else
+    {
+        PANIC("Failed to query the monotonic clock!");
+    }
+}
+
+internal b8     RandomSeedIsFixed;
+internal u64    FixedRandomSeed;
+
+function void
+Platform_SeedRandomSeries(random_series* Series)
+{
+    if (RandomSeedIsFixed)
+    {
+        // NOTE(Traian): A fixed seed makes the simulation reproducible from one run to another, which is required
+        // when comparing captured frames.
+        Random_InitializeSeries(Series, FixedRandomSeed, 0);
+    }
+    else
+    {
+        // NOTE(Traian): Use low bits as seed, high bits as sequence for extra entropy.
+        const u64 Counter = Linux_GetTimeInNanoseconds();
+        const u64 Seed = (u64)(Counter >> 0);
+        const u64 Sequence = (u64)(Counter >> 32);
+        Random_InitializeSeries(Series, Seed, Sequence);
+    }
+}
+
+internal void*
+Linux_AllocateVirtualMemory(memory_size ByteCount)
+{
+    // NOTE(Traian): Anonymous mappings are guaranteed to be zero-initialized, the same as 'VirtualAlloc' on Windows.
+    void* MemoryBlock = mmap(NULL, ByteCount, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MemoryBlock == MAP_FAILED)
+    {
+        PANIC("Failed to allocate virtual memory!");
+    }
+    return MemoryBlock;
+}
+
+internal b8
+Linux_WriteImageToPPM(const renderer_image* Image, const char* FileName, u8* RowBuffer)
+{
+    ASSERT(Image->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8);
+
+    // TODO(Traian): Replace the 'fopen' and 'fwrite' calls with a custom file write stream!
+    FILE* File = fopen(FileName, "wb");
+    if (File == NULL)
+    {
+        return false;
+    }
+
+    fprintf(File, "P6\n%u %u\n255\n", Image->SizeX, Image->SizeY);
+
+    // NOTE(Traian): The render target is stored bottom-up (the same layout as a Win32 DIB), while PPM images are
+    // stored top-down, so the rows are written in reverse order. The row buffer must fit three bytes per pixel.
+    b8 Result = true;
+    for (u32 PixelY = 0; Result && PixelY < Image->SizeY; ++PixelY)
+    {
+        const u32* Row = (const u32*)Image_GetPixelAddress(Image, 0, Image->SizeY - PixelY - 1);
+        for (u32 PixelX = 0; PixelX < Image->SizeX; ++PixelX)
+        {
+            const linear_color Color = LinearColor_UnpackFromBGRA(Row[PixelX]);
+            RowBuffer[(3 * PixelX) + 0] = Color.R;
+            RowBuffer[(3 * PixelX) + 1] = Color.G;
+            RowBuffer[(3 * PixelX) + 2] = Color.B;
+        }
+        Result = (fwrite(RowBuffer, 3, Image->SizeX, File) == Image->SizeX);
+    }
+
+    fclose(File);
+    return Result;
+}
+
+struct linux_command_line
+{
+    u32         RenderTargetSizeX;
+    u32         RenderTargetSizeY;
+    u32         FrameCount;
+    f32         FrameDeltaTime;
+    const char* FrameDumpDirectory;
+    u32         FrameDumpInterval;
+    b8          HasFixedRandomSeed;
+    u64         FixedRandomSeed;
+    b8          UseIncrementalRendering;
+    u32         VerifyKernelSpanCount;
+};
+
+internal void
+Linux_PrintUsage(const char* ProgramName)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --resolution <X>x<Y>     Size of the offscreen render target (default: 1280x720).\n"
+            "  --frames <N>             Number of frames to update and render (default: 600).\n"
+            "  --delta-time <S>         Simulated duration of each frame, in seconds (default: 1/60).\n"
+            "  --dump <directory>       Write the rendered frames as PPM images to the given directory.\n"
+            "  --dump-interval <N>      Only dump every N-th frame (default: 1).\n"
+            "  --seed <N>               Seed the random series with a fixed value.\n"
+            "  --incremental <0|1>      Only render again the regions of the frame that changed (default: 0).\n"
+            "  --verify-kernels <N>     Compare the span kernels to the reference ones on N random spans and exit.\n",
+            ProgramName);
+}
+
+internal b8
+Linux_ParseCommandLine(int ArgumentCount, char** Arguments, linux_command_line* CommandLine)
+{
+    ZERO_STRUCT_POINTER(CommandLine);
+    CommandLine->RenderTargetSizeX = 1280;
+    CommandLine->RenderTargetSizeY = 720;
+    CommandLine->FrameCount = 600;
+    CommandLine->FrameDeltaTime = 1.0F / 60.0F;
+    CommandLine->FrameDumpInterval = 1;
+
+    for (int ArgumentIndex = 1; ArgumentIndex < ArgumentCount; ++ArgumentIndex)
+    {
+        const char* Option = Arguments[ArgumentIndex];
+        const char* Value = (ArgumentIndex + 1 < ArgumentCount) ? Arguments[ArgumentIndex + 1] : NULL;
+        if (Value == NULL)
+        {
+            return false;
+        }
+        ++ArgumentIndex;
+
+        if (strcmp(Option, "--resolution") == 0)
+        {
+            if (sscanf(Value, "%ux%u", &CommandLine->RenderTargetSizeX, &CommandLine->RenderTargetSizeY) != 2)
+            {
+                return false;
+            }
+        }
+        else if (strcmp(Option, "--frames") == 0)
+        {
+            CommandLine->FrameCount = (u32)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(Option, "--delta-time") == 0)
+        {
+            CommandLine->FrameDeltaTime = strtof(Value, NULL);
+        }
+        else if (strcmp(Option, "--dump") == 0)
+        {
+            CommandLine->FrameDumpDirectory = Value;
+        }
+        else if (strcmp(Option, "--dump-interval") == 0)
+        {
+            CommandLine->FrameDumpInterval = (u32)strtoul(Value, NULL, 10);
+        }
+        else if (strcmp(Option, "--seed") == 0)
+        {
+            CommandLine->HasFixedRandomSeed = true;
+            CommandLine->FixedRandomSeed = strtoull(Value, NULL, 10);
+        }
+        else if (strcmp(Option, "--incremental") == 0)
+        {
+            CommandLine->UseIncrementalRendering = (strtoul(Value, NULL, 10) != 0);
+        }
+        else if (strcmp(Option, "--verify-kernels") == 0)
+        {
+            CommandLine->VerifyKernelSpanCount = (u32)strtoul(Value, NULL, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    const b8 Result = (CommandLine->RenderTargetSizeX > 0 && CommandLine->RenderTargetSizeY > 0) &&
+                      (CommandLine->FrameDumpInterval > 0) &&
+                      (CommandLine->FrameDeltaTime > 0.0F);
+    return Result;
+}
+
+// NOTE(Traian): Returns the exit code of the process, which is non-zero when the kernels don't match the reference.
+internal int
+Linux_VerifySpanKernels(memory_arena* Arena, u32 SpanCount)
+{
+    random_series Series;
+    Platform_SeedRandomSeries(&Series);
+
+    renderer_span_kernels_report Report;
+    const b8 Passed = Renderer_VerifySpanKernels(&Report, Arena, &Series, SpanCount);
+    printf("Verified %u random spans against %u span kernel tables.\n", Report.SpanCount, Report.KernelTableCount);
+    printf("Max channel difference: fill %u, textured %u (allowed %u), between the fixed-point tables %u.\n",
+           Report.MaxFillDifference, Report.MaxTexturedDifference, RENDERER_MAX_SPAN_KERNEL_DIFFERENCE,
+           Report.MaxFixedTableDifference);
+    printf("%s\n", Passed ? "Passed." : "FAILED!");
+
+    const int Result = Passed ? 0 : 1;
+    return Result;
+}
+
+int
+main(int ArgumentCount, char** Arguments)
+{
+    linux_command_line CommandLine;
+    if (!Linux_ParseCommandLine(ArgumentCount, Arguments, &CommandLine))
+    {
+        Linux_PrintUsage(Arguments[0]);
+        return 1;
+    }
+
+    RandomSeedIsFixed = CommandLine.HasFixedRandomSeed;
+    FixedRandomSeed = CommandLine.FixedRandomSeed;
+
+    // NOTE(Traian): Allocate the game memory.
+    memory_arena PermanentArena = {};
+    PermanentArena.ByteCount = MEGABYTES(32);
+    PermanentArena.MemoryBlock = Linux_AllocateVirtualMemory(PermanentArena.ByteCount);
+    memory_arena TransientArena = {};
+    TransientArena.ByteCount = MEGABYTES(64);
+    TransientArena.MemoryBlock = Linux_AllocateVirtualMemory(TransientArena.ByteCount);
+    platform_game_memory GameMemory = {};
+    GameMemory.PermanentArena = &PermanentArena;
+    GameMemory.TransientArena = &TransientArena;
+
+    if (CommandLine.VerifyKernelSpanCount > 0)
+    {
+        return Linux_VerifySpanKernels(&TransientArena, CommandLine.VerifyKernelSpanCount);
+    }
+
+    // NOTE(Traian): Allocate the offscreen render target.
+    renderer_image RenderTarget = {};
+    RenderTarget.SizeX = CommandLine.RenderTargetSizeX;
+    RenderTarget.SizeY = CommandLine.RenderTargetSizeY;
+    RenderTarget.Stride = CommandLine.RenderTargetSizeX;
+    RenderTarget.Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
+    RenderTarget.PixelBuffer = Linux_AllocateVirtualMemory(Image_GetPixelBufferByteCount(RenderTarget.SizeX,
+                                                                                         RenderTarget.SizeY,
+                                                                                         RenderTarget.Format));
+
+    // NOTE(Traian): Allocate the buffer used to convert the render target rows when dumping frames to disk.
+    u8* FrameDumpRowBuffer = NULL;
+    if (CommandLine.FrameDumpDirectory)
+    {
+        FrameDumpRowBuffer = (u8*)Linux_AllocateVirtualMemory(3 * (memory_size)RenderTarget.SizeX);
+    }
+
+    // NOTE(Traian): Create the platform task queue.
+    platform_task_queue* TaskQueue = PlatformTaskQueue_Create(GameMemory.PermanentArena);
+
+    // NOTE(Traian): Initialize the game layer.
+    game_state* GameState = Game_Initialize(&GameMemory, TaskQueue);
+
+    // NOTE(Traian): The game loads its assets in the background and doesn't draw the ones that aren't ready yet. Wait
+    // for all of them here, so that neither the measured frames nor the dumped ones depend on how fast they loaded.
+    PlatformTaskQueue_WaitForAll(TaskQueue);
+
+    // NOTE(Traian): There is no input device, so the input state stays neutral for the whole run.
+    platform_game_input_state GameInputState = {};
+
+    u64 TotalFrameNanoseconds = 0;
+    u64 MinFrameNanoseconds = U64_MAX;
+    u64 MaxFrameNanoseconds = 0;
+
+    for (u32 FrameIndex = 0; FrameIndex < CommandLine.FrameCount; ++FrameIndex)
+    {
+        // NOTE(Traian): Update and render the game. The frames are simulated with a fixed delta time (instead of the
+        // measured one) so that the simulation doesn't depend on how fast the machine renders.
+        game_platform_state PlatformState = {};
+        PlatformState.Memory = &GameMemory;
+        PlatformState.Input = &GameInputState;
+        PlatformState.TaskQueue = TaskQueue;
+        PlatformState.RenderTarget = &RenderTarget;
+        // NOTE(Traian): The render target is only ever read (when dumping frames), so it keeps its content.
+        PlatformState.UseIncrementalRendering = CommandLine.UseIncrementalRendering;
+
+        const u64 FrameBeginNanoseconds = Linux_GetTimeInNanoseconds();
+        Game_UpdateAndRender(GameState, &PlatformState, CommandLine.FrameDeltaTime);
+        const u64 FrameNanoseconds = Linux_GetTimeInNanoseconds() - FrameBeginNanoseconds;
+
+        TotalFrameNanoseconds += FrameNanoseconds;
+        if (FrameNanoseconds < MinFrameNanoseconds) { MinFrameNanoseconds = FrameNanoseconds; }
+        if (FrameNanoseconds > MaxFrameNanoseconds) { MaxFrameNanoseconds = FrameNanoseconds; }
+
+        // NOTE(Traian): Dump the frame to disk, if requested.
+        if (CommandLine.FrameDumpDirectory && (FrameIndex % CommandLine.FrameDumpInterval) == 0)
+        {
+            char FileName[512] = {};
+            snprintf(FileName, sizeof(FileName), "%s/frame_%05u.ppm", CommandLine.FrameDumpDirectory, FrameIndex);
+            if (!Linux_WriteImageToPPM(&RenderTarget, FileName, FrameDumpRowBuffer))
+            {
+                fprintf(stderr, "Failed to write the frame '%s' to disk!\n", FileName);
+            }
+        }
+    }
+
+    if (CommandLine.FrameCount > 0)
+    {
+        const f64 AverageFrameMilliseconds = ((f64)TotalFrameNanoseconds / (f64)CommandLine.FrameCount) / 1000000.0;
+        printf("Rendered %u frames at %ux%u using %u worker threads.\n",
+               CommandLine.FrameCount, RenderTarget.SizeX, RenderTarget.SizeY,
+               PlatformTaskQueue_GetThreadCount(TaskQueue) - 1);
+        printf("Frame time (ms): average %.3f, min %.3f, max %.3f (%.1f frames per second).\n",
+               AverageFrameMilliseconds,
+               (f64)MinFrameNanoseconds / 1000000.0,
+               (f64)MaxFrameNanoseconds / 1000000.0,
+               1000.0 / AverageFrameMilliseconds);
+    }
+
+    return 0;
+}
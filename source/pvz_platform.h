@@ -13,6 +13,15 @@
     #include <windows.h>
 #endif // PVZ_WINDOWS
 
+#ifdef PVZ_LINUX
+    // NOTE(Traian): The engine uses a few memory and debugging helpers that are provided by 'windows.h'. On Linux,
+    // they are implemented in terms of the C runtime and compiler builtins.
+    #include <string.h>
+    #define ZeroMemory(Destination, Length)             memset((Destination), 0, (Length))
+    #define CopyMemory(Destination, Source, Length)     memcpy((Destination), (Source), (Length))
+    #define __debugbreak()                              __builtin_trap()
+#endif // PVZ_LINUX
+
 // TODO(Traian): Use our custom format function instead of 'snprintf'!
 #include <stdio.h>
 
@@ -38,16 +47,17 @@ using memory_index = u64;
 using memory_size = u64;
 
 #define U32_MAX (0xFFFFFFFF)
+#define U64_MAX (0xFFFFFFFFFFFFFFFF)
 #define S32_MIN (0x80000000)
 #define S32_MAX (0x7FFFFFFF)
 
-#ifdef PVZ_WINDOWS
+#if defined(PVZ_WINDOWS) || defined(PVZ_LINUX)
     #define ASSERT(...)         if (!(__VA_ARGS__)) { __debugbreak(); }
     #define ASSERT_NOT_REACHED  { __debugbreak(); }
 #else
     #define ASSERT(...)
     #define ASSERT_NOT_REACHED
-#endif // PVZ_WINDOWS
+#endif // defined(PVZ_WINDOWS) || defined(PVZ_LINUX)
 
 [[noreturn]] function void Platform_Panic(const char* Message);
 #define PANIC(...) { Platform_Panic(__VA_ARGS__); __debugbreak(); }
@@ -59,10 +69,83 @@ using memory_size = u64;
             snprintf(MessageBuffer, sizeof(MessageBuffer), __VA_ARGS__);    \
             OutputDebugStringA(MessageBuffer);                              \
         }
+#elif defined(PVZ_INTERNAL) && defined(PVZ_LINUX)
+    #define INTERNAL_LOG(...)                                               \
+        {                                                                   \
+            fprintf(stderr, __VA_ARGS__);                                   \
+        }
 #else
     #define INTERNAL_LOG(...)
 #endif // PVZ_INTERNAL
 
+//====================================================================================================================//
+//------------------------------------------------------ ATOMICS -----------------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): All atomic operations act as compiler barriers. The read-modify-write operations are full memory
+// barriers, loads have acquire semantics and stores have release semantics. The compare-exchange and the exchange
+// return the value that the destination held before the operation, while the additions return the resulting value.
+//
+
+function u32    Platform_AtomicCompareExchange32    (volatile u32* Destination, u32 Exchange, u32 Comparand);
+
+function u32    Platform_AtomicExchange32           (volatile u32* Destination, u32 Value);
+
+function u32    Platform_AtomicAdd32                (volatile u32* Destination, u32 Addend);
+
+function u32    Platform_AtomicLoad32               (volatile u32* Source);
+
+function void   Platform_AtomicStore32              (volatile u32* Destination, u32 Value);
+
+function u64    Platform_AtomicCompareExchange64    (volatile u64* Destination, u64 Exchange, u64 Comparand);
+
+function u64    Platform_AtomicAdd64                (volatile u64* Destination, u64 Addend);
+
+function u64    Platform_AtomicLoad64               (volatile u64* Source);
+
+function void   Platform_AtomicStore64              (volatile u64* Destination, u64 Value);
+
+function void   Platform_MemoryBarrier              ();
+
+// NOTE(Traian): Tells the processor that the calling thread is spinning, so that it can yield its resources to the
+// other hardware thread of the core (and save power).
+function void   Platform_SpinPause                  ();
+
+//====================================================================================================================//
+//----------------------------------------------------- THREADING ----------------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): Blocks the calling thread for as long as the value at 'Address' is equal to 'ExpectedValue' (until
+// another thread changes it and wakes the address up). The function can also return spuriously, so the value must
+// always be checked again by the caller. Waking an address never dereferences it, so it is valid to wake an address
+// whose storage might have gone out of scope in the meantime.
+//
+
+function void   Platform_WaitOnAddress32            (volatile u32* Address, u32 ExpectedValue);
+
+function void   Platform_WakeOneOnAddress32         (volatile u32* Address);
+
+function void   Platform_WakeAllOnAddress32         (volatile u32* Address);
+
+using platform_thread_pfn = void(*)(void*);
+
+//
+// NOTE(Traian): The thread description is owned by the caller and must stay alive for as long as the thread runs.
+// Threads are never joined, so the thread function is not expected to return.
+//
+struct platform_thread
+{
+    platform_thread_pfn ThreadFunction;
+    void*               UserData;
+};
+
+function void   Platform_CreateThread               (platform_thread* Thread);
+
+// NOTE(Traian): Returns the number of logical processors available to the process.
+function u32    Platform_GetProcessorCount          ();
+
 //====================================================================================================================//
 //---------------------------------------------------- TASK QUEUE ----------------------------------------------------//
 //====================================================================================================================//
@@ -76,12 +159,49 @@ struct platform_task_queue;
 //
 using platform_task_pfn = void(*)(s32, void*);
 
+//
+// NOTE(Traian): A task group counts the unfinished tasks that were pushed into it, so that a subset of the work in
+// the task queue can be waited on without waiting for everything else. The group is owned by the caller (usually it
+// lives on the stack) and must be zero-initialized before the first push. It has to stay alive until
+// 'PlatformTaskQueue_WaitForGroup' returns.
+//
+struct platform_task_group
+{
+    volatile u32    UnfinishedTaskCount;
+};
+
+//
+// NOTE(Traian): The parameters represent the logical thread index (as for 'platform_task_pfn'), the range of indices
+// to process ['FirstIndex', 'EndIndex') and the user data provided when 'PlatformTaskQueue_ParallelFor' was invoked.
+//
+using platform_parallel_for_pfn = void(*)(s32, u32, u32, void*);
+
+// NOTE(Traian): Creates the task queue and its worker threads. This is called once by the platform layer, and the
+// calling thread becomes the main thread of the task queue.
+function platform_task_queue*           PlatformTaskQueue_Create        (struct memory_arena* Arena);
+
 function void                           PlatformTaskQueue_Push          (platform_task_queue* TaskQueue,
                                                                          platform_task_pfn TaskFunction,
-                                                                         void* UserData);
+                                                                         void* UserData,
+                                                                         platform_task_group* TaskGroup = NULL);
+
+// NOTE(Traian): While waiting, the calling thread only helps with the tasks of the group that it pushed itself. Any
+// other task is left to the worker threads, so waiting for a group never runs unrelated (and possibly long) work.
+function void                           PlatformTaskQueue_WaitForGroup  (platform_task_queue* TaskQueue,
+                                                                         platform_task_group* TaskGroup);
 
 function void                           PlatformTaskQueue_WaitForAll    (platform_task_queue* TaskQueue);
 
+// NOTE(Traian): Returns the number of threads that execute tasks, including the main thread.
+function u32                            PlatformTaskQueue_GetThreadCount(platform_task_queue* TaskQueue);
+
+// NOTE(Traian): Invokes 'Function' over the range [0, 'Count') split into chunks of 'Grain' indices, which are
+// distributed across all threads (including the calling one). Returns after all chunks have been processed.
+function void                           PlatformTaskQueue_ParallelFor   (platform_task_queue* TaskQueue,
+                                                                         u32 Count, u32 Grain,
+                                                                         platform_parallel_for_pfn Function,
+                                                                         void* UserData);
+
 //====================================================================================================================//
 //----------------------------------------------------- FILE API -----------------------------------------------------//
 //====================================================================================================================//
@@ -129,6 +249,20 @@ function platform_read_file_result  Platform_ReadFromFile   (platform_file_handl
                                                              memory_size ReadOffset, memory_size ReadByteCount,
                                                              struct memory_arena* Arena);
 
+struct platform_map_file_result
+{
+    b8          IsValid;
+    void*       MappedData;
+    memory_size MappedByteCount;
+};
+
+// NOTE(Traian): Maps the entire file into the address space of the process, as read-only memory. The mapped pages are
+// backed directly by the OS page cache (and thus shared between all processes that map the same file), and nothing is
+// read from the disk until the pages are first accessed.
+function platform_map_file_result   Platform_MapFile        (platform_file_handle FileHandle);
+
+function void                       Platform_UnmapFile      (void* MappedData, memory_size MappedByteCount);
+
 //====================================================================================================================//
 //----------------------------------------------------- GAME LOOP ----------------------------------------------------//
 //====================================================================================================================//
@@ -173,11 +307,15 @@ struct game_platform_state
     platform_game_input_state*  Input;
     platform_task_queue*        TaskQueue;
     struct renderer_image*      RenderTarget;
+    // NOTE(Traian): Set by the platform layer when the render target keeps its content between frames, in which case
+    // only the regions of the frame that changed are rendered again.
+    b8                          UseIncrementalRendering;
 };
 
 function void                   Platform_SeedRandomSeries   (struct random_series* Series);
 
-function struct game_state*     Game_Initialize             (platform_game_memory* GameMemory);
+function struct game_state*     Game_Initialize             (platform_game_memory* GameMemory,
+                                                             platform_task_queue* TaskQueue);
 
 function void                   Game_UpdateAndRender        (struct game_state* GameState,
                                                              game_platform_state* PlatformState,
@@ -3,6 +3,21 @@
 
 #include "pvz_renderer.h"
 
+#if defined(_M_X64) || defined(__x86_64__)
+    #define PVZ_RENDERER_X64 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        // NOTE(Traian): MSVC allows AVX2 intrinsics in any function, without changing the target architecture.
+        #define PVZ_RENDERER_TARGET_AVX2
+    #else
+        #include <cpuid.h>
+        #define PVZ_RENDERER_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif // defined(_MSC_VER)
+#else
+    #define PVZ_RENDERER_X64 0
+#endif // defined(_M_X64) || defined(__x86_64__)
+
 //====================================================================================================================//
 //------------------------------------------------------- IMAGE ------------------------------------------------------//
 //====================================================================================================================//
@@ -28,6 +43,68 @@ Image_GetPixelBufferByteCount(u32 SizeX, u32 SizeY, renderer_image_format Format
     return Result;
 }
 
+function memory_size
+Image_GetPaddedBufferByteCount(u32 SizeX, u32 SizeY, renderer_image_format Format)
+{
+    const memory_size Result = Image_GetPixelBufferByteCount(SizeX + 1, SizeY + 1, Format);
+    return Result;
+}
+
+function u32
+Image_GetTiledStride(u32 SizeX)
+{
+    // NOTE(Traian): Room for the border pixel, rounded up to a whole number of tiles.
+    const u32 Result = (SizeX + RENDERER_IMAGE_TILE_SIZE) & ~(u32)(RENDERER_IMAGE_TILE_SIZE - 1);
+    return Result;
+}
+
+function memory_size
+Image_GetTiledBufferByteCount(u32 SizeX, u32 SizeY, renderer_image_format Format)
+{
+    const memory_size Result = Image_GetPixelBufferByteCount(Image_GetTiledStride(SizeX), Image_GetTiledStride(SizeY),
+                                                             Format);
+    return Result;
+}
+
+//
+// NOTE(Traian): The index of a pixel is the sum of the offset of its row and the offset of its column. In the tiled
+// layout, the row offset selects the row of tiles and the row inside of the tile, while the column offset selects the
+// tile and the column inside of it ('(X & ~3) * 4 + (X & 3)', which is the same as 'X + 3 * (X & ~3)').
+//
+
+internal inline usize
+Image_GetRowOffset(const renderer_image* Image, u32 PixelIndexY)
+{
+    usize Result;
+    if (Image->Layout == RENDERER_IMAGE_LAYOUT_TILED)
+    {
+        const u32 TileMask = RENDERER_IMAGE_TILE_SIZE - 1;
+        Result = ((usize)(PixelIndexY & ~TileMask) * (usize)Image->Stride) +
+                 ((usize)(PixelIndexY & TileMask) * RENDERER_IMAGE_TILE_SIZE);
+    }
+    else
+    {
+        Result = (usize)PixelIndexY * (usize)Image->Stride;
+    }
+    return Result;
+}
+
+internal inline usize
+Image_GetColumnOffset(const renderer_image* Image, u32 PixelIndexX)
+{
+    usize Result;
+    if (Image->Layout == RENDERER_IMAGE_LAYOUT_TILED)
+    {
+        const u32 TileMask = RENDERER_IMAGE_TILE_SIZE - 1;
+        Result = ((usize)(PixelIndexX & ~TileMask) * RENDERER_IMAGE_TILE_SIZE) + (usize)(PixelIndexX & TileMask);
+    }
+    else
+    {
+        Result = (usize)PixelIndexX;
+    }
+    return Result;
+}
+
 function void
 Image_AllocateFromArena(renderer_image* Image, memory_arena* Arena,
                         renderer_image_format Format, u32 SizeX, u32 SizeY)
@@ -40,14 +117,57 @@ Image_AllocateFromArena(renderer_image* Image, memory_arena* Arena,
     Image->Format = Format;
     Image->SizeX = SizeX;
     Image->SizeY = SizeY;
+    Image->Stride = SizeX;
 
     // NOTE(Traian): Allocate memory for the pixel buffer.
-    const memory_size PixelBufferByteCount = (memory_size)SizeX *
-                                             (memory_size)SizeY *
-                                             Image_GetBytesPerPixelForFormat(Format);
+    const memory_size PixelBufferByteCount = Image_GetPixelBufferByteCount(SizeX, SizeY, Format);
+    Image->PixelBuffer = MemoryArena_Allocate(Arena, PixelBufferByteCount, sizeof(void*));
+}
+
+function void
+Image_AllocatePaddedFromArena(renderer_image* Image, memory_arena* Arena,
+                              renderer_image_format Format, u32 SizeX, u32 SizeY)
+{
+    ASSERT(SizeX > 0 && SizeY > 0);
+    ASSERT(Format != RENDERER_IMAGE_FORMAT_UNKNOWN);
+
+    // NOTE(Traian): Initialize the image fields.
+    ZERO_STRUCT_POINTER(Image);
+    Image->Format = Format;
+    Image->SizeX = SizeX;
+    Image->SizeY = SizeY;
+    Image->Stride = SizeX + 1;
+    Image->IsPadded = true;
+
+    // NOTE(Traian): Allocate memory for the pixel buffer (including the border).
+    const memory_size PixelBufferByteCount = Image_GetPaddedBufferByteCount(SizeX, SizeY, Format);
     Image->PixelBuffer = MemoryArena_Allocate(Arena, PixelBufferByteCount, sizeof(void*));
 }
 
+function void
+Image_ReplicateBorder(renderer_image* Image)
+{
+    ASSERT(Image->IsPadded);
+    ASSERT(Image->Layout == RENDERER_IMAGE_LAYOUT_LINEAR);
+    ASSERT(Image->SizeX > 0 && Image->SizeY > 0);
+
+    const memory_size BytesPerPixel = Image_GetBytesPerPixelForFormat(Image->Format);
+    const memory_size RowByteCount = (memory_size)Image->Stride * BytesPerPixel;
+    u8* RowAddress = (u8*)Image->PixelBuffer;
+
+    // NOTE(Traian): The border pixel of each row is a copy of the last pixel in the row.
+    for (u32 PixelIndexY = 0; PixelIndexY < Image->SizeY; ++PixelIndexY)
+    {
+        CopyMemory(RowAddress + ((memory_size)Image->SizeX * BytesPerPixel),
+                   RowAddress + ((memory_size)(Image->SizeX - 1) * BytesPerPixel),
+                   BytesPerPixel);
+        RowAddress += RowByteCount;
+    }
+
+    // NOTE(Traian): The border row is a copy of the last row (including its border pixel).
+    CopyMemory(RowAddress, RowAddress - RowByteCount, RowByteCount);
+}
+
 function void*
 Image_GetPixelAddress(renderer_image* Image, u32 PixelIndexX, u32 PixelIndexY)
 {
@@ -55,7 +175,7 @@ Image_GetPixelAddress(renderer_image* Image, u32 PixelIndexX, u32 PixelIndexY)
     void* PixelAddress = NULL;
     if (PixelIndexX < Image->SizeX && PixelIndexY < Image->SizeY)
     {
-        const usize PixelIndex = ((usize)PixelIndexY * (usize)Image->SizeX) + (usize)PixelIndexX;
+        const usize PixelIndex = Image_GetRowOffset(Image, PixelIndexY) + Image_GetColumnOffset(Image, PixelIndexX);
         PixelAddress = (u8*)Image->PixelBuffer + (PixelIndex * BytesPerPixel);
     }
     return PixelAddress;
@@ -68,7 +188,7 @@ Image_GetPixelAddress(const renderer_image* Image, u32 PixelIndexX, u32 PixelInd
     const void* PixelAddress = NULL;
     if (PixelIndexX < Image->SizeX && PixelIndexY < Image->SizeY)
     {
-        const usize PixelIndex = ((usize)PixelIndexY * (usize)Image->SizeX) + (usize)PixelIndexX;
+        const usize PixelIndex = Image_GetRowOffset(Image, PixelIndexY) + Image_GetColumnOffset(Image, PixelIndexX);
         PixelAddress = (const u8*)Image->PixelBuffer + (PixelIndex * BytesPerPixel);
     }
     return PixelAddress;
@@ -79,30 +199,27 @@ Image_SampleBilinearA8(const renderer_image* Image, vec2 UV)
 {
     ASSERT(Image->Format == RENDERER_IMAGE_FORMAT_A8);
     ASSERT(Image->SizeX > 0 && Image->SizeY > 0);
+    ASSERT(Image->IsPadded);
     ASSERT(0.0F <= UV.X && UV.X <= 1.0F && 0.0F <= UV.Y && UV.Y <= 1.0F);
 
-    // NOTE(Traian): Bottom-left pixel.
-    const u32 Tex1X = (u32)(UV.X * (f32)Image->SizeX);
-    const u32 Tex1Y = (u32)(UV.Y * (f32)Image->SizeY);
-    // NOTE(Traian): Bottom-right pixel.
-    const u32 Tex2X = Tex1X + 1;
-    const u32 Tex2Y = Tex1Y;
-    // NOTE(Traian): Top-left pixel.
-    const u32 Tex3X = Tex1X;
-    const u32 Tex3Y = Tex1Y + 1;
-    // NOTE(Traian): Top-right pixel.
-    const u32 Tex4X = Tex1X + 1;
-    const u32 Tex4Y = Tex1Y + 1;
-
-    const u8* Pixel1Address = (const u8*)Image_GetPixelAddress(Image, Tex1X, Tex1Y);
-    const u8* Pixel2Address = (const u8*)Image_GetPixelAddress(Image, Tex2X, Tex2Y);
-    const u8* Pixel3Address = (const u8*)Image_GetPixelAddress(Image, Tex3X, Tex3Y);
-    const u8* Pixel4Address = (const u8*)Image_GetPixelAddress(Image, Tex4X, Tex4Y);
-
-    const f32 Sample1 = (1.0F / 255.0F) * (f32)(*(Pixel1Address));
-    const f32 Sample2 = (1.0F / 255.0F) * (f32)(*(Pixel2Address ? Pixel2Address : Pixel1Address));
-    const f32 Sample3 = (1.0F / 255.0F) * (f32)(*(Pixel3Address ? Pixel3Address : Pixel1Address));
-    const f32 Sample4 = (1.0F / 255.0F) * (f32)(*(Pixel4Address ? Pixel4Address : Pixel1Address));
+    // NOTE(Traian): Bottom-left pixel. A coordinate of exactly 1.0 would land one pixel past the edge of the image,
+    // so it is clamped to the last pixel instead.
+    u32 Tex1X = (u32)(UV.X * (f32)Image->SizeX);
+    u32 Tex1Y = (u32)(UV.Y * (f32)Image->SizeY);
+    if (Tex1X >= Image->SizeX) { Tex1X = Image->SizeX - 1; }
+    if (Tex1Y >= Image->SizeY) { Tex1Y = Image->SizeY - 1; }
+
+    // NOTE(Traian): Thanks to the border of the image, the pixels to the right of and above the bottom-left one always
+    // exist (beyond the edges they are copies of the edge pixels).
+    const u8* BottomRow = (const u8*)Image->PixelBuffer + Image_GetRowOffset(Image, Tex1Y);
+    const u8* TopRow = (const u8*)Image->PixelBuffer + Image_GetRowOffset(Image, Tex1Y + 1);
+    const usize LeftColumn = Image_GetColumnOffset(Image, Tex1X);
+    const usize RightColumn = Image_GetColumnOffset(Image, Tex1X + 1);
+
+    const f32 Sample1 = (1.0F / 255.0F) * (f32)BottomRow[LeftColumn];
+    const f32 Sample2 = (1.0F / 255.0F) * (f32)BottomRow[RightColumn];
+    const f32 Sample3 = (1.0F / 255.0F) * (f32)TopRow[LeftColumn];
+    const f32 Sample4 = (1.0F / 255.0F) * (f32)TopRow[RightColumn];
 
     const f32 TX = UV.X - ((f32)Tex1X / (f32)Image->SizeX);
     const f32 TY = UV.Y - ((f32)Tex1Y / (f32)Image->SizeY);
@@ -119,30 +236,27 @@ Image_SampleBilinearB8G8R8A8(const renderer_image* Image, vec2 UV)
 {
     ASSERT(Image->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8);
     ASSERT(Image->SizeX > 0 && Image->SizeY > 0);
+    ASSERT(Image->IsPadded);
     ASSERT(0.0F <= UV.X && UV.X <= 1.0F && 0.0F <= UV.Y && UV.Y <= 1.0F);
 
-    // NOTE(Traian): Bottom-left pixel.
-    const u32 Tex1X = (u32)(UV.X * (f32)Image->SizeX);
-    const u32 Tex1Y = (u32)(UV.Y * (f32)Image->SizeY);
-    // NOTE(Traian): Bottom-right pixel.
-    const u32 Tex2X = Tex1X + 1;
-    const u32 Tex2Y = Tex1Y;
-    // NOTE(Traian): Top-left pixel.
-    const u32 Tex3X = Tex1X;
-    const u32 Tex3Y = Tex1Y + 1;
-    // NOTE(Traian): Top-right pixel.
-    const u32 Tex4X = Tex1X + 1;
-    const u32 Tex4Y = Tex1Y + 1;
-
-    const u32* Pixel1Address = (const u32*)Image_GetPixelAddress(Image, Tex1X, Tex1Y);
-    const u32* Pixel2Address = (const u32*)Image_GetPixelAddress(Image, Tex2X, Tex2Y);
-    const u32* Pixel3Address = (const u32*)Image_GetPixelAddress(Image, Tex3X, Tex3Y);
-    const u32* Pixel4Address = (const u32*)Image_GetPixelAddress(Image, Tex4X, Tex4Y);
-
-    const color4 Sample1 = Color4_FromLinear(LinearColor_UnpackFromBGRA(*Pixel1Address));
-    const color4 Sample2 = Color4_FromLinear(LinearColor_UnpackFromBGRA(Pixel2Address ? *Pixel2Address : *Pixel1Address));
-    const color4 Sample3 = Color4_FromLinear(LinearColor_UnpackFromBGRA(Pixel3Address ? *Pixel3Address : *Pixel1Address));
-    const color4 Sample4 = Color4_FromLinear(LinearColor_UnpackFromBGRA(Pixel4Address ? *Pixel4Address : *Pixel1Address));
+    // NOTE(Traian): Bottom-left pixel. A coordinate of exactly 1.0 would land one pixel past the edge of the image,
+    // so it is clamped to the last pixel instead.
+    u32 Tex1X = (u32)(UV.X * (f32)Image->SizeX);
+    u32 Tex1Y = (u32)(UV.Y * (f32)Image->SizeY);
+    if (Tex1X >= Image->SizeX) { Tex1X = Image->SizeX - 1; }
+    if (Tex1Y >= Image->SizeY) { Tex1Y = Image->SizeY - 1; }
+
+    // NOTE(Traian): Thanks to the border of the image, the pixels to the right of and above the bottom-left one always
+    // exist (beyond the edges they are copies of the edge pixels).
+    const u32* BottomRow = (const u32*)Image->PixelBuffer + Image_GetRowOffset(Image, Tex1Y);
+    const u32* TopRow = (const u32*)Image->PixelBuffer + Image_GetRowOffset(Image, Tex1Y + 1);
+    const usize LeftColumn = Image_GetColumnOffset(Image, Tex1X);
+    const usize RightColumn = Image_GetColumnOffset(Image, Tex1X + 1);
+
+    const color4 Sample1 = Color4_FromLinear(LinearColor_UnpackFromBGRA(BottomRow[LeftColumn]));
+    const color4 Sample2 = Color4_FromLinear(LinearColor_UnpackFromBGRA(BottomRow[RightColumn]));
+    const color4 Sample3 = Color4_FromLinear(LinearColor_UnpackFromBGRA(TopRow[LeftColumn]));
+    const color4 Sample4 = Color4_FromLinear(LinearColor_UnpackFromBGRA(TopRow[RightColumn]));
 
     const f32 TX = UV.X - ((f32)Tex1X / (f32)Image->SizeX);
     const f32 TY = UV.Y - ((f32)Tex1Y / (f32)Image->SizeY);
@@ -166,7 +280,10 @@ Texture_DownsampleByFactorOf2(renderer_image* DstImage, const renderer_image* Sr
     if (DstSizeX > 0 && DstSizeY > 0)
     {
         ZERO_STRUCT_POINTER(DstImage);
-        Image_AllocateFromArena(DstImage, Arena, SrcImage->Format, DstSizeX, DstSizeY);
+        Image_AllocatePaddedFromArena(DstImage, Arena, SrcImage->Format, DstSizeX, DstSizeY);
+        // NOTE(Traian): Averaging premultiplied texels is exactly what a box filter should do, as transparent texels
+        // contribute nothing to the color of the mip (instead of bleeding their, usually black, color into it).
+        DstImage->IsAlphaPremultiplied = SrcImage->IsAlphaPremultiplied;
 
         if (DstImage->Format == RENDERER_IMAGE_FORMAT_A8)
         {
@@ -241,6 +358,7 @@ Texture_DownsampleByFactorOf2(renderer_image* DstImage, const renderer_image* Sr
             PANIC("Invalid texture format passed to 'Texture_DownsampleByFactorOf2'!");
         }
 
+        Image_ReplicateBorder(DstImage);
         return true;
     }
     else
@@ -259,11 +377,34 @@ Texture_Create(renderer_texture* Texture, memory_arena* Arena,
     Texture->SizeX = SourceImage->SizeX;
     Texture->SizeY = SourceImage->SizeY;
     Texture->Format = SourceImage->Format;
+    Texture->IsAlphaPremultiplied = SourceImage->IsAlphaPremultiplied;
     Texture->MaxMipCount = MaxMipCount;
     Texture->Mips = PUSH_ARRAY(Arena, renderer_image, Texture->MaxMipCount);
 
     Texture->MipCount = 1;
-    Texture->Mips[0] = *SourceImage;
+    if (SourceImage->IsPadded)
+    {
+        Texture->Mips[0] = *SourceImage;
+    }
+    else
+    {
+        // NOTE(Traian): Textures can only be sampled when their mips are padded, so the source image is copied into
+        // a padded image first. Only padded images can be tiled, so the source image is linear.
+        ASSERT(SourceImage->Layout == RENDERER_IMAGE_LAYOUT_LINEAR);
+        renderer_image* MipImage = &Texture->Mips[0];
+        Image_AllocatePaddedFromArena(MipImage, Arena, SourceImage->Format, SourceImage->SizeX, SourceImage->SizeY);
+        MipImage->IsAlphaPremultiplied = SourceImage->IsAlphaPremultiplied;
+
+        const memory_size RowByteCount = (memory_size)SourceImage->SizeX *
+                                         Image_GetBytesPerPixelForFormat(SourceImage->Format);
+        for (u32 PixelIndexY = 0; PixelIndexY < SourceImage->SizeY; ++PixelIndexY)
+        {
+            CopyMemory(Image_GetPixelAddress(MipImage, 0, PixelIndexY),
+                       Image_GetPixelAddress(SourceImage, 0, PixelIndexY),
+                       RowByteCount);
+        }
+        Image_ReplicateBorder(MipImage);
+    }
 
     for (u32 MipLevel = 1; MipLevel < Texture->MaxMipCount; ++MipLevel)
     {
@@ -281,333 +422,1708 @@ Texture_Create(renderer_texture* Texture, memory_arena* Arena,
     }
 }
 
-//====================================================================================================================//
-//----------------------------------------------------- RENDERER -----------------------------------------------------//
-//====================================================================================================================//
-
 function void
-Renderer_Initialize(renderer* Renderer, memory_arena* Arena)
+Texture_CreateFromMipChain(renderer_texture* Texture, renderer_image* Mips, u32 MipCount)
 {
-    ZERO_STRUCT_POINTER(Renderer);
-    Renderer->ClusterCount = 12;
-    Renderer->MaxPrimitiveCount = 8129;
-    Renderer->MaxTextureSlotCount = 64;
-
-    Renderer->Clusters      = PUSH_ARRAY(Arena, renderer_cluster,           Renderer->ClusterCount);
-    Renderer->Primitives    = PUSH_ARRAY(Arena, renderer_primitive,         Renderer->MaxPrimitiveCount);
-    Renderer->TextureSlots  = PUSH_ARRAY(Arena, const renderer_texture*,    Renderer->MaxTextureSlotCount);
+    ASSERT(MipCount > 0);
 
-    for (u32 ClusterIndex = 0; ClusterIndex < Renderer->ClusterCount; ++ClusterIndex)
+    ZERO_STRUCT_POINTER(Texture);
+    Texture->SizeX = Mips[0].SizeX;
+    Texture->SizeY = Mips[0].SizeY;
+    Texture->Format = Mips[0].Format;
+    Texture->IsAlphaPremultiplied = Mips[0].IsAlphaPremultiplied;
+    Texture->MaxMipCount = MipCount;
+    Texture->MipCount = MipCount;
+    Texture->Mips = Mips;
+
+    ASSERT(Mips[0].IsPadded);
+    for (u32 MipLevel = 1; MipLevel < MipCount; ++MipLevel)
     {
-        renderer_cluster* Cluster = Renderer->Clusters + ClusterIndex;
-        Cluster->MaxPrimitiveCount = 1024;
-        Cluster->Primitives = PUSH_ARRAY(Arena, renderer_primitive, Cluster->MaxPrimitiveCount);
+        ASSERT(Mips[MipLevel].IsPadded);
+        ASSERT(Mips[MipLevel].SizeX == Mips[MipLevel - 1].SizeX / 2);
+        ASSERT(Mips[MipLevel].SizeY == Mips[MipLevel - 1].SizeY / 2);
+        ASSERT(Mips[MipLevel].Format == Texture->Format);
     }
 }
 
+//====================================================================================================================//
+//--------------------------------------------------- SPAN KERNELS ---------------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): The span kernels are the innermost loops of the rasterizer. Each kernel has a scalar floating point
+// implementation, which is the reference that defines the expected output, and a fixed-point implementation (scalar
+// and, when compiling for x64, SIMD variants that are selected at runtime based on the features supported by the CPU)
+// that is used for rendering. Define 'PVZ_RENDERER_REFERENCE_KERNELS' to render with the reference kernels instead.
+//
+
 internal void
-Renderer_GetClusterGridSize(u32 ClusterCount, u32* OutClusterCountX, u32* OutClusterCountY)
+Renderer_FillSpanScalar(u32* Pixels, u32 PixelCount, color4 Color)
 {
-    *OutClusterCountX = 0;
-    *OutClusterCountY = 0;
-
-    if (1 <= ClusterCount && ClusterCount < 2)
-    {
-        *OutClusterCountX = 1;
-        *OutClusterCountY = 1;
-    }
-    else if (2 <= ClusterCount && ClusterCount < 4)
-    {
-        *OutClusterCountX = 1;
-        *OutClusterCountY = 2;
-    }
-    else if (4 <= ClusterCount && ClusterCount < 6)
-    {
-        *OutClusterCountX = 2;
-        *OutClusterCountY = 2;
-    }
-    else if (6 <= ClusterCount && ClusterCount < 8)
-    {
-        *OutClusterCountX = 2;
-        *OutClusterCountY = 3;
-    }
-    else if (8 <= ClusterCount && ClusterCount < 10)
-    {
-        *OutClusterCountX = 2;
-        *OutClusterCountY = 4;
-    }
-    else if (10 <= ClusterCount && ClusterCount < 12)
-    {
-        *OutClusterCountX = 2;
-        *OutClusterCountY = 5;
-    }
-    else if (12 <= ClusterCount && ClusterCount < 16)
-    {
-        *OutClusterCountX = 3;
-        *OutClusterCountY = 4;
-    }
-    else if (16 <= ClusterCount)
+    for (u32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
     {
-        *OutClusterCountX = 4;
-        *OutClusterCountY = 4;
+        const color4 CurrentColor = Color4_FromLinear(LinearColor_UnpackFromBGRA(Pixels[PixelIndex]));
+        const color4 BlendedColor = Color4(Math_Lerp(CurrentColor.R, Color.R, Color.A),
+                                           Math_Lerp(CurrentColor.G, Color.G, Color.A),
+                                           Math_Lerp(CurrentColor.B, Color.B, Color.A));
+
+        Pixels[PixelIndex] = LinearColor_PackToBGRA(Color4_ToLinear(BlendedColor));
     }
 }
 
-function void
-Renderer_BeginFrame(renderer* Renderer, u32 ViewportSizeX, u32 ViewportSizeY)
-{
-    Renderer->ViewportSizeX = ViewportSizeX;
-    Renderer->ViewportSizeY = ViewportSizeY;
+//
+// NOTE(Traian): Premultiplied sources are blended as 'Src + Dst * (1 - SrcA)', with the color channels clamped to the
+// alpha (which a premultiplied color can never exceed). The sum is rounded once, at the end, so that the fixed-point
+// kernels (which keep the source channels and alpha at a higher precision than 8 bits) can match it within one.
+// Rounding the source alpha to 8 bits first would let the source and destination terms each be off by one.
+//
 
-    //
-    // NOTE(Traian): Reset the renderer primitive and texture slot buffers.
-    //
+internal inline u32
+Renderer_BlendPremultipliedChannelScalar(f32 Src, f32 InverseSrcA, u32 Dst)
+{
+    u32 Result = (u32)((Src * 255.0F) + ((f32)Dst * InverseSrcA) + 0.5F);
+    if (Result > 255) { Result = 255; }
+    return Result;
+}
 
-    ZERO_STRUCT_ARRAY(Renderer->Primitives, Renderer->CurrentPrimitiveIndex);
-    ZERO_STRUCT_ARRAY(Renderer->TextureSlots, Renderer->CurrentTextureSlotIndex);
-    Renderer->CurrentPrimitiveIndex = 0;
-    Renderer->CurrentTextureSlotIndex = 0;
+internal inline u32
+Renderer_BlendPremultipliedScalar(u32 DstPixel, color4 SrcColor)
+{
+    const f32 SrcA = Clamp(SrcColor.A, 0.0F, 1.0F);
+    const f32 InverseSrcA = 1.0F - SrcA;
 
-    //
-    // NOTE(Traian): Partition the viewport into multiple clusters.
-    //
+    const u32 BlendedR = Renderer_BlendPremultipliedChannelScalar(Min(SrcColor.R, SrcA), InverseSrcA,
+                                                                  (DstPixel >> 16) & 0xFF);
+    const u32 BlendedG = Renderer_BlendPremultipliedChannelScalar(Min(SrcColor.G, SrcA), InverseSrcA,
+                                                                  (DstPixel >>  8) & 0xFF);
+    const u32 BlendedB = Renderer_BlendPremultipliedChannelScalar(Min(SrcColor.B, SrcA), InverseSrcA,
+                                                                  (DstPixel >>  0) & 0xFF);
 
-    u32 ClusterCountX = 0;
-    u32 ClusterCountY = 0;
-    Renderer_GetClusterGridSize(Renderer->ClusterCount, &ClusterCountX, &ClusterCountY);
+    const u32 Result = 0xFF000000 | (BlendedR << 16) | (BlendedG << 8) | BlendedB;
+    return Result;
+}
 
-    for (u32 ClusterIndexY = 0; ClusterIndexY < ClusterCountY; ++ClusterIndexY)
+internal void
+Renderer_DrawTexturedSpanRangeScalar(const renderer_textured_span* Span, u32 FirstPixelIndex)
+{
+    for (u32 PixelIndex = FirstPixelIndex; PixelIndex < Span->PixelCount; ++PixelIndex)
     {
-        for (u32 ClusterIndexX = 0; ClusterIndexX < ClusterCountX; ++ClusterIndexX)
+        // NOTE(Traian): The coordinate is computed from the first step (instead of being accumulated) so that the SIMD
+        // kernels can evaluate any pixel of the span independently and still match this kernel.
+        vec2 UV;
+        UV.X = Span->U + (f32)(Span->FirstStepIndex + PixelIndex) * Span->DeltaU;
+        UV.Y = Span->V;
+
+        // NOTE(Traian): Sample from the mips.
+        color4 SampledColor;
+        if (Span->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8)
         {
-            const u32 ClusterIndex = (ClusterIndexY * ClusterCountX) + ClusterIndexX;
-            renderer_cluster* Cluster = Renderer->Clusters + ClusterIndex;
-
-            Cluster->DrawRegionOffsetX = 0;
-            if (ClusterIndexX > 0)
+            SampledColor = Image_SampleBilinearB8G8R8A8(Span->MipImageA, UV);
+            if (Span->BlendBetweenMips)
             {
-                const u32 NeighbourClusterIndex = ClusterIndex - 1;
-                const renderer_cluster* NeighbourCluster = Renderer->Clusters + NeighbourClusterIndex;
-                Cluster->DrawRegionOffsetX = NeighbourCluster->DrawRegionOffsetX + NeighbourCluster->DrawRegionSizeX;
+                const color4 SampledB = Image_SampleBilinearB8G8R8A8(Span->MipImageB, UV);
+                SampledColor = Math_LerpColor4(SampledColor, SampledB, Span->InterpolationFactorAB);
             }
 
-            Cluster->DrawRegionOffsetY = 0;
-            if (ClusterIndexY > 0)
+            SampledColor.R *= Span->Color.R;
+            SampledColor.G *= Span->Color.G;
+            SampledColor.B *= Span->Color.B;
+            SampledColor.A *= Span->Color.A;
+        }
+        else
+        {
+            f32 SampledAlpha = Image_SampleBilinearA8(Span->MipImageA, UV);
+            if (Span->BlendBetweenMips)
             {
-                const u32 NeighbourClusterIndex = ClusterIndex - ClusterCountX;
-                const renderer_cluster* NeighbourCluster = Renderer->Clusters + NeighbourClusterIndex;
-                Cluster->DrawRegionOffsetY = NeighbourCluster->DrawRegionOffsetY + NeighbourCluster->DrawRegionSizeY;
+                const f32 SampledB = Image_SampleBilinearA8(Span->MipImageB, UV);
+                SampledAlpha = Math_Lerp(SampledAlpha, SampledB, Span->InterpolationFactorAB);
             }
 
-            Cluster->DrawRegionSizeX = ViewportSizeX / ClusterCountX;
-            Cluster->DrawRegionSizeY = ViewportSizeY / ClusterCountY;
+            SampledColor = Span->Color;
+            SampledColor.A *= SampledAlpha;
+        }
 
-            if (ClusterIndexX < (ViewportSizeX % ClusterCountX))
-            {
-                Cluster->DrawRegionSizeX++;
-            }
-            if (ClusterIndexY < (ViewportSizeY % ClusterCountY))
-            {
-                Cluster->DrawRegionSizeY++;
-            }
+        // NOTE(Traian): Output the color to the render target buffer.
+        if (Span->IsAlphaPremultiplied)
+        {
+            Span->Pixels[PixelIndex] = Renderer_BlendPremultipliedScalar(Span->Pixels[PixelIndex], SampledColor);
+        }
+        else
+        {
+            const color4 CurrentColor = Color4_FromLinear(LinearColor_UnpackFromBGRA(Span->Pixels[PixelIndex]));
+            const color4 BlendedColor = Color4(Math_Lerp(CurrentColor.R, SampledColor.R, SampledColor.A),
+                                               Math_Lerp(CurrentColor.G, SampledColor.G, SampledColor.A),
+                                               Math_Lerp(CurrentColor.B, SampledColor.B, SampledColor.A));
+
+            Span->Pixels[PixelIndex] = LinearColor_PackToBGRA(Color4_ToLinear(BlendedColor));
         }
     }
+}
 
-    //
-    // NOTE(Traian): Reset the primitive buffer of each cluster.
-    //
+internal void
+Renderer_DrawTexturedSpanScalar(const renderer_textured_span* Span)
+{
+    Renderer_DrawTexturedSpanRangeScalar(Span, 0);
+}
 
-    for (u32 ClusterIndex = 0; ClusterIndex < Renderer->ClusterCount; ++ClusterIndex)
-    {
-        renderer_cluster* Cluster = Renderer->Clusters + ClusterIndex;
-        ZERO_STRUCT_ARRAY(Cluster->Primitives, Cluster->CurrentPrimitiveIndex);
-        Cluster->CurrentPrimitiveIndex = 0;
-    }
+//
+// NOTE(Traian): The fixed-point kernels never convert the pixels to floating point. The bilinear, mip and tint weights
+// are quantized to 2.14 fixed-point (a weight of 'RENDERER_FIXED_ONE' being exactly one), while the interpolated
+// channels are kept as 8.7 fixed-point values, so that every product fits into the signed 16-bit multiply-adds of the
+// SIMD kernels. The tinted source channels stay 8.7 values as well, and the blended sum is rounded to 8 bits only
+// once, just like the reference does. The weights are derived with the same floating point operations the reference
+// performs and the remaining quantization error is a small fraction of a channel step, which keeps the output within
+// one of the reference in each channel (as checked by 'Renderer_VerifySpanKernels'). The scalar and SIMD fixed-point
+// kernels perform exactly the same integer operations, so their outputs are bit-identical. Only premultiplied
+// B8G8R8A8 textures take this path, the others fall back to the reference kernel.
+//
+
+#define RENDERER_FIXED_WEIGHT_BITS  (14)
+#define RENDERER_FIXED_ONE          (1 << RENDERER_FIXED_WEIGHT_BITS)
+#define RENDERER_FIXED_CHANNEL_BITS (7)
+
+internal inline u32
+Renderer_GetFixedWeight(f32 Weight)
+{
+    const u32 Result = (u32)(Weight * (f32)RENDERER_FIXED_ONE + 0.5F);
+    return Result;
 }
 
-function void
-Renderer_EndFrame(renderer* Renderer)
+internal inline u32
+Renderer_LerpFixed(u32 ValueA, u32 ValueB, u32 Weight)
 {
+    const u32 Result = ((ValueA * (RENDERER_FIXED_ONE - Weight)) + (ValueB * Weight)) >> RENDERER_FIXED_WEIGHT_BITS;
+    return Result;
 }
 
-function void
-Renderer_PushPrimitive(renderer* Renderer, vec2 MinPoint, vec2 MaxPoint, f32 ZOffset, color4 Color,
-                       vec2 MinUV /*= {}*/, vec2 MaxUV /*= {}*/, const renderer_texture* Texture /*= NULL*/)
+// NOTE(Traian): Scales an 8.7 channel by a weight, rounding the result to an 8.7 channel.
+internal inline u32
+Renderer_TintFixed(u32 Value, u32 Tint)
 {
-    if (Renderer->CurrentPrimitiveIndex >= Renderer->MaxPrimitiveCount)
-    {
-        PANIC("Renderer primitive buffer overflown!");
-    }
+    const u32 Result = ((Value * Tint) + (RENDERER_FIXED_ONE / 2)) >> RENDERER_FIXED_WEIGHT_BITS;
+    return Result;
+}
 
-    u32 TextureSlotIndex = -1;
-    if (Texture != NULL)
-    {
-        TextureSlotIndex = Renderer->CurrentTextureSlotIndex;
-        for (u32 SlotIndex = 0; SlotIndex < Renderer->CurrentTextureSlotIndex; ++SlotIndex)
-        {
-            if (Renderer->TextureSlots[SlotIndex] == Texture)
-            {
-                TextureSlotIndex = SlotIndex;
-                break;
-            }
-        }
+//
+// NOTE(Traian): An 8.7 alpha of 255 (fully opaque) is 32640, so it is converted to a weight by scaling it with
+// '2^14 / 32640', which is approximated (well below the precision of a weight) by '16448 / 2^15'. Fully opaque and
+// fully transparent alphas still map exactly to one and zero. The product fits into a signed 32-bit lane.
+//
+#define RENDERER_FIXED_ALPHA_TO_WEIGHT          (16448)
+#define RENDERER_FIXED_ALPHA_TO_WEIGHT_BITS     (15)
 
-        if (TextureSlotIndex == Renderer->CurrentTextureSlotIndex)
-        {
-            if (Renderer->CurrentTextureSlotIndex >= Renderer->MaxTextureSlotCount)
-            {
-                PANIC("Renderer texture slot buffer overflown!");
-            }
+internal inline u32
+Renderer_GetFixedInverseAlphaWeight(u32 Alpha)
+{
+    const u32 Shift = RENDERER_FIXED_ALPHA_TO_WEIGHT_BITS;
+    const u32 Weight = ((Alpha * RENDERER_FIXED_ALPHA_TO_WEIGHT) + (1 << (Shift - 1))) >> Shift;
+    const u32 Result = RENDERER_FIXED_ONE - Weight;
+    return Result;
+}
 
-            Renderer->CurrentTextureSlotIndex++;
-            Renderer->TextureSlots[TextureSlotIndex] = Texture;
-        }
-    }
+// NOTE(Traian): Blends an 8.7 source channel over an 8-bit destination channel, rounding the sum to 8 bits.
+internal inline u32
+Renderer_BlendPremultipliedChannelFixed(u32 Src, u32 InverseAlphaWeight, u32 Dst)
+{
+    const u32 Shift = RENDERER_FIXED_WEIGHT_BITS;
+    const u32 Result = ((Src << (RENDERER_FIXED_WEIGHT_BITS - RENDERER_FIXED_CHANNEL_BITS)) +
+                        (Dst * InverseAlphaWeight) + (1 << (Shift - 1))) >> Shift;
+    return Result;
+}
 
-    renderer_primitive* Primitive = Renderer->Primitives + Renderer->CurrentPrimitiveIndex;
-    Primitive->Index = Renderer->CurrentPrimitiveIndex;
-    Primitive->MinPoint = MinPoint;
-    Primitive->MaxPoint = MaxPoint;
-    Primitive->ZOffset = ZOffset;
-    Primitive->Color = Color;
-    Primitive->MinUV = MinUV;
-    Primitive->MaxUV = MaxUV;
-    Primitive->TextureSlotIndex = TextureSlotIndex;
+//
+// NOTE(Traian): The texel rows sampled by a span. The mips are padded, so the texels to the right of and above each
+// sampled texel are always in memory. The column offset of a texel is 'X + (TILE_SIZE - 1) * (X & TileMask)', where
+// the mask is zero for linear mips (making the offset just 'X') and selects the tile for tiled mips.
+//
+struct renderer_fixed_texel_rows
+{
+    const u32*  BottomRow;
+    const u32*  TopRow;
+    u32         TileMask;
+    u32         WeightY;
+    f32         SizeX;
+    f32         MaxTexelX;
+};
 
-    Renderer->CurrentPrimitiveIndex++;
+internal inline renderer_fixed_texel_rows
+Renderer_GetFixedTexelRows(const renderer_image* Image, f32 V)
+{
+    ASSERT(Image->IsPadded);
+
+    u32 Tex1Y = (u32)(V * (f32)Image->SizeY);
+    if (Tex1Y >= Image->SizeY) { Tex1Y = Image->SizeY - 1; }
+    const f32 TY = V - ((f32)Tex1Y / (f32)Image->SizeY);
+
+    renderer_fixed_texel_rows Rows = {};
+    Rows.BottomRow = (const u32*)Image->PixelBuffer + Image_GetRowOffset(Image, Tex1Y);
+    Rows.TopRow = (const u32*)Image->PixelBuffer + Image_GetRowOffset(Image, Tex1Y + 1);
+    Rows.TileMask = (Image->Layout == RENDERER_IMAGE_LAYOUT_TILED) ? ~(u32)(RENDERER_IMAGE_TILE_SIZE - 1) : 0;
+    Rows.WeightY = Renderer_GetFixedWeight(TY);
+    Rows.SizeX = (f32)Image->SizeX;
+    Rows.MaxTexelX = (f32)(Image->SizeX - 1);
+    return Rows;
 }
 
-internal inline b8
-Renderer_ShouldPrimitivesBeSwapped(f32 ZOffsetA, u32 IndexA, f32 ZOffsetB, u32 IndexB)
+// NOTE(Traian): Returns the left texel of the sampled pair (clamped to the last one) and its horizontal weight.
+internal inline u32
+Renderer_GetFixedTexelX(const renderer_fixed_texel_rows* Rows, f32 U, u32* OutWeightX)
+{
+    f32 TexelX = U * Rows->SizeX;
+    if (!(TexelX < Rows->MaxTexelX)) { TexelX = Rows->MaxTexelX; }
+    const u32 Tex1X = (u32)TexelX;
+    *OutWeightX = Renderer_GetFixedWeight(U - ((f32)Tex1X / Rows->SizeX));
+    return Tex1X;
+}
+
+internal inline u32
+Renderer_GetFixedTexelColumn(const renderer_fixed_texel_rows* Rows, u32 TexelX)
+{
+    const u32 Result = TexelX + ((RENDERER_IMAGE_TILE_SIZE - 1) * (TexelX & Rows->TileMask));
+    return Result;
+}
+
+// NOTE(Traian): Returns the bilinearly filtered B, G, R and A channels, as 8.7 fixed-point values.
+internal inline void
+Renderer_SampleBilinearFixed(const renderer_fixed_texel_rows* Rows, f32 U, u32* OutChannels)
 {
-    b8 Result;
-    if (ZOffsetA > ZOffsetB)
+    u32 WeightX;
+    const u32 Tex1X = Renderer_GetFixedTexelX(Rows, U, &WeightX);
+
+    u32 Texel1, Texel2, Texel3, Texel4;
+    if (Rows->TileMask == 0)
     {
-        Result = true;
+        // NOTE(Traian): Each row contributes a pair of adjacent texels, fetched with a single (unaligned) 8-byte load.
+        u64 BottomTexels;
+        u64 TopTexels;
+        CopyMemory(&BottomTexels, Rows->BottomRow + Tex1X, sizeof(u64));
+        CopyMemory(&TopTexels, Rows->TopRow + Tex1X, sizeof(u64));
+        Texel1 = (u32)BottomTexels;
+        Texel2 = (u32)(BottomTexels >> 32);
+        Texel3 = (u32)TopTexels;
+        Texel4 = (u32)(TopTexels >> 32);
     }
-    else if ((ZOffsetA == ZOffsetB) && (IndexA > IndexB))
+    else
     {
-        Result = true;
+        // NOTE(Traian): The right texel lives in the next tile when the left one is on the last column of its tile.
+        const u32 LeftColumn = Renderer_GetFixedTexelColumn(Rows, Tex1X);
+        const u32 RightColumn = Renderer_GetFixedTexelColumn(Rows, Tex1X + 1);
+        Texel1 = Rows->BottomRow[LeftColumn];
+        Texel2 = Rows->BottomRow[RightColumn];
+        Texel3 = Rows->TopRow[LeftColumn];
+        Texel4 = Rows->TopRow[RightColumn];
     }
-    else
+
+    // NOTE(Traian): The texels are interpolated vertically first, and then horizontally.
+    const u32 ColumnShift = RENDERER_FIXED_WEIGHT_BITS - RENDERER_FIXED_CHANNEL_BITS;
+    const u32 WeightY = Rows->WeightY;
+    for (u32 ChannelIndex = 0; ChannelIndex < 4; ++ChannelIndex)
     {
-        Result = false;
+        const u32 Shift = 8 * ChannelIndex;
+        const u32 Left = ((((Texel1 >> Shift) & 0xFF) * (RENDERER_FIXED_ONE - WeightY)) +
+                          (((Texel3 >> Shift) & 0xFF) * WeightY)) >> ColumnShift;
+        const u32 Right = ((((Texel2 >> Shift) & 0xFF) * (RENDERER_FIXED_ONE - WeightY)) +
+                           (((Texel4 >> Shift) & 0xFF) * WeightY)) >> ColumnShift;
+        OutChannels[ChannelIndex] = Renderer_LerpFixed(Left, Right, WeightX);
     }
-    return Result;
 }
 
-internal void
-Renderer_SortPrimitiveBuffer(renderer_primitive* Primitives, u32 PrimitiveCount)
+//
+// NOTE(Traian): The per-span constants of the fixed-point kernels. The tint holds the (premultiplied) span color in the
+// B, G, R and A order of the pixels.
+//
+struct renderer_fixed_span_setup
+{
+    renderer_fixed_texel_rows   RowsA;
+    renderer_fixed_texel_rows   RowsB;
+    u32                         WeightAB;
+    u32                         Tint[4];
+};
+
+internal inline renderer_fixed_span_setup
+Renderer_GetFixedSpanSetup(const renderer_textured_span* Span)
 {
-    // TODO(Traian): Implement a better sorting algorithm!
+    renderer_fixed_span_setup Setup = {};
+    Setup.RowsA = Renderer_GetFixedTexelRows(Span->MipImageA, Span->V);
+    if (Span->BlendBetweenMips)
+    {
+        Setup.RowsB = Renderer_GetFixedTexelRows(Span->MipImageB, Span->V);
+        Setup.WeightAB = Renderer_GetFixedWeight(Span->InterpolationFactorAB);
+    }
+    Setup.Tint[0] = Renderer_GetFixedWeight(Span->Color.B);
+    Setup.Tint[1] = Renderer_GetFixedWeight(Span->Color.G);
+    Setup.Tint[2] = Renderer_GetFixedWeight(Span->Color.R);
+    Setup.Tint[3] = Renderer_GetFixedWeight(Span->Color.A);
+    return Setup;
+}
 
-    for (u32 I = 1; I <= PrimitiveCount; ++I)
+internal void
+Renderer_DrawTexturedSpanRangeFixed(const renderer_textured_span* Span, const renderer_fixed_span_setup* Setup,
+                                    u32 FirstPixelIndex)
+{
+    for (u32 PixelIndex = FirstPixelIndex; PixelIndex < Span->PixelCount; ++PixelIndex)
     {
-        for (u32 J = 0; J < PrimitiveCount - I; ++J)
+        const f32 U = Span->U + (f32)(Span->FirstStepIndex + PixelIndex) * Span->DeltaU;
+
+        u32 Channels[4];
+        Renderer_SampleBilinearFixed(&Setup->RowsA, U, Channels);
+        if (Span->BlendBetweenMips)
         {
-            renderer_primitive* A = Primitives + (J + 0);
-            renderer_primitive* B = Primitives + (J + 1);
-            if (Renderer_ShouldPrimitivesBeSwapped(A->ZOffset, A->Index, B->ZOffset, B->Index))
+            u32 ChannelsB[4];
+            Renderer_SampleBilinearFixed(&Setup->RowsB, U, ChannelsB);
+            for (u32 ChannelIndex = 0; ChannelIndex < 4; ++ChannelIndex)
             {
-                renderer_primitive Temp = *A;
-                *A = *B;
-                *B = Temp;
+                Channels[ChannelIndex] = Renderer_LerpFixed(Channels[ChannelIndex], ChannelsB[ChannelIndex],
+                                                            Setup->WeightAB);
             }
         }
+
+        const u32 SrcA = Renderer_TintFixed(Channels[3], Setup->Tint[3]);
+        u32 Src[3];
+        for (u32 ChannelIndex = 0; ChannelIndex < 3; ++ChannelIndex)
+        {
+            Src[ChannelIndex] = Renderer_TintFixed(Channels[ChannelIndex], Setup->Tint[ChannelIndex]);
+            if (Src[ChannelIndex] > SrcA) { Src[ChannelIndex] = SrcA; }
+        }
+
+        const u32 DstPixel = Span->Pixels[PixelIndex];
+        const u32 InverseAlphaWeight = Renderer_GetFixedInverseAlphaWeight(SrcA);
+        const u32 BlendedB = Renderer_BlendPremultipliedChannelFixed(Src[0], InverseAlphaWeight,
+                                                                     (DstPixel >>  0) & 0xFF);
+        const u32 BlendedG = Renderer_BlendPremultipliedChannelFixed(Src[1], InverseAlphaWeight,
+                                                                     (DstPixel >>  8) & 0xFF);
+        const u32 BlendedR = Renderer_BlendPremultipliedChannelFixed(Src[2], InverseAlphaWeight,
+                                                                     (DstPixel >> 16) & 0xFF);
+        Span->Pixels[PixelIndex] = 0xFF000000 | (BlendedR << 16) | (BlendedG << 8) | BlendedB;
     }
 }
 
-struct renderer_rasterization_area
+internal inline b8
+Renderer_CanDrawTexturedSpanFixed(const renderer_textured_span* Span)
 {
-    u32 PixelOffsetX;
-    u32 PixelOffsetY;
-    u32 PixelCountX;
-    u32 PixelCountY;
-};
+    const b8 Result = Span->IsAlphaPremultiplied && (Span->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8);
+    return Result;
+}
 
-internal renderer_rasterization_area
-Renderer_GetRasterizationArea(f32 ViewportSizeX, f32 ViewportSizeY, rect2D QuadRegion)
+internal void
+Renderer_DrawTexturedSpanFixed(const renderer_textured_span* Span)
 {
-    ASSERT(ViewportSizeX >= 0.0F && ViewportSizeY >= 0.0F);
-    ASSERT(QuadRegion.Min.X >= 0.0F && QuadRegion.Min.Y >= 0.0F && !Rect2D_IsDegenerated(QuadRegion));
+    if (!Renderer_CanDrawTexturedSpanFixed(Span))
+    {
+        Renderer_DrawTexturedSpanScalar(Span);
+        return;
+    }
 
-    vec2 MinSamplePoint;
-    MinSamplePoint.X = QuadRegion.Min.X * ViewportSizeX;
-    MinSamplePoint.Y = QuadRegion.Min.Y * ViewportSizeY;
-    vec2 MaxSamplePoint;
-    MaxSamplePoint.X = QuadRegion.Max.X * ViewportSizeX;
-    MaxSamplePoint.Y = QuadRegion.Max.Y * ViewportSizeY;
+    const renderer_fixed_span_setup Setup = Renderer_GetFixedSpanSetup(Span);
+    Renderer_DrawTexturedSpanRangeFixed(Span, &Setup, 0);
+}
+
+//
+// NOTE(Traian): Translucent fills are a single interpolation towards a constant color, so an 8-bit alpha weight (with
+// 256 being exactly one) is precise enough, and lets the SIMD kernels blend the channels as 16-bit values. The result
+// is truncated, just like the reference does.
+//
+
+internal inline u32
+Renderer_GetFillWeight(f32 Alpha)
+{
+    const u32 Result = (u32)(Alpha * 256.0F + 0.5F);
+    return Result;
+}
 
-    s32 MinSampleIndexX = (s32)(MinSamplePoint.X + 0.5F);
-    s32 MinSampleIndexY = (s32)(MinSamplePoint.Y + 0.5F);
+internal void
+Renderer_FillSpanRangeFixed(u32* Pixels, u32 PixelCount, color4 Color, u32 FirstPixelIndex)
+{
+    const u32 Weight = Renderer_GetFillWeight(Color.A);
+    const u32 InverseWeight = 256 - Weight;
+    const u32 SrcR = (u32)(Color.R * 255.0F + 0.5F) * Weight;
+    const u32 SrcG = (u32)(Color.G * 255.0F + 0.5F) * Weight;
+    const u32 SrcB = (u32)(Color.B * 255.0F + 0.5F) * Weight;
 
-    // NOTE(Traian): In order to avoid overdraw, if the sample point on one of the axis is *exactly* on the center of
-    // the pixel on the right/bottom side of the quad, we discard that pixel. However, floating point math is
-    // imprecise! In order to ensure that dividing a quad into multiple quads and rendering them separately doesn't
-    // produce any gaps between them, we must introduce a small error tolerance.
-    // But this is more of a hack rather than a fix! Error tolerances are dependent on the resolution at which we
-    // render, so inconsistencies from one resolution to another might appear! The proper solution to this issue is to
-    // use fixed-point math - which is outside of the scope for this game!
-    const f32 ERROR_TOLERANCE = 0.0001F;
-    
-    s32 MaxSampleIndexX = (s32)(MaxSamplePoint.X - 0.5F);
-    if (((f32)MaxSampleIndexX + 0.5F) - MaxSamplePoint.X > ERROR_TOLERANCE)
+    for (u32 PixelIndex = FirstPixelIndex; PixelIndex < PixelCount; ++PixelIndex)
     {
-        --MaxSampleIndexX;
+        const u32 DstPixel = Pixels[PixelIndex];
+        const u32 BlendedR = ((((DstPixel >> 16) & 0xFF) * InverseWeight) + SrcR) >> 8;
+        const u32 BlendedG = ((((DstPixel >>  8) & 0xFF) * InverseWeight) + SrcG) >> 8;
+        const u32 BlendedB = ((((DstPixel >>  0) & 0xFF) * InverseWeight) + SrcB) >> 8;
+        Pixels[PixelIndex] = 0xFF000000 | (BlendedR << 16) | (BlendedG << 8) | BlendedB;
     }
-    s32 MaxSampleIndexY = (s32)(MaxSamplePoint.Y - 0.5F);
-    if (((f32)MaxSampleIndexY + 0.5F) - MaxSamplePoint.Y > ERROR_TOLERANCE)
+}
+
+internal void
+Renderer_FillSpanFixed(u32* Pixels, u32 PixelCount, color4 Color)
+{
+    if (Color.A == 1.0F)
     {
-        --MaxSampleIndexY;
+        // NOTE(Traian): Opaque fills don't depend on the destination, so just store the packed color.
+        const u32 PackedColor = LinearColor_PackToBGRA(Color4_ToLinear(Color4(Color.R, Color.G, Color.B)));
+        for (u32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
+        {
+            Pixels[PixelIndex] = PackedColor;
+        }
+        return;
     }
 
-    renderer_rasterization_area RasterizationArea = {};
-    RasterizationArea.PixelOffsetX = MinSampleIndexX;
-    RasterizationArea.PixelOffsetY = MinSampleIndexY;
-    RasterizationArea.PixelCountX = MaxSampleIndexX - MinSampleIndexX + 1;
-    RasterizationArea.PixelCountY = MaxSampleIndexY - MinSampleIndexY + 1;
-    return RasterizationArea;
+    Renderer_FillSpanRangeFixed(Pixels, PixelCount, Color, 0);
 }
 
+#if PVZ_RENDERER_X64
+
 internal void
-Renderer_DrawFilledPrimitive(renderer* Renderer, renderer_image* RenderTarget, renderer_cluster* Cluster,
-                             u32 PrimitiveIndex, rect2D ClusterDrawRegion)
+Renderer_FillSpanSSE2(u32* Pixels, u32 PixelCount, color4 Color)
 {
-    const renderer_primitive* Primitive = Cluster->Primitives + PrimitiveIndex;
-    const rect2D PrimitiveRegion = Rect2D_Intersect({ Primitive->MinPoint, Primitive->MaxPoint }, ClusterDrawRegion);
-
-    renderer_rasterization_area RasterizationArea = Renderer_GetRasterizationArea(RenderTarget->SizeX,
-                                                                                  RenderTarget->SizeY,
-                                                                                  PrimitiveRegion);
+    u32 PixelIndex = 0;
 
-    if (RenderTarget->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8)
+    if (Color.A == 1.0F)
     {
-        u32* CurrentRowAddress = (u32*)Image_GetPixelAddress(RenderTarget,
-                                                             RasterizationArea.PixelOffsetX,
-                                                             RasterizationArea.PixelOffsetY);
-
-        for (u32 PixelIndexY = 0; PixelIndexY < RasterizationArea.PixelCountY; ++PixelIndexY)
+        // NOTE(Traian): Opaque fills don't depend on the destination, so just store the packed color.
+        const u32 PackedColor = LinearColor_PackToBGRA(Color4_ToLinear(Color4(Color.R, Color.G, Color.B)));
+        const __m128i PackedColor4x = _mm_set1_epi32((int)PackedColor);
+        for (; PixelIndex + 4 <= PixelCount; PixelIndex += 4)
         {
-            u32* CurrentPixelAddress = CurrentRowAddress;
-            for (u32 PixelIndexX = 0; PixelIndexX < RasterizationArea.PixelCountX; ++PixelIndexX)
-            {
-                // NOTE(Traian): Output the color to the render target buffer.
-                const color4 CurrentColor = Color4_FromLinear(LinearColor_UnpackFromBGRA(*CurrentPixelAddress));
-                const color4 BlendedColor = Color4(Math_Lerp(CurrentColor.R, Primitive->Color.R, Primitive->Color.A),
-                                                   Math_Lerp(CurrentColor.G, Primitive->Color.G, Primitive->Color.A),
-                                                   Math_Lerp(CurrentColor.B, Primitive->Color.B, Primitive->Color.A));
-
-                *CurrentPixelAddress = LinearColor_PackToBGRA(Color4_ToLinear(BlendedColor));
-                ++CurrentPixelAddress;
-            }
-            CurrentRowAddress += RenderTarget->SizeX;
+            _mm_storeu_si128((__m128i*)(Pixels + PixelIndex), PackedColor4x);
+        }
+        for (; PixelIndex < PixelCount; ++PixelIndex)
+        {
+            Pixels[PixelIndex] = PackedColor;
         }
+        return;
     }
-    else
+
+    // NOTE(Traian): The channels are processed as 16-bit values, two pixels per half. Neither the products nor their
+    // sum exceed 255 * 256, so they fit in 16 bits. The alpha channel is replaced with 255 at the end.
+    const u32 Weight = Renderer_GetFillWeight(Color.A);
+    const __m128i InverseWeight = _mm_set1_epi16((short)(256 - Weight));
+    const short SrcR = (short)((u32)(Color.R * 255.0F + 0.5F) * Weight);
+    const short SrcG = (short)((u32)(Color.G * 255.0F + 0.5F) * Weight);
+    const short SrcB = (short)((u32)(Color.B * 255.0F + 0.5F) * Weight);
+    const __m128i SrcColor = _mm_setr_epi16(SrcB, SrcG, SrcR, 0, SrcB, SrcG, SrcR, 0);
+    const __m128i OpaqueAlpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i Zero = _mm_setzero_si128();
+
+    for (; PixelIndex + 4 <= PixelCount; PixelIndex += 4)
     {
-        // TODO(Traian): Eventually support more texture formats?
-        PANIC("Image with non supported fomat was used as render target!");
+        const __m128i Packed = _mm_loadu_si128((const __m128i*)(Pixels + PixelIndex));
+        const __m128i BlendedLo = _mm_srli_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(Packed, Zero), InverseWeight), SrcColor), 8);
+        const __m128i BlendedHi = _mm_srli_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(Packed, Zero), InverseWeight), SrcColor), 8);
+        _mm_storeu_si128((__m128i*)(Pixels + PixelIndex),
+                         _mm_or_si128(_mm_packus_epi16(BlendedLo, BlendedHi), OpaqueAlpha));
     }
+
+    Renderer_FillSpanRangeFixed(Pixels, PixelCount, Color, PixelIndex);
+}
+
+//
+// NOTE(Traian): The textured kernels gather the four texels of each lane through texel column offsets (relative to the
+// start of the bottom and top rows). The mips are padded, so the right and top neighbours never need bounds checks.
+// Tiled mips take the same column offsets as the scalar sampler, with the right texel possibly in the next tile. From
+// there on, each
+// pixel is kept in a separate vector, with its B, G, R and A channels in the 32-bit lanes. Every interpolation places
+// the two inputs of a channel in the low and high 16 bits of its lane, so that a single 'madd' against the packed
+// '(1 - Weight, Weight)' pair computes both products and their sum.
+//
+
+// NOTE(Traian): Loads the texel at each index along with the texel that follows it in memory. SSE2 has no gather
+// instruction, so the indices are extracted and each pair of texels is fetched with a single 8-byte load.
+internal inline void
+Renderer_GatherTexelPairsSSE2(const u32* Texels, __m128i TexelIndices, __m128i* OutLeft, __m128i* OutRight)
+{
+    alignas(16) u32 Indices[4];
+    _mm_store_si128((__m128i*)Indices, TexelIndices);
+    const __m128i Pairs01 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(Texels + Indices[0])),
+                                               _mm_loadl_epi64((const __m128i*)(Texels + Indices[1])));
+    const __m128i Pairs23 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)(Texels + Indices[2])),
+                                               _mm_loadl_epi64((const __m128i*)(Texels + Indices[3])));
+    *OutLeft = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(Pairs01), _mm_castsi128_ps(Pairs23),
+                                               _MM_SHUFFLE(2, 0, 2, 0)));
+    *OutRight = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(Pairs01), _mm_castsi128_ps(Pairs23),
+                                                _MM_SHUFFLE(3, 1, 3, 1)));
+}
+
+internal inline __m128i
+Renderer_GatherTexelsSSE2(const u32* Texels, __m128i TexelIndices)
+{
+    alignas(16) u32 Indices[4];
+    _mm_store_si128((__m128i*)Indices, TexelIndices);
+    const __m128i Result = _mm_setr_epi32((int)Texels[Indices[0]], (int)Texels[Indices[1]],
+                                          (int)Texels[Indices[2]], (int)Texels[Indices[3]]);
+    return Result;
+}
+
+internal inline __m128i
+Renderer_GetFixedTexelColumnsSSE2(const renderer_fixed_texel_rows* Rows, __m128i TexelX)
+{
+    // NOTE(Traian): SSE2 can't multiply 32-bit lanes, so the multiplication by 3 is a shift and an add.
+    static_assert(RENDERER_IMAGE_TILE_SIZE == 4, "The tiled column offsets assume 4x4 tiles!");
+    const __m128i TileOffset = _mm_and_si128(TexelX, _mm_set1_epi32((int)Rows->TileMask));
+    const __m128i Result = _mm_add_epi32(TexelX, _mm_add_epi32(_mm_slli_epi32(TileOffset, 1), TileOffset));
+    return Result;
+}
+
+internal inline __m128i
+Renderer_GetFixedWeightPairsSSE2(__m128i Weights)
+{
+    const __m128i Result = _mm_or_si128(_mm_sub_epi32(_mm_set1_epi32(RENDERER_FIXED_ONE), Weights),
+                                        _mm_slli_epi32(Weights, 16));
+    return Result;
+}
+
+internal inline __m128i
+Renderer_LerpFixedSSE2(__m128i ValuesA, __m128i ValuesB, __m128i WeightPairs)
+{
+    const __m128i Values = _mm_or_si128(ValuesA, _mm_slli_epi32(ValuesB, 16));
+    const __m128i Result = _mm_srli_epi32(_mm_madd_epi16(Values, WeightPairs), RENDERER_FIXED_WEIGHT_BITS);
+    return Result;
+}
+
+// NOTE(Traian): Interpolates the interleaved bottom and top texels of one pixel, returning 8.7 channels.
+internal inline __m128i
+Renderer_LerpTexelColumnSSE2(__m128i InterleavedTexels, __m128i WeightPairsY)
+{
+    const __m128i Result = _mm_srli_epi32(_mm_madd_epi16(InterleavedTexels, WeightPairsY),
+                                          RENDERER_FIXED_WEIGHT_BITS - RENDERER_FIXED_CHANNEL_BITS);
+    return Result;
+}
+
+internal inline void
+Renderer_SampleBilinearFixedSSE2(const renderer_fixed_texel_rows* Rows, __m128 U, __m128i* OutPixels)
+{
+    const __m128 SizeX = _mm_set1_ps(Rows->SizeX);
+    const __m128 MaxTexelX = _mm_set1_ps(Rows->MaxTexelX);
+    const __m128i Tex1X = _mm_cvttps_epi32(_mm_min_ps(_mm_mul_ps(U, SizeX), MaxTexelX));
+    const __m128 Tex1XFloat = _mm_cvtepi32_ps(Tex1X);
+    const __m128 TX = _mm_sub_ps(U, _mm_div_ps(Tex1XFloat, SizeX));
+    const __m128i WeightX = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(TX, _mm_set1_ps((f32)RENDERER_FIXED_ONE)),
+                                                        _mm_set1_ps(0.5F)));
+    const __m128i WeightPairsX = Renderer_GetFixedWeightPairsSSE2(WeightX);
+    const __m128i WeightPairsY = Renderer_GetFixedWeightPairsSSE2(_mm_set1_epi32((int)Rows->WeightY));
+
+    __m128i Texels1, Texels2, Texels3, Texels4;
+    if (Rows->TileMask == 0)
+    {
+        Renderer_GatherTexelPairsSSE2(Rows->BottomRow, Tex1X, &Texels1, &Texels2);
+        Renderer_GatherTexelPairsSSE2(Rows->TopRow, Tex1X, &Texels3, &Texels4);
+    }
+    else
+    {
+        const __m128i LeftColumns = Renderer_GetFixedTexelColumnsSSE2(Rows, Tex1X);
+        const __m128i RightColumns = Renderer_GetFixedTexelColumnsSSE2(Rows, _mm_add_epi32(Tex1X, _mm_set1_epi32(1)));
+        Texels1 = Renderer_GatherTexelsSSE2(Rows->BottomRow, LeftColumns);
+        Texels2 = Renderer_GatherTexelsSSE2(Rows->BottomRow, RightColumns);
+        Texels3 = Renderer_GatherTexelsSSE2(Rows->TopRow, LeftColumns);
+        Texels4 = Renderer_GatherTexelsSSE2(Rows->TopRow, RightColumns);
+    }
+
+    // NOTE(Traian): Interleaving the bytes of the bottom and top texels (and then widening them to 16 bits) places
+    // the two texels of each channel next to each other.
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i LeftTexels[2] = { _mm_unpacklo_epi8(Texels1, Texels3), _mm_unpackhi_epi8(Texels1, Texels3) };
+    const __m128i RightTexels[2] = { _mm_unpacklo_epi8(Texels2, Texels4), _mm_unpackhi_epi8(Texels2, Texels4) };
+    for (u32 LaneIndex = 0; LaneIndex < 4; ++LaneIndex)
+    {
+        const __m128i LeftPair = LeftTexels[LaneIndex / 2];
+        const __m128i RightPair = RightTexels[LaneIndex / 2];
+        const __m128i Left = Renderer_LerpTexelColumnSSE2(
+            (LaneIndex % 2) ? _mm_unpackhi_epi8(LeftPair, Zero) : _mm_unpacklo_epi8(LeftPair, Zero), WeightPairsY);
+        const __m128i Right = Renderer_LerpTexelColumnSSE2(
+            (LaneIndex % 2) ? _mm_unpackhi_epi8(RightPair, Zero) : _mm_unpacklo_epi8(RightPair, Zero), WeightPairsY);
+
+        __m128i LaneWeightPairs;
+        switch (LaneIndex)
+        {
+            case 0: LaneWeightPairs = _mm_shuffle_epi32(WeightPairsX, 0x00); break;
+            case 1: LaneWeightPairs = _mm_shuffle_epi32(WeightPairsX, 0x55); break;
+            case 2: LaneWeightPairs = _mm_shuffle_epi32(WeightPairsX, 0xAA); break;
+            default: LaneWeightPairs = _mm_shuffle_epi32(WeightPairsX, 0xFF); break;
+        }
+        OutPixels[LaneIndex] = Renderer_LerpFixedSSE2(Left, Right, LaneWeightPairs);
+    }
+}
+
+internal void
+Renderer_DrawTexturedSpanSSE2(const renderer_textured_span* Span)
+{
+    if (!Renderer_CanDrawTexturedSpanFixed(Span))
+    {
+        Renderer_DrawTexturedSpanScalar(Span);
+        return;
+    }
+
+    const renderer_fixed_span_setup Setup = Renderer_GetFixedSpanSetup(Span);
+    const __m128 LaneOffsets = _mm_setr_ps(0.0F, 1.0F, 2.0F, 3.0F);
+    const __m128 FirstU = _mm_set1_ps(Span->U);
+    const __m128 DeltaU = _mm_set1_ps(Span->DeltaU);
+    const __m128i WeightPairsAB = Renderer_GetFixedWeightPairsSSE2(_mm_set1_epi32((int)Setup.WeightAB));
+    const __m128i Tint = _mm_setr_epi32((int)Setup.Tint[0], (int)Setup.Tint[1], (int)Setup.Tint[2], (int)Setup.Tint[3]);
+    const __m128i Rounding = _mm_set1_epi32(1 << (RENDERER_FIXED_WEIGHT_BITS - 1));
+    const __m128i AlphaToWeight = _mm_set1_epi32(RENDERER_FIXED_ALPHA_TO_WEIGHT);
+    const __m128i AlphaToWeightRounding = _mm_set1_epi32(1 << (RENDERER_FIXED_ALPHA_TO_WEIGHT_BITS - 1));
+    const __m128i One = _mm_set1_epi32(RENDERER_FIXED_ONE);
+    const __m128i OpaqueAlpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i Zero = _mm_setzero_si128();
+
+    u32 PixelIndex = 0;
+    for (; PixelIndex + 4 <= Span->PixelCount; PixelIndex += 4)
+    {
+        const __m128 PixelIndices = _mm_add_ps(_mm_set1_ps((f32)(Span->FirstStepIndex + PixelIndex)), LaneOffsets);
+        const __m128 U = _mm_add_ps(FirstU, _mm_mul_ps(PixelIndices, DeltaU));
+
+        // NOTE(Traian): Sample from the mips.
+        __m128i Sampled[4];
+        Renderer_SampleBilinearFixedSSE2(&Setup.RowsA, U, Sampled);
+        if (Span->BlendBetweenMips)
+        {
+            __m128i SampledB[4];
+            Renderer_SampleBilinearFixedSSE2(&Setup.RowsB, U, SampledB);
+            for (u32 LaneIndex = 0; LaneIndex < 4; ++LaneIndex)
+            {
+                Sampled[LaneIndex] = Renderer_LerpFixedSSE2(Sampled[LaneIndex], SampledB[LaneIndex], WeightPairsAB);
+            }
+        }
+
+        // NOTE(Traian): Output the colors to the render target buffer. When the span is opaque, the inverse source
+        // alpha is zero, so the destination doesn't contribute at all.
+        __m128i* PixelsAddress = (__m128i*)(Span->Pixels + PixelIndex);
+        const __m128i Current = Span->IsOpaque ? Zero : _mm_loadu_si128(PixelsAddress);
+        const __m128i Current16[2] = { _mm_unpacklo_epi8(Current, Zero), _mm_unpackhi_epi8(Current, Zero) };
+
+        __m128i Blended[4];
+        for (u32 LaneIndex = 0; LaneIndex < 4; ++LaneIndex)
+        {
+            // NOTE(Traian): All channel values and weights fit in the low 16 bits of each 32-bit lane (with the high
+            // 16 bits being zero), so the 16-bit multiply-add and minimum instructions give the same results as
+            // 32-bit ones.
+            const __m128i Src = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(Sampled[LaneIndex], Tint), Rounding),
+                                               RENDERER_FIXED_WEIGHT_BITS);
+            const __m128i SrcA = _mm_shuffle_epi32(Src, 0xFF);
+            __m128i Sum = _mm_slli_epi32(_mm_min_epi16(Src, SrcA),
+                                         RENDERER_FIXED_WEIGHT_BITS - RENDERER_FIXED_CHANNEL_BITS);
+            if (!Span->IsOpaque)
+            {
+                const __m128i Dst = (LaneIndex % 2) ? _mm_unpackhi_epi16(Current16[LaneIndex / 2], Zero)
+                                                    : _mm_unpacklo_epi16(Current16[LaneIndex / 2], Zero);
+                const __m128i AlphaWeight = _mm_srli_epi32(
+                    _mm_add_epi32(_mm_madd_epi16(SrcA, AlphaToWeight), AlphaToWeightRounding),
+                    RENDERER_FIXED_ALPHA_TO_WEIGHT_BITS);
+                Sum = _mm_add_epi32(Sum, _mm_madd_epi16(Dst, _mm_sub_epi32(One, AlphaWeight)));
+            }
+            Blended[LaneIndex] = _mm_srli_epi32(_mm_add_epi32(Sum, Rounding), RENDERER_FIXED_WEIGHT_BITS);
+        }
+
+        const __m128i Blended16Lo = _mm_packs_epi32(Blended[0], Blended[1]);
+        const __m128i Blended16Hi = _mm_packs_epi32(Blended[2], Blended[3]);
+        _mm_storeu_si128(PixelsAddress, _mm_or_si128(_mm_packus_epi16(Blended16Lo, Blended16Hi), OpaqueAlpha));
+    }
+
+    Renderer_DrawTexturedSpanRangeFixed(Span, &Setup, PixelIndex);
+}
+
+PVZ_RENDERER_TARGET_AVX2 internal void
+Renderer_FillSpanAVX2(u32* Pixels, u32 PixelCount, color4 Color)
+{
+    u32 PixelIndex = 0;
+
+    if (Color.A == 1.0F)
+    {
+        const u32 PackedColor = LinearColor_PackToBGRA(Color4_ToLinear(Color4(Color.R, Color.G, Color.B)));
+        const __m256i PackedColor8x = _mm256_set1_epi32((int)PackedColor);
+        for (; PixelIndex + 8 <= PixelCount; PixelIndex += 8)
+        {
+            _mm256_storeu_si256((__m256i*)(Pixels + PixelIndex), PackedColor8x);
+        }
+        for (; PixelIndex < PixelCount; ++PixelIndex)
+        {
+            Pixels[PixelIndex] = PackedColor;
+        }
+        return;
+    }
+
+    const u32 Weight = Renderer_GetFillWeight(Color.A);
+    const __m256i InverseWeight = _mm256_set1_epi16((short)(256 - Weight));
+    const short SrcR = (short)((u32)(Color.R * 255.0F + 0.5F) * Weight);
+    const short SrcG = (short)((u32)(Color.G * 255.0F + 0.5F) * Weight);
+    const short SrcB = (short)((u32)(Color.B * 255.0F + 0.5F) * Weight);
+    const __m256i SrcColor = _mm256_setr_epi16(SrcB, SrcG, SrcR, 0, SrcB, SrcG, SrcR, 0,
+                                               SrcB, SrcG, SrcR, 0, SrcB, SrcG, SrcR, 0);
+    const __m256i OpaqueAlpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i Zero = _mm256_setzero_si256();
+
+    for (; PixelIndex + 8 <= PixelCount; PixelIndex += 8)
+    {
+        // NOTE(Traian): The unpack and pack instructions work independently on each 128-bit half, so the pixels end
+        // up in their original order.
+        const __m256i Packed = _mm256_loadu_si256((const __m256i*)(Pixels + PixelIndex));
+        const __m256i BlendedLo = _mm256_srli_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(Packed, Zero), InverseWeight), SrcColor), 8);
+        const __m256i BlendedHi = _mm256_srli_epi16(
+            _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(Packed, Zero), InverseWeight), SrcColor), 8);
+        _mm256_storeu_si256((__m256i*)(Pixels + PixelIndex),
+                            _mm256_or_si256(_mm256_packus_epi16(BlendedLo, BlendedHi), OpaqueAlpha));
+    }
+
+    _mm256_zeroupper();
+    Renderer_FillSpanRangeFixed(Pixels, PixelCount, Color, PixelIndex);
+}
+
+PVZ_RENDERER_TARGET_AVX2 internal inline __m256i
+Renderer_GetFixedWeightPairsAVX2(__m256i Weights)
+{
+    const __m256i Result = _mm256_or_si256(_mm256_sub_epi32(_mm256_set1_epi32(RENDERER_FIXED_ONE), Weights),
+                                           _mm256_slli_epi32(Weights, 16));
+    return Result;
+}
+
+PVZ_RENDERER_TARGET_AVX2 internal inline __m256i
+Renderer_LerpFixedAVX2(__m256i ValuesA, __m256i ValuesB, __m256i WeightPairs)
+{
+    const __m256i Values = _mm256_or_si256(ValuesA, _mm256_slli_epi32(ValuesB, 16));
+    const __m256i Result = _mm256_srli_epi32(_mm256_madd_epi16(Values, WeightPairs), RENDERER_FIXED_WEIGHT_BITS);
+    return Result;
+}
+
+PVZ_RENDERER_TARGET_AVX2 internal inline __m256i
+Renderer_LerpTexelColumnAVX2(__m256i InterleavedTexels, __m256i WeightPairsY)
+{
+    const __m256i Result = _mm256_srli_epi32(_mm256_madd_epi16(InterleavedTexels, WeightPairsY),
+                                             RENDERER_FIXED_WEIGHT_BITS - RENDERER_FIXED_CHANNEL_BITS);
+    return Result;
+}
+
+// NOTE(Traian): As the unpack instructions work independently on each 128-bit half, the first vector holds the pixels
+// 0 and 4, the second one the pixels 1 and 5, and so on.
+PVZ_RENDERER_TARGET_AVX2 internal inline void
+Renderer_SampleBilinearFixedAVX2(const renderer_fixed_texel_rows* Rows, __m256 U, __m256i* OutPixels)
+{
+    const __m256 SizeX = _mm256_set1_ps(Rows->SizeX);
+    const __m256 MaxTexelX = _mm256_set1_ps(Rows->MaxTexelX);
+    const __m256i Tex1X = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_mul_ps(U, SizeX), MaxTexelX));
+    const __m256 Tex1XFloat = _mm256_cvtepi32_ps(Tex1X);
+    const __m256 TX = _mm256_sub_ps(U, _mm256_div_ps(Tex1XFloat, SizeX));
+    const __m256i WeightX = _mm256_cvttps_epi32(
+        _mm256_add_ps(_mm256_mul_ps(TX, _mm256_set1_ps((f32)RENDERER_FIXED_ONE)), _mm256_set1_ps(0.5F)));
+    const __m256i WeightPairsX = Renderer_GetFixedWeightPairsAVX2(WeightX);
+    const __m256i WeightPairsY = Renderer_GetFixedWeightPairsAVX2(_mm256_set1_epi32((int)Rows->WeightY));
+
+    // NOTE(Traian): The column offsets are 'X + 3 * (X & TileMask)', which is just 'X' for linear mips.
+    const __m256i TileMask = _mm256_set1_epi32((int)Rows->TileMask);
+    const __m256i TileScale = _mm256_set1_epi32(RENDERER_IMAGE_TILE_SIZE - 1);
+    const __m256i Tex2X = _mm256_add_epi32(Tex1X, _mm256_set1_epi32(1));
+    const __m256i LeftColumns = _mm256_add_epi32(Tex1X,
+                                                 _mm256_mullo_epi32(_mm256_and_si256(Tex1X, TileMask), TileScale));
+    const __m256i RightColumns = _mm256_add_epi32(Tex2X,
+                                                  _mm256_mullo_epi32(_mm256_and_si256(Tex2X, TileMask), TileScale));
+
+    const int* BottomRow = (const int*)Rows->BottomRow;
+    const int* TopRow = (const int*)Rows->TopRow;
+    const __m256i Texels1 = _mm256_i32gather_epi32(BottomRow, LeftColumns, 4);
+    const __m256i Texels2 = _mm256_i32gather_epi32(BottomRow, RightColumns, 4);
+    const __m256i Texels3 = _mm256_i32gather_epi32(TopRow, LeftColumns, 4);
+    const __m256i Texels4 = _mm256_i32gather_epi32(TopRow, RightColumns, 4);
+
+    const __m256i Zero = _mm256_setzero_si256();
+    const __m256i LeftTexels[2] = { _mm256_unpacklo_epi8(Texels1, Texels3), _mm256_unpackhi_epi8(Texels1, Texels3) };
+    const __m256i RightTexels[2] = { _mm256_unpacklo_epi8(Texels2, Texels4), _mm256_unpackhi_epi8(Texels2, Texels4) };
+    for (u32 LaneIndex = 0; LaneIndex < 4; ++LaneIndex)
+    {
+        const __m256i LeftPair = LeftTexels[LaneIndex / 2];
+        const __m256i RightPair = RightTexels[LaneIndex / 2];
+        const __m256i Left = Renderer_LerpTexelColumnAVX2(
+            (LaneIndex % 2) ? _mm256_unpackhi_epi8(LeftPair, Zero) : _mm256_unpacklo_epi8(LeftPair, Zero),
+            WeightPairsY);
+        const __m256i Right = Renderer_LerpTexelColumnAVX2(
+            (LaneIndex % 2) ? _mm256_unpackhi_epi8(RightPair, Zero) : _mm256_unpacklo_epi8(RightPair, Zero),
+            WeightPairsY);
+
+        __m256i LaneWeightPairs;
+        switch (LaneIndex)
+        {
+            case 0: LaneWeightPairs = _mm256_shuffle_epi32(WeightPairsX, 0x00); break;
+            case 1: LaneWeightPairs = _mm256_shuffle_epi32(WeightPairsX, 0x55); break;
+            case 2: LaneWeightPairs = _mm256_shuffle_epi32(WeightPairsX, 0xAA); break;
+            default: LaneWeightPairs = _mm256_shuffle_epi32(WeightPairsX, 0xFF); break;
+        }
+        OutPixels[LaneIndex] = Renderer_LerpFixedAVX2(Left, Right, LaneWeightPairs);
+    }
+}
+
+PVZ_RENDERER_TARGET_AVX2 internal void
+Renderer_DrawTexturedSpanAVX2(const renderer_textured_span* Span)
+{
+    if (!Renderer_CanDrawTexturedSpanFixed(Span))
+    {
+        Renderer_DrawTexturedSpanScalar(Span);
+        return;
+    }
+
+    const renderer_fixed_span_setup Setup = Renderer_GetFixedSpanSetup(Span);
+    const __m256 LaneOffsets = _mm256_setr_ps(0.0F, 1.0F, 2.0F, 3.0F, 4.0F, 5.0F, 6.0F, 7.0F);
+    const __m256 FirstU = _mm256_set1_ps(Span->U);
+    const __m256 DeltaU = _mm256_set1_ps(Span->DeltaU);
+    const __m256i WeightPairsAB = Renderer_GetFixedWeightPairsAVX2(_mm256_set1_epi32((int)Setup.WeightAB));
+    const __m256i Tint = _mm256_setr_epi32((int)Setup.Tint[0], (int)Setup.Tint[1], (int)Setup.Tint[2],
+                                           (int)Setup.Tint[3], (int)Setup.Tint[0], (int)Setup.Tint[1],
+                                           (int)Setup.Tint[2], (int)Setup.Tint[3]);
+    const __m256i Rounding = _mm256_set1_epi32(1 << (RENDERER_FIXED_WEIGHT_BITS - 1));
+    const __m256i AlphaToWeight = _mm256_set1_epi32(RENDERER_FIXED_ALPHA_TO_WEIGHT);
+    const __m256i AlphaToWeightRounding = _mm256_set1_epi32(1 << (RENDERER_FIXED_ALPHA_TO_WEIGHT_BITS - 1));
+    const __m256i One = _mm256_set1_epi32(RENDERER_FIXED_ONE);
+    const __m256i OpaqueAlpha = _mm256_set1_epi32((int)0xFF000000);
+    const __m256i Zero = _mm256_setzero_si256();
+
+    u32 PixelIndex = 0;
+    for (; PixelIndex + 8 <= Span->PixelCount; PixelIndex += 8)
+    {
+        const __m256 PixelIndices = _mm256_add_ps(_mm256_set1_ps((f32)(Span->FirstStepIndex + PixelIndex)),
+                                                  LaneOffsets);
+        const __m256 U = _mm256_add_ps(FirstU, _mm256_mul_ps(PixelIndices, DeltaU));
+
+        __m256i Sampled[4];
+        Renderer_SampleBilinearFixedAVX2(&Setup.RowsA, U, Sampled);
+        if (Span->BlendBetweenMips)
+        {
+            __m256i SampledB[4];
+            Renderer_SampleBilinearFixedAVX2(&Setup.RowsB, U, SampledB);
+            for (u32 LaneIndex = 0; LaneIndex < 4; ++LaneIndex)
+            {
+                Sampled[LaneIndex] = Renderer_LerpFixedAVX2(Sampled[LaneIndex], SampledB[LaneIndex], WeightPairsAB);
+            }
+        }
+
+        // NOTE(Traian): The destination pixels are unpacked in the same (per 128-bit half) order as the samples, and
+        // the pack instructions restore the original order.
+        __m256i* PixelsAddress = (__m256i*)(Span->Pixels + PixelIndex);
+        const __m256i Current = Span->IsOpaque ? Zero : _mm256_loadu_si256(PixelsAddress);
+        const __m256i Current16[2] = { _mm256_unpacklo_epi8(Current, Zero), _mm256_unpackhi_epi8(Current, Zero) };
+
+        __m256i Blended[4];
+        for (u32 LaneIndex = 0; LaneIndex < 4; ++LaneIndex)
+        {
+            const __m256i Src = _mm256_srli_epi32(
+                _mm256_add_epi32(_mm256_madd_epi16(Sampled[LaneIndex], Tint), Rounding), RENDERER_FIXED_WEIGHT_BITS);
+            const __m256i SrcA = _mm256_shuffle_epi32(Src, 0xFF);
+            __m256i Sum = _mm256_slli_epi32(_mm256_min_epi32(Src, SrcA),
+                                            RENDERER_FIXED_WEIGHT_BITS - RENDERER_FIXED_CHANNEL_BITS);
+            if (!Span->IsOpaque)
+            {
+                const __m256i Dst = (LaneIndex % 2) ? _mm256_unpackhi_epi16(Current16[LaneIndex / 2], Zero)
+                                                    : _mm256_unpacklo_epi16(Current16[LaneIndex / 2], Zero);
+                const __m256i AlphaWeight = _mm256_srli_epi32(
+                    _mm256_add_epi32(_mm256_madd_epi16(SrcA, AlphaToWeight), AlphaToWeightRounding),
+                    RENDERER_FIXED_ALPHA_TO_WEIGHT_BITS);
+                Sum = _mm256_add_epi32(Sum, _mm256_madd_epi16(Dst, _mm256_sub_epi32(One, AlphaWeight)));
+            }
+            Blended[LaneIndex] = _mm256_srli_epi32(_mm256_add_epi32(Sum, Rounding), RENDERER_FIXED_WEIGHT_BITS);
+        }
+
+        const __m256i Blended16Lo = _mm256_packs_epi32(Blended[0], Blended[1]);
+        const __m256i Blended16Hi = _mm256_packs_epi32(Blended[2], Blended[3]);
+        _mm256_storeu_si256(PixelsAddress, _mm256_or_si256(_mm256_packus_epi16(Blended16Lo, Blended16Hi), OpaqueAlpha));
+    }
+
+    // NOTE(Traian): The remaining pixels are processed by non-AVX code, which runs considerably slower while the upper
+    // halves of the YMM registers are dirty (and the compiler doesn't always clear them before the call).
+    _mm256_zeroupper();
+    Renderer_DrawTexturedSpanRangeFixed(Span, &Setup, PixelIndex);
+}
+
+internal b8
+Renderer_IsAVX2Supported()
+{
+    // NOTE(Traian): Besides the CPU supporting the instructions, the OS must also save the YMM registers when
+    // switching contexts (which is reported through the OSXSAVE bit and the XCR0 register).
+#if defined(_MSC_VER)
+    int CPUInfo[4] = {};
+    __cpuid(CPUInfo, 0);
+    const u32 MaxFunctionID = (u32)CPUInfo[0];
+    if (MaxFunctionID < 7)
+    {
+        return false;
+    }
+
+    __cpuid(CPUInfo, 1);
+    const u32 FeaturesECX = (u32)CPUInfo[2];
+    if (!(FeaturesECX & (1 << 27)) || !(FeaturesECX & (1 << 28)))
+    {
+        return false;
+    }
+
+    const u64 XCR0 = _xgetbv(0);
+    if ((XCR0 & 0x06) != 0x06)
+    {
+        return false;
+    }
+
+    __cpuidex(CPUInfo, 7, 0);
+    const u32 ExtendedFeaturesEBX = (u32)CPUInfo[1];
+#else
+    u32 EAX, EBX, ECX, EDX;
+    if (__get_cpuid_max(0, NULL) < 7)
+    {
+        return false;
+    }
+
+    __cpuid(1, EAX, EBX, ECX, EDX);
+    const u32 FeaturesECX = ECX;
+    if (!(FeaturesECX & (1 << 27)) || !(FeaturesECX & (1 << 28)))
+    {
+        return false;
+    }
+
+    u32 XCR0Low, XCR0High;
+    __asm__ volatile("xgetbv" : "=a"(XCR0Low), "=d"(XCR0High) : "c"(0));
+    if ((XCR0Low & 0x06) != 0x06)
+    {
+        return false;
+    }
+
+    __cpuid_count(7, 0, EAX, EBX, ECX, EDX);
+    const u32 ExtendedFeaturesEBX = EBX;
+#endif // defined(_MSC_VER)
+
+    const b8 Result = (ExtendedFeaturesEBX & (1 << 5)) != 0;
+    return Result;
+}
+
+#endif // PVZ_RENDERER_X64
+
+internal void
+Renderer_SelectSpanKernels(renderer_span_kernels* Kernels)
+{
+    ZERO_STRUCT_POINTER(Kernels);
+    Kernels->TexturedSpanWidth = 1;
+
+#if defined(PVZ_RENDERER_REFERENCE_KERNELS)
+    Kernels->FillSpan = Renderer_FillSpanScalar;
+    Kernels->TexturedSpan = Renderer_DrawTexturedSpanScalar;
+#else
+    Kernels->FillSpan = Renderer_FillSpanFixed;
+    Kernels->TexturedSpan = Renderer_DrawTexturedSpanFixed;
+
+#if PVZ_RENDERER_X64
+    // NOTE(Traian): SSE2 is part of the x64 baseline, so it is always available.
+    Kernels->FillSpan = Renderer_FillSpanSSE2;
+    Kernels->TexturedSpan = Renderer_DrawTexturedSpanSSE2;
+    Kernels->TexturedSpanWidth = 4;
+
+    if (Renderer_IsAVX2Supported())
+    {
+        Kernels->FillSpan = Renderer_FillSpanAVX2;
+        Kernels->TexturedSpan = Renderer_DrawTexturedSpanAVX2;
+        Kernels->TexturedSpanWidth = 8;
+    }
+#endif // PVZ_RENDERER_X64
+#endif // defined(PVZ_RENDERER_REFERENCE_KERNELS)
+}
+
+//
+// NOTE(Traian): The kernel verification runs random spans through the reference kernels and through every fixed-point
+// kernel table the CPU supports, starting from the same destination pixels, and measures how far apart the outputs
+// are. The textures are random premultiplied B8G8R8A8 mips (including fully transparent and fully opaque texels), and
+// the spans cover both the SIMD widths and the leftover pixels processed one by one.
+//
+
+#define RENDERER_VERIFY_MAX_TEXTURE_SIZE    (64)
+#define RENDERER_VERIFY_MAX_SPAN_PIXELS     (40)
+#define RENDERER_VERIFY_MAX_KERNEL_TABLES   (3)
+
+internal u32
+Renderer_GetFixedSpanKernelTables(renderer_span_kernels* Tables)
+{
+    u32 TableCount = 0;
+    Tables[TableCount++] = { Renderer_FillSpanFixed, Renderer_DrawTexturedSpanFixed, 1 };
+#if PVZ_RENDERER_X64
+    Tables[TableCount++] = { Renderer_FillSpanSSE2, Renderer_DrawTexturedSpanSSE2, 4 };
+    if (Renderer_IsAVX2Supported())
+    {
+        Tables[TableCount++] = { Renderer_FillSpanAVX2, Renderer_DrawTexturedSpanAVX2, 8 };
+    }
+#endif // PVZ_RENDERER_X64
+    ASSERT(TableCount <= RENDERER_VERIFY_MAX_KERNEL_TABLES);
+    return TableCount;
+}
+
+internal void
+Renderer_CreateRandomVerifyMip(renderer_image* Mip, memory_arena* Arena, random_series* Series, u32 SizeX, u32 SizeY)
+{
+    Image_AllocatePaddedFromArena(Mip, Arena, RENDERER_IMAGE_FORMAT_B8G8R8A8, SizeX, SizeY);
+    Mip->IsAlphaPremultiplied = true;
+
+    for (u32 PixelIndexY = 0; PixelIndexY < SizeY; ++PixelIndexY)
+    {
+        u32* Row = (u32*)Mip->PixelBuffer + ((memory_size)PixelIndexY * Mip->Stride);
+        for (u32 PixelIndexX = 0; PixelIndexX < SizeX; ++PixelIndexX)
+        {
+            // NOTE(Traian): Sprites are mostly made of fully transparent and fully opaque texels.
+            u32 Alpha;
+            switch (Random_RangeU32(Series, 0, 3))
+            {
+                case 0:  Alpha = 0; break;
+                case 1:  Alpha = 255; break;
+                default: Alpha = Random_RangeU32(Series, 0, 255); break;
+            }
+            const u32 Red = Random_RangeU32(Series, 0, Alpha);
+            const u32 Green = Random_RangeU32(Series, 0, Alpha);
+            const u32 Blue = Random_RangeU32(Series, 0, Alpha);
+            Row[PixelIndexX] = (Alpha << 24) | (Red << 16) | (Green << 8) | Blue;
+        }
+    }
+
+    Image_ReplicateBorder(Mip);
+}
+
+internal inline f32
+Renderer_GetRandomVerifyAlpha(random_series* Series)
+{
+    const f32 Result = (Random_RangeU32(Series, 0, 3) == 0) ? 1.0F : Random_NextF32(Series);
+    return Result;
+}
+
+internal void
+Renderer_FillRandomVerifyPixels(u32* Pixels, u32 PixelCount, random_series* Series)
+{
+    for (u32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
+    {
+        Pixels[PixelIndex] = 0xFF000000 | (Random_NextU32(Series) & 0x00FFFFFF);
+    }
+}
+
+internal u32
+Renderer_GetMaxChannelDifference(const u32* PixelsA, const u32* PixelsB, u32 PixelCount)
+{
+    u32 MaxDifference = 0;
+    for (u32 PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
+    {
+        for (u32 Shift = 0; Shift < 32; Shift += 8)
+        {
+            const s32 ChannelA = (s32)((PixelsA[PixelIndex] >> Shift) & 0xFF);
+            const s32 ChannelB = (s32)((PixelsB[PixelIndex] >> Shift) & 0xFF);
+            const u32 Difference = (u32)((ChannelA > ChannelB) ? (ChannelA - ChannelB) : (ChannelB - ChannelA));
+            if (Difference > MaxDifference) { MaxDifference = Difference; }
+        }
+    }
+    return MaxDifference;
+}
+
+// NOTE(Traian): The first fixed-point table is the scalar one, which the SIMD tables must match exactly.
+internal void
+Renderer_CompareFixedSpanKernelOutput(renderer_span_kernels_report* Report, u32* FixedPixels, const u32* Pixels,
+                                      u32 PixelCount, u32 TableIndex)
+{
+    if (TableIndex == 0)
+    {
+        CopyMemory(FixedPixels, Pixels, PixelCount * sizeof(u32));
+        return;
+    }
+
+    const u32 Difference = Renderer_GetMaxChannelDifference(FixedPixels, Pixels, PixelCount);
+    if (Difference > Report->MaxFixedTableDifference) { Report->MaxFixedTableDifference = Difference; }
+}
+
+function b8
+Renderer_VerifySpanKernels(renderer_span_kernels_report* Report, memory_arena* Arena, random_series* Series,
+                           u32 SpanCount)
+{
+    ZERO_STRUCT_POINTER(Report);
+
+    renderer_span_kernels Reference = {};
+    Reference.FillSpan = Renderer_FillSpanScalar;
+    Reference.TexturedSpan = Renderer_DrawTexturedSpanScalar;
+    Reference.TexturedSpanWidth = 1;
+
+    renderer_span_kernels Tables[RENDERER_VERIFY_MAX_KERNEL_TABLES];
+    Report->KernelTableCount = Renderer_GetFixedSpanKernelTables(Tables);
+    Report->SpanCount = SpanCount;
+
+    u32 SourcePixels[RENDERER_VERIFY_MAX_SPAN_PIXELS];
+    u32 ReferencePixels[RENDERER_VERIFY_MAX_SPAN_PIXELS];
+    u32 FixedPixels[RENDERER_VERIFY_MAX_SPAN_PIXELS];
+    u32 Pixels[RENDERER_VERIFY_MAX_SPAN_PIXELS];
+
+    for (u32 SpanIndex = 0; SpanIndex < SpanCount; ++SpanIndex)
+    {
+        memory_temporary_arena SpanArena = MemoryArena_BeginTemporary(Arena);
+        const u32 PixelCount = Random_RangeU32(Series, 1, RENDERER_VERIFY_MAX_SPAN_PIXELS);
+        Renderer_FillRandomVerifyPixels(SourcePixels, PixelCount, Series);
+
+        // NOTE(Traian): Fill the pixels with a random (straight alpha) color.
+        const color4 FillColor = Color4(Random_NextF32(Series), Random_NextF32(Series), Random_NextF32(Series),
+                                        Renderer_GetRandomVerifyAlpha(Series));
+        CopyMemory(ReferencePixels, SourcePixels, PixelCount * sizeof(u32));
+        Reference.FillSpan(ReferencePixels, PixelCount, FillColor);
+        for (u32 TableIndex = 0; TableIndex < Report->KernelTableCount; ++TableIndex)
+        {
+            CopyMemory(Pixels, SourcePixels, PixelCount * sizeof(u32));
+            Tables[TableIndex].FillSpan(Pixels, PixelCount, FillColor);
+            const u32 Difference = Renderer_GetMaxChannelDifference(ReferencePixels, Pixels, PixelCount);
+            if (Difference > Report->MaxFillDifference) { Report->MaxFillDifference = Difference; }
+            Renderer_CompareFixedSpanKernelOutput(Report, FixedPixels, Pixels, PixelCount, TableIndex);
+        }
+
+        // NOTE(Traian): Sample a random mip (or pair of mips) with a random premultiplied color. The coordinates of
+        // the last pixel must stay inside of the texture, just like the rasterizer guarantees.
+        renderer_image MipA;
+        renderer_image MipB;
+        const b8 BlendBetweenMips = (Random_RangeU32(Series, 0, 1) == 1);
+        const u32 MinSizeX = BlendBetweenMips ? 2 : 1;
+        const u32 SizeX = Random_RangeU32(Series, MinSizeX, RENDERER_VERIFY_MAX_TEXTURE_SIZE);
+        const u32 SizeY = Random_RangeU32(Series, MinSizeX, RENDERER_VERIFY_MAX_TEXTURE_SIZE);
+        Renderer_CreateRandomVerifyMip(&MipA, SpanArena.Arena, Series, SizeX, SizeY);
+        if (BlendBetweenMips)
+        {
+            Renderer_CreateRandomVerifyMip(&MipB, SpanArena.Arena, Series, SizeX / 2, SizeY / 2);
+        }
+
+        renderer_textured_span Span = {};
+        Span.PixelCount = PixelCount;
+        Span.FirstStepIndex = Random_RangeU32(Series, 0, 16);
+        Span.U = Random_RangeF32(Series, 0.0F, 0.99F);
+        Span.DeltaU = Random_RangeF32(Series, 0.0F, (0.99F - Span.U) / (f32)(Span.FirstStepIndex + PixelCount));
+        Span.V = Random_RangeF32(Series, 0.0F, 0.99F);
+        Span.Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
+        Span.IsAlphaPremultiplied = true;
+        Span.MipImageA = &MipA;
+        Span.MipImageB = BlendBetweenMips ? &MipB : NULL;
+        Span.BlendBetweenMips = BlendBetweenMips;
+        Span.InterpolationFactorAB = BlendBetweenMips ? Random_NextF32(Series) : 0.0F;
+        Span.Color = Color4(1.0F, 1.0F, 1.0F, 1.0F);
+        if (Random_RangeU32(Series, 0, 3) != 0)
+        {
+            Span.Color.A = Renderer_GetRandomVerifyAlpha(Series);
+            Span.Color.R = Random_NextF32(Series) * Span.Color.A;
+            Span.Color.G = Random_NextF32(Series) * Span.Color.A;
+            Span.Color.B = Random_NextF32(Series) * Span.Color.A;
+        }
+
+        Span.Pixels = ReferencePixels;
+        CopyMemory(ReferencePixels, SourcePixels, PixelCount * sizeof(u32));
+        Reference.TexturedSpan(&Span);
+        for (u32 TableIndex = 0; TableIndex < Report->KernelTableCount; ++TableIndex)
+        {
+            Span.Pixels = Pixels;
+            CopyMemory(Pixels, SourcePixels, PixelCount * sizeof(u32));
+            Tables[TableIndex].TexturedSpan(&Span);
+            const u32 Difference = Renderer_GetMaxChannelDifference(ReferencePixels, Pixels, PixelCount);
+            if (Difference > Report->MaxTexturedDifference) { Report->MaxTexturedDifference = Difference; }
+            Renderer_CompareFixedSpanKernelOutput(Report, FixedPixels, Pixels, PixelCount, TableIndex);
+        }
+
+        MemoryArena_EndTemporary(&SpanArena);
+    }
+
+    const b8 Result = (Report->MaxFillDifference <= RENDERER_MAX_SPAN_KERNEL_DIFFERENCE) &&
+                      (Report->MaxTexturedDifference <= RENDERER_MAX_SPAN_KERNEL_DIFFERENCE) &&
+                      (Report->MaxFixedTableDifference == 0);
+    return Result;
+}
+
+//====================================================================================================================//
+//----------------------------------------------------- RENDERER -----------------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): The viewport is partitioned into square clusters, whose size is chosen each frame based on the viewport
+// size and the number of threads: there should be enough clusters for every thread to pull several of them (so that
+// a few expensive clusters don't end up on the critical path), but not so many that the per-cluster overhead
+// (binning, sorting, dispatching) starts to dominate.
+//
+
+#define RENDERER_MAX_CLUSTER_SIZE               (512)
+#define RENDERER_MIN_CLUSTER_SIZE               (32)
+#define RENDERER_MIN_CLUSTER_COUNT_PER_THREAD   (4)
+
+function void
+Renderer_Initialize(renderer* Renderer, memory_arena* Arena)
+{
+    ZERO_STRUCT_POINTER(Renderer);
+    Renderer->MaxClusterCount = 1024;
+    Renderer->MaxPrimitiveCount = 8129;
+    Renderer->MaxBinChunkCount = 4096;
+    Renderer_SelectSpanKernels(&Renderer->SpanKernels);
+
+    Renderer->Clusters                  = PUSH_ARRAY(Arena, renderer_cluster,       Renderer->MaxClusterCount);
+    Renderer->ActiveClusterIndices      = PUSH_ARRAY(Arena, u32,                    Renderer->MaxClusterCount);
+    Renderer->ClusterOrderKeys          = PUSH_ARRAY(Arena, u64,                    Renderer->MaxClusterCount);
+    Renderer->ClusterOrderScratchKeys   = PUSH_ARRAY(Arena, u64,                    Renderer->MaxClusterCount);
+    Renderer->Primitives                = PUSH_ARRAY(Arena, renderer_primitive,     Renderer->MaxPrimitiveCount);
+    Renderer->BinChunks                 = PUSH_ARRAY(Arena, renderer_bin_chunk,     Renderer->MaxBinChunkCount);
+
+    renderer_primitive_setups* Setups = &Renderer->PrimitiveSetups;
+    Setups->FirstPixelIndexX            = PUSH_ARRAY(Arena, u32,                    Renderer->MaxPrimitiveCount);
+    Setups->EndPixelIndexX              = PUSH_ARRAY(Arena, u32,                    Renderer->MaxPrimitiveCount);
+    Setups->FirstPixelIndexY            = PUSH_ARRAY(Arena, u32,                    Renderer->MaxPrimitiveCount);
+    Setups->EndPixelIndexY              = PUSH_ARRAY(Arena, u32,                    Renderer->MaxPrimitiveCount);
+    Setups->Flags                       = PUSH_ARRAY(Arena, u8,                     Renderer->MaxPrimitiveCount);
+    Setups->Colors                      = PUSH_ARRAY(Arena, color4,                 Renderer->MaxPrimitiveCount);
+    Setups->FirstU                      = PUSH_ARRAY(Arena, f32,                    Renderer->MaxPrimitiveCount);
+    Setups->DeltaU                      = PUSH_ARRAY(Arena, f32,                    Renderer->MaxPrimitiveCount);
+    Setups->MinV                        = PUSH_ARRAY(Arena, f32,                    Renderer->MaxPrimitiveCount);
+    Setups->VPerSubPixel                = PUSH_ARRAY(Arena, f32,                    Renderer->MaxPrimitiveCount);
+    Setups->SubPixelMinY                = PUSH_ARRAY(Arena, s32,                    Renderer->MaxPrimitiveCount);
+    Setups->MipImagesA                  = PUSH_ARRAY(Arena, const renderer_image*,  Renderer->MaxPrimitiveCount);
+    Setups->MipImagesB                  = PUSH_ARRAY(Arena, const renderer_image*,  Renderer->MaxPrimitiveCount);
+    Setups->MipInterpolationFactors     = PUSH_ARRAY(Arena, f32,                    Renderer->MaxPrimitiveCount);
+
+    Renderer->GatheredPrimitiveIndices  = PUSH_ARRAY(Arena, u32,                    Renderer->MaxPrimitiveCount);
+    Renderer->IsPrimitiveGathered       = PUSH_ARRAY(Arena, b8,                     Renderer->MaxPrimitiveCount);
+
+    // NOTE(Traian): Each binned primitive needs a sort key and a scratch key. The clusters are given disjoint ranges
+    // of this buffer when they are dispatched.
+    const u32 MaxBinnedPrimitiveCount = Renderer->MaxBinChunkCount * RENDERER_BIN_CHUNK_CAPACITY;
+    Renderer->SortKeyBuffer = PUSH_ARRAY(Arena, u64, 2 * MaxBinnedPrimitiveCount);
+}
+
+internal inline u32
+Renderer_GetClusterCountForSize(u32 ViewportSize, u32 ClusterSize)
+{
+    const u32 Result = (ViewportSize + ClusterSize - 1) / ClusterSize;
+    return Result;
+}
+
+function void
+Renderer_BeginFrame(renderer* Renderer, u32 ViewportSizeX, u32 ViewportSizeY, u32 ThreadCount)
+{
+    Renderer->ViewportSizeX = ViewportSizeX;
+    Renderer->ViewportSizeY = ViewportSizeY;
+
+    //
+    // NOTE(Traian): Reset the renderer primitive buffer.
+    //
+
+    ZERO_STRUCT_ARRAY(Renderer->Primitives, Renderer->CurrentPrimitiveIndex);
+    Renderer->CurrentPrimitiveIndex = 0;
+
+    //
+    // NOTE(Traian): Determine the cluster size. Start with the largest clusters and halve them until there are enough
+    // of them for all threads, then make sure the cluster buffer can hold them all.
+    //
+
+    u32 ClusterSize = RENDERER_MAX_CLUSTER_SIZE;
+    while (ClusterSize > RENDERER_MIN_CLUSTER_SIZE)
+    {
+        const u32 ClusterCount = Renderer_GetClusterCountForSize(ViewportSizeX, ClusterSize) *
+                                 Renderer_GetClusterCountForSize(ViewportSizeY, ClusterSize);
+        if (ClusterCount >= RENDERER_MIN_CLUSTER_COUNT_PER_THREAD * ThreadCount)
+        {
+            break;
+        }
+        ClusterSize /= 2;
+    }
+
+    while (Renderer_GetClusterCountForSize(ViewportSizeX, ClusterSize) *
+           Renderer_GetClusterCountForSize(ViewportSizeY, ClusterSize) > Renderer->MaxClusterCount)
+    {
+        ClusterSize *= 2;
+    }
+
+    const u32 ClusterCountX = Renderer_GetClusterCountForSize(ViewportSizeX, ClusterSize);
+    const u32 ClusterCountY = Renderer_GetClusterCountForSize(ViewportSizeY, ClusterSize);
+    const b8 HasClusterGridChanged = (ClusterSize != Renderer->ClusterSize) ||
+                                     (ClusterCountX != Renderer->ClusterCountX) ||
+                                     (ClusterCountY != Renderer->ClusterCountY);
+
+    Renderer->ClusterSize = ClusterSize;
+    Renderer->ClusterCountX = ClusterCountX;
+    Renderer->ClusterCountY = ClusterCountY;
+    Renderer->ClusterCount = ClusterCountX * ClusterCountY;
+
+    //
+    // NOTE(Traian): Partition the viewport into the clusters and reset their primitive bins. The clusters on the last
+    // column (and row) are clipped to the viewport.
+    //
+
+    for (u32 ClusterIndexY = 0; ClusterIndexY < ClusterCountY; ++ClusterIndexY)
+    {
+        for (u32 ClusterIndexX = 0; ClusterIndexX < ClusterCountX; ++ClusterIndexX)
+        {
+            renderer_cluster* Cluster = Renderer->Clusters + (ClusterIndexY * ClusterCountX) + ClusterIndexX;
+            Cluster->DrawRegionOffsetX = ClusterIndexX * ClusterSize;
+            Cluster->DrawRegionOffsetY = ClusterIndexY * ClusterSize;
+            const u32 RemainingSizeX = ViewportSizeX - Cluster->DrawRegionOffsetX;
+            const u32 RemainingSizeY = ViewportSizeY - Cluster->DrawRegionOffsetY;
+            Cluster->DrawRegionSizeX = (RemainingSizeX < ClusterSize) ? RemainingSizeX : ClusterSize;
+            Cluster->DrawRegionSizeY = (RemainingSizeY < ClusterSize) ? RemainingSizeY : ClusterSize;
+
+            Cluster->PrimitiveCount = 0;
+            Cluster->FirstChunkIndex = 0;
+            Cluster->LastChunkIndex = 0;
+            Cluster->SortKeys = NULL;
+            Cluster->SortScratchKeys = NULL;
+            Cluster->ContentHash = 0;
+
+            if (HasClusterGridChanged)
+            {
+                // NOTE(Traian): The costs measured during the previous frame belong to a different partition.
+                Cluster->Cost = 0;
+            }
+        }
+    }
+
+    if (HasClusterGridChanged)
+    {
+        // NOTE(Traian): The previous content hashes describe the clusters of a different partition.
+        Renderer->HistoryPixelBuffer = NULL;
+    }
+
+    Renderer->CurrentBinChunkIndex = 0;
+    Renderer->ActiveClusterCount = 0;
+    Renderer->BackgroundLayer = NULL;
+}
+
+function void
+Renderer_EndFrame(renderer* Renderer)
+{
+}
+
+//
+// NOTE(Traian): The edges of each primitive are snapped to a 24.8 fixed-point grid (8 bits of sub-pixel precision)
+// when it is pushed, and all coverage decisions are made with integer math on that grid. A pixel is covered if its
+// center lies inside the primitive, following a top-left fill rule: a center exactly on the left or top edge is
+// covered, while a center exactly on the right or bottom edge is not. Primitives that share an edge snap it to the
+// same fixed-point value, so the pixels along that edge are drawn exactly once, regardless of the resolution.
+//
+
+#define RENDERER_SUBPIXEL_BITS      (8)
+#define RENDERER_SUBPIXEL_SCALE     (1 << RENDERER_SUBPIXEL_BITS)
+#define RENDERER_SUBPIXEL_HALF      (RENDERER_SUBPIXEL_SCALE / 2)
+
+internal inline s32
+Renderer_SnapToSubPixel(f32 NDCCoordinate, u32 ViewportSize)
+{
+    // NOTE(Traian): Primitives can extend far outside of the viewport. Limit the coordinate to a range that can't
+    // overflow the fixed-point representation (nor any of the computations made with it).
+    const f32 SUBPIXEL_LIMIT = (f32)(1 << 28);
+    const f32 SubPixel = Clamp(NDCCoordinate * (f32)ViewportSize * (f32)RENDERER_SUBPIXEL_SCALE,
+                               -SUBPIXEL_LIMIT, SUBPIXEL_LIMIT);
+
+    // NOTE(Traian): Round to the nearest grid point (the conversion truncates towards zero, so negative values must
+    // be corrected to round towards negative infinity instead).
+    s32 Result = (s32)(SubPixel + 0.5F);
+    if ((f32)Result > SubPixel + 0.5F)
+    {
+        --Result;
+    }
+    return Result;
+}
+
+internal inline void
+Renderer_GetCoveredPixelRange(s32 SubPixelMin, s32 SubPixelMax, u32 ViewportSize,
+                              u32* OutFirstPixelIndex, u32* OutEndPixelIndex)
+{
+    // NOTE(Traian): Pixel 'I' is covered if 'Min <= I * SCALE + HALF < Max', so the first covered pixel is the
+    // smallest 'I' that satisfies the left inequality and the end (one-past-last) pixel is the smallest 'I' that
+    // doesn't satisfy the right one. Clamping to the viewport first keeps the shifted values non-negative.
+    const s32 ViewportSubPixelSize = (s32)ViewportSize * RENDERER_SUBPIXEL_SCALE;
+    if (SubPixelMin < 0) { SubPixelMin = 0; }
+    if (SubPixelMax < 0) { SubPixelMax = 0; }
+    if (SubPixelMin > ViewportSubPixelSize) { SubPixelMin = ViewportSubPixelSize; }
+    if (SubPixelMax > ViewportSubPixelSize) { SubPixelMax = ViewportSubPixelSize; }
+
+    *OutFirstPixelIndex = (u32)((SubPixelMin + RENDERER_SUBPIXEL_HALF - 1) >> RENDERER_SUBPIXEL_BITS);
+    *OutEndPixelIndex = (u32)((SubPixelMax + RENDERER_SUBPIXEL_HALF - 1) >> RENDERER_SUBPIXEL_BITS);
+    if (*OutEndPixelIndex < *OutFirstPixelIndex)
+    {
+        *OutEndPixelIndex = *OutFirstPixelIndex;
+    }
+}
+
+internal inline u64
+Renderer_MixHash(u64 Hash, u64 Value)
+{
+    Hash ^= Value;
+    Hash *= 0xFF51AFD7ED558CCDULL;
+    Hash ^= Hash >> 32;
+    return Hash;
+}
+
+internal u64
+Renderer_GetPrimitiveContentHash(const renderer_primitive* Primitive)
+{
+    // NOTE(Traian): Everything that determines the pixels produced by the primitive. The index of the primitive changes
+    // from frame to frame even when the content doesn't, so it is not included. The pixels of a texture never change
+    // after it was created, so its address identifies them.
+    const f32 Values[] =
+    {
+        Primitive->MinPoint.X, Primitive->MinPoint.Y,
+        Primitive->MaxPoint.X, Primitive->MaxPoint.Y,
+        Primitive->ZOffset,
+        Primitive->Color.R, Primitive->Color.G, Primitive->Color.B, Primitive->Color.A,
+        Primitive->MinUV.X, Primitive->MinUV.Y,
+        Primitive->MaxUV.X, Primitive->MaxUV.Y,
+    };
+
+    u64 Result = Renderer_MixHash(0x9E3779B97F4A7C15ULL, (memory_index)Primitive->Texture);
+    for (u32 ValueIndex = 0; ValueIndex < sizeof(Values) / sizeof(Values[0]); ++ValueIndex)
+    {
+        // NOTE(Traian): Hash the bits of the value, so that the hash of a primitive only changes with its content.
+        u32 Word;
+        CopyMemory(&Word, Values + ValueIndex, sizeof(u32));
+        Result = Renderer_MixHash(Result, Word);
+    }
+    return Result;
+}
+
+internal void
+Renderer_BinPrimitive(renderer* Renderer, const renderer_primitive* Primitive)
+{
+    //
+    // NOTE(Traian): A primitive overlaps a cluster only if the pixels it covers overlap the cluster column on the
+    // X-axis and the cluster row on the Y-axis. The covered pixels are determined with the same fixed-point rules the
+    // rasterizer uses, so the set of clusters a primitive is binned into is exact. All clusters have the same size
+    // (except for the clipped ones on the last column and row), so the overlapped ones are found with a division.
+    //
+
+    u32 FirstPixelIndexX, EndPixelIndexX;
+    Renderer_GetCoveredPixelRange(Primitive->SubPixelMinX, Primitive->SubPixelMaxX, Renderer->ViewportSizeX,
+                                  &FirstPixelIndexX, &EndPixelIndexX);
+    u32 FirstPixelIndexY, EndPixelIndexY;
+    Renderer_GetCoveredPixelRange(Primitive->SubPixelMinY, Primitive->SubPixelMaxY, Renderer->ViewportSizeY,
+                                  &FirstPixelIndexY, &EndPixelIndexY);
+
+    if (FirstPixelIndexX >= EndPixelIndexX || FirstPixelIndexY >= EndPixelIndexY)
+    {
+        // NOTE(Traian): The primitive doesn't cover any pixel.
+        return;
+    }
+
+    const u32 FirstClusterIndexX = FirstPixelIndexX / Renderer->ClusterSize;
+    const u32 FirstClusterIndexY = FirstPixelIndexY / Renderer->ClusterSize;
+    const u32 LastClusterIndexX = (EndPixelIndexX - 1) / Renderer->ClusterSize;
+    const u32 LastClusterIndexY = (EndPixelIndexY - 1) / Renderer->ClusterSize;
+
+    // NOTE(Traian): The primitives are binned in the order they are pushed, which (together with the Z offsets) fully
+    // determines the order in which they are drawn. Chaining the hashes in bin order thus also captures the ordering.
+    u64 PrimitiveContentHash = 0;
+    if (Renderer->IsIncremental)
+    {
+        PrimitiveContentHash = Renderer_GetPrimitiveContentHash(Primitive);
+    }
+
+    for (u32 ClusterIndexY = FirstClusterIndexY; ClusterIndexY <= LastClusterIndexY; ++ClusterIndexY)
+    {
+        for (u32 ClusterIndexX = FirstClusterIndexX; ClusterIndexX <= LastClusterIndexX; ++ClusterIndexX)
+        {
+            renderer_cluster* Cluster = Renderer->Clusters + (ClusterIndexY * Renderer->ClusterCountX) + ClusterIndexX;
+
+            renderer_bin_chunk* Chunk = NULL;
+            if (Cluster->PrimitiveCount > 0)
+            {
+                Chunk = Renderer->BinChunks + Cluster->LastChunkIndex;
+            }
+
+            if (Chunk == NULL || Chunk->PrimitiveCount == RENDERER_BIN_CHUNK_CAPACITY)
+            {
+                if (Renderer->CurrentBinChunkIndex >= Renderer->MaxBinChunkCount)
+                {
+                    PANIC("Renderer cluster primitive buffer overflown!");
+                }
+
+                const u32 NewChunkIndex = Renderer->CurrentBinChunkIndex++;
+                renderer_bin_chunk* NewChunk = Renderer->BinChunks + NewChunkIndex;
+                NewChunk->NextChunkIndex = 0;
+                NewChunk->PrimitiveCount = 0;
+
+                if (Chunk == NULL)
+                {
+                    Cluster->FirstChunkIndex = NewChunkIndex;
+                }
+                else
+                {
+                    Chunk->NextChunkIndex = NewChunkIndex;
+                }
+
+                Cluster->LastChunkIndex = NewChunkIndex;
+                Chunk = NewChunk;
+            }
+
+            Chunk->PrimitiveIndices[Chunk->PrimitiveCount++] = Primitive->Index;
+            Cluster->PrimitiveCount++;
+            Cluster->ContentHash = Renderer_MixHash(Cluster->ContentHash, PrimitiveContentHash);
+        }
+    }
+}
+
+function void
+Renderer_PushPrimitive(renderer* Renderer, vec2 MinPoint, vec2 MaxPoint, f32 ZOffset, color4 Color,
+                       vec2 MinUV /*= {}*/, vec2 MaxUV /*= {}*/, const renderer_texture* Texture /*= NULL*/)
+{
+    if (Renderer->CurrentPrimitiveIndex >= Renderer->MaxPrimitiveCount)
+    {
+        PANIC("Renderer primitive buffer overflown!");
+    }
+
+    renderer_primitive* Primitive = Renderer->Primitives + Renderer->CurrentPrimitiveIndex;
+    Primitive->Index = Renderer->CurrentPrimitiveIndex;
+    Primitive->MinPoint = MinPoint;
+    Primitive->MaxPoint = MaxPoint;
+    Primitive->ZOffset = ZOffset;
+    Primitive->Color = Color;
+    Primitive->MinUV = MinUV;
+    Primitive->MaxUV = MaxUV;
+    Primitive->Texture = Texture;
+    Primitive->SubPixelMinX = Renderer_SnapToSubPixel(MinPoint.X, Renderer->ViewportSizeX);
+    Primitive->SubPixelMinY = Renderer_SnapToSubPixel(MinPoint.Y, Renderer->ViewportSizeY);
+    Primitive->SubPixelMaxX = Renderer_SnapToSubPixel(MaxPoint.X, Renderer->ViewportSizeX);
+    Primitive->SubPixelMaxY = Renderer_SnapToSubPixel(MaxPoint.Y, Renderer->ViewportSizeY);
+
+    Renderer_BinPrimitive(Renderer, Primitive);
+    Renderer->CurrentPrimitiveIndex++;
+}
+
+internal inline u64
+Renderer_GetPrimitiveSortKey(f32 ZOffset, u32 PrimitiveIndex)
+{
+    // NOTE(Traian): Negative zero compares equal to positive zero, so it must map to the same key bits.
+    if (ZOffset == 0.0F)
+    {
+        ZOffset = 0.0F;
+    }
+
+    // NOTE(Traian): Map the IEEE-754 bits of the Z offset to an unsigned integer that preserves the ordering of the
+    // floating point values. Positive values only get their sign bit set, while negative values get all bits flipped
+    // (so that larger magnitudes produce smaller keys).
+    u32 ZOffsetBits;
+    CopyMemory(&ZOffsetBits, &ZOffset, sizeof(u32));
+    const u32 SortableZOffsetBits = (ZOffsetBits & 0x80000000) ? ~ZOffsetBits : (ZOffsetBits | 0x80000000);
+
+    const u64 Result = ((u64)SortableZOffsetBits << 32) | (u64)PrimitiveIndex;
+    return Result;
+}
+
+internal u64*
+Renderer_SortKeys(u64* Keys, u64* ScratchKeys, u32 KeyCount)
+{
+    //
+    // NOTE(Traian): Least-significant-digit radix sort, using 8-bit digits. For primitives, the keys are sorted on the
+    // Z offset and then on the submission index, which is exactly the same ordering the primitives have always been
+    // drawn in. Only the 8-byte keys are moved around - the sorted items are addressed through the key low bits.
+    //
+
+    if (KeyCount == 0)
+    {
+        return Keys;
+    }
+
+    const u32 DIGIT_COUNT = sizeof(u64);
+    const u32 BUCKET_COUNT = 256;
+    u32 BucketOffsets[DIGIT_COUNT][BUCKET_COUNT] = {};
+
+    for (u32 KeyIndex = 0; KeyIndex < KeyCount; ++KeyIndex)
+    {
+        const u64 Key = Keys[KeyIndex];
+        for (u32 DigitIndex = 0; DigitIndex < DIGIT_COUNT; ++DigitIndex)
+        {
+            const u32 Digit = (u32)(Key >> (8 * DigitIndex)) & 0xFF;
+            BucketOffsets[DigitIndex][Digit]++;
+        }
+    }
+
+    u64* SrcKeys = Keys;
+    u64* DstKeys = ScratchKeys;
+
+    for (u32 DigitIndex = 0; DigitIndex < DIGIT_COUNT; ++DigitIndex)
+    {
+        u32* Buckets = BucketOffsets[DigitIndex];
+
+        // NOTE(Traian): If all keys share the same digit, this pass wouldn't change the ordering. This is the common
+        // case for the high bytes of the submission index and of the Z offset, so skip the pass entirely.
+        const u32 FirstDigit = (u32)(SrcKeys[0] >> (8 * DigitIndex)) & 0xFF;
+        if (Buckets[FirstDigit] == KeyCount)
+        {
+            continue;
+        }
+
+        // NOTE(Traian): Convert the digit histogram to exclusive prefix sums.
+        u32 RunningOffset = 0;
+        for (u32 BucketIndex = 0; BucketIndex < BUCKET_COUNT; ++BucketIndex)
+        {
+            const u32 BucketCount = Buckets[BucketIndex];
+            Buckets[BucketIndex] = RunningOffset;
+            RunningOffset += BucketCount;
+        }
+
+        for (u32 KeyIndex = 0; KeyIndex < KeyCount; ++KeyIndex)
+        {
+            const u64 Key = SrcKeys[KeyIndex];
+            const u32 Digit = (u32)(Key >> (8 * DigitIndex)) & 0xFF;
+            DstKeys[Buckets[Digit]++] = Key;
+        }
+
+        u64* Temp = SrcKeys;
+        SrcKeys = DstKeys;
+        DstKeys = Temp;
+    }
+
+    return SrcKeys;
+}
+
+struct renderer_rasterization_area
+{
+    u32 PixelOffsetX;
+    u32 PixelOffsetY;
+    u32 PixelCountX;
+    u32 PixelCountY;
+    // NOTE(Traian): The first pixel on the X-axis covered by the primitive, before clipping it to the cluster.
+    u32 FirstCoveredPixelIndexX;
+};
+
+internal renderer_rasterization_area
+Renderer_GetRasterizationArea(const renderer* Renderer, const renderer_cluster* Cluster, u32 PrimitiveIndex)
+{
+    const renderer_primitive_setups* Setups = &Renderer->PrimitiveSetups;
+    u32 FirstPixelIndexX = Setups->FirstPixelIndexX[PrimitiveIndex];
+    u32 EndPixelIndexX = Setups->EndPixelIndexX[PrimitiveIndex];
+    u32 FirstPixelIndexY = Setups->FirstPixelIndexY[PrimitiveIndex];
+    u32 EndPixelIndexY = Setups->EndPixelIndexY[PrimitiveIndex];
+
+    const u32 FirstCoveredPixelIndexX = FirstPixelIndexX;
+
+    // NOTE(Traian): Clip the covered pixels to the draw region of the cluster. As clusters don't overlap and cover the
+    // whole viewport, each pixel of the primitive is rasterized by exactly one cluster.
+    const u32 ClusterEndX = Cluster->DrawRegionOffsetX + Cluster->DrawRegionSizeX;
+    const u32 ClusterEndY = Cluster->DrawRegionOffsetY + Cluster->DrawRegionSizeY;
+    if (FirstPixelIndexX < Cluster->DrawRegionOffsetX) { FirstPixelIndexX = Cluster->DrawRegionOffsetX; }
+    if (FirstPixelIndexY < Cluster->DrawRegionOffsetY) { FirstPixelIndexY = Cluster->DrawRegionOffsetY; }
+    if (EndPixelIndexX > ClusterEndX) { EndPixelIndexX = ClusterEndX; }
+    if (EndPixelIndexY > ClusterEndY) { EndPixelIndexY = ClusterEndY; }
+
+    renderer_rasterization_area RasterizationArea = {};
+    RasterizationArea.PixelOffsetX = FirstPixelIndexX;
+    RasterizationArea.PixelOffsetY = FirstPixelIndexY;
+    RasterizationArea.PixelCountX = (EndPixelIndexX > FirstPixelIndexX) ? (EndPixelIndexX - FirstPixelIndexX) : 0;
+    RasterizationArea.PixelCountY = (EndPixelIndexY > FirstPixelIndexY) ? (EndPixelIndexY - FirstPixelIndexY) : 0;
+    RasterizationArea.FirstCoveredPixelIndexX = FirstCoveredPixelIndexX;
+    return RasterizationArea;
+}
+
+// NOTE(Traian): Returns the number of rasterized pixels.
+internal u32
+Renderer_DrawFilledPrimitive(renderer* Renderer, renderer_image* RenderTarget, u32 PrimitiveIndex,
+                             renderer_rasterization_area RasterizationArea)
+{
+    const color4 Color = Renderer->PrimitiveSetups.Colors[PrimitiveIndex];
+
+    if (RenderTarget->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8)
+    {
+        u32* CurrentRowAddress = (u32*)Image_GetPixelAddress(RenderTarget,
+                                                             RasterizationArea.PixelOffsetX,
+                                                             RasterizationArea.PixelOffsetY);
+
+        for (u32 PixelIndexY = 0; PixelIndexY < RasterizationArea.PixelCountY; ++PixelIndexY)
+        {
+            // NOTE(Traian): Output the color to the render target buffer.
+            Renderer->SpanKernels.FillSpan(CurrentRowAddress, RasterizationArea.PixelCountX, Color);
+            CurrentRowAddress += RenderTarget->Stride;
+        }
+    }
+    else
+    {
+        // TODO(Traian): Eventually support more texture formats?
+        PANIC("Image with non supported fomat was used as render target!");
+    }
+
+    return RasterizationArea.PixelCountX * RasterizationArea.PixelCountY;
 }
 
 struct renderer_find_mip_levels_info
@@ -628,105 +2144,298 @@ struct renderer_find_mip_levels_result
     f32 InterpolationFactorAB;
 };
 
-internal inline renderer_find_mip_levels_result
-Renderer_FindMipLevels(const renderer_texture* Texture, renderer_find_mip_levels_info FindInfo)
+internal inline renderer_find_mip_levels_result
+Renderer_FindMipLevels(const renderer_texture* Texture, renderer_find_mip_levels_info FindInfo)
+{
+    const u32 PrimitivePixelCountX = (FindInfo.NDCPrimitiveSizeX * FindInfo.ViewportSizeX) + 1;
+    const u32 PrimitivePixelCountY = (FindInfo.NDCPrimitiveSizeY * FindInfo.ViewportSizeY) + 1;
+    const f32 UVDeltaX = FindInfo.UVDeltaX;
+    const f32 UVDeltaY = FindInfo.UVDeltaY;
+
+    u32 MipLevel;
+    b8 FoundMipLevel = false;
+
+    for (u32 MipIndex = 0; MipIndex < Texture->MipCount; ++MipIndex)
+    {
+        const renderer_image* MipImage = Texture->Mips + MipIndex;
+        if ((UVDeltaX * MipImage->SizeX) <= PrimitivePixelCountX && (UVDeltaY * MipImage->SizeY) <= PrimitivePixelCountY)
+        {
+            MipLevel = MipIndex;
+            FoundMipLevel = true;
+            break;
+        }
+    }
+
+    renderer_find_mip_levels_result Result = {};
+    if (FoundMipLevel)
+    {
+        if (MipLevel == 0)
+        {
+            // NOTE(Traian): We have to just "upsample" the first mip.
+            Result.BlendBetweenMips = false;
+            Result.MipLevelA = MipLevel;
+        }
+        else
+        {
+            // NOTE(Traian): We should blend between the current mip level and the previous mip level.
+            Result.BlendBetweenMips = true;
+            Result.MipLevelA = MipLevel;
+            Result.MipLevelB = MipLevel - 1;
+            const renderer_image* MipImageA = Texture->Mips + Result.MipLevelA;
+            const renderer_image* MipImageB = Texture->Mips + Result.MipLevelB;
+
+            if ((UVDeltaX * MipImageB->SizeX) > PrimitivePixelCountX && (UVDeltaY * MipImageB->SizeY) > PrimitivePixelCountY)
+            {
+                // NOTE(Traian): Determine the interpolation factor by calculating the interpolation factors on the
+                // X-axis (width) and Y-axis (height) and take their average value.
+                const f32 InterpolationFactorX = Math_InverseLerp(UVDeltaX * MipImageA->SizeX, UVDeltaX * MipImageB->SizeX,
+                                                                  PrimitivePixelCountX);
+                const f32 InterpolationFactorY = Math_InverseLerp(UVDeltaY * MipImageA->SizeY, UVDeltaY * MipImageB->SizeY,
+                                                                  PrimitivePixelCountY);
+                Result.InterpolationFactorAB = 0.5F * (InterpolationFactorX + InterpolationFactorY);
+            }
+            else if ((UVDeltaY * MipImageB->SizeX) > PrimitivePixelCountX)
+            {
+                // NOTE(Traian): Determine the interpolation factor based on the size on the X-axis (width).
+                Result.InterpolationFactorAB = Math_InverseLerp(UVDeltaX * MipImageA->SizeX, UVDeltaX * MipImageB->SizeX,
+                                                                PrimitivePixelCountX);
+            }
+            else if ((UVDeltaY * MipImageB->SizeY) > PrimitivePixelCountY)
+            {
+                // NOTE(Traian): Determine the interpolation factor based on the size on the Y-axis (height).
+                Result.InterpolationFactorAB = Math_InverseLerp(UVDeltaY * MipImageA->SizeY, UVDeltaY * MipImageB->SizeY,
+                                                                PrimitivePixelCountY);
+            }
+        }
+    }
+    else
+    {
+        // NOTE(Traian): We are forced to "downsample" the last mip - sad!
+        Result.BlendBetweenMips = false;
+        Result.MipLevelA = Texture->MipCount - 1;
+    }
+
+    return Result;
+}
+
+//
+// NOTE(Traian): The pixel ranges of a textured span that must be drawn, and the part of it that samples only fully
+// opaque texels (which is always inside of the visible range).
+//
+struct renderer_span_pixel_ranges
+{
+    u32 FirstVisiblePixelIndex;
+    u32 EndVisiblePixelIndex;
+    u32 FirstOpaquePixelIndex;
+    u32 EndOpaquePixelIndex;
+};
+
+internal inline u32
+Renderer_GetSpanTexelX(const renderer_textured_span* Span, const renderer_image* Image, u32 PixelIndex)
+{
+    // NOTE(Traian): Exactly the same computation the span kernels perform to find the left texel of the pixel.
+    const f32 U = Span->U + (f32)(Span->FirstStepIndex + PixelIndex) * Span->DeltaU;
+    u32 TexelX = (u32)(U * (f32)Image->SizeX);
+    if (TexelX >= Image->SizeX) { TexelX = Image->SizeX - 1; }
+    return TexelX;
+}
+
+// NOTE(Traian): Returns the first pixel of the span whose left texel is at (or after) the given column, or the pixel
+// count of the span if there is no such pixel. The pixel is estimated by inverting the texture coordinate mapping and
+// then corrected by walking along the span, which rarely takes more than a single step.
+internal u32
+Renderer_FindFirstPixelAtTexelX(const renderer_textured_span* Span, const renderer_image* Image, u32 TexelX)
+{
+    if (TexelX >= Image->SizeX)
+    {
+        return Span->PixelCount;
+    }
+
+    const f32 EstimatedStepIndex = (((f32)TexelX / (f32)Image->SizeX) - Span->U) / Span->DeltaU;
+    const f32 EstimatedPixelIndex = EstimatedStepIndex - (f32)Span->FirstStepIndex;
+    u32 PixelIndex = 0;
+    if (EstimatedPixelIndex >= (f32)Span->PixelCount)
+    {
+        PixelIndex = Span->PixelCount;
+    }
+    else if (EstimatedPixelIndex > 0.0F)
+    {
+        PixelIndex = (u32)EstimatedPixelIndex;
+    }
+
+    while (PixelIndex > 0 && Renderer_GetSpanTexelX(Span, Image, PixelIndex - 1) >= TexelX)
+    {
+        --PixelIndex;
+    }
+    while (PixelIndex < Span->PixelCount && Renderer_GetSpanTexelX(Span, Image, PixelIndex) < TexelX)
+    {
+        ++PixelIndex;
+    }
+    return PixelIndex;
+}
+
+internal renderer_span_pixel_ranges
+Renderer_GetSpanPixelRanges(const renderer_textured_span* Span, const renderer_image* Image)
+{
+    //
+    // NOTE(Traian): Each pixel samples two neighbouring texel columns from two neighbouring rows. The texel ranges of
+    // the two rows are merged first: the visible ranges are united and the opaque ones intersected. The pixel ranges
+    // are then widened (and the opaque one shrunk) by one pixel, so that a rounding difference in how a kernel computes
+    // the texture coordinates can never make a pixel be skipped or drawn as opaque by mistake.
+    //
+
+    u32 TexelY = (u32)(Span->V * (f32)Image->SizeY);
+    if (TexelY >= Image->SizeY) { TexelY = Image->SizeY - 1; }
+    const u32 NextTexelY = (TexelY + 1 < Image->SizeY) ? (TexelY + 1) : TexelY;
+    const renderer_image_row_span RowSpanA = Image->RowSpans[TexelY];
+    const renderer_image_row_span RowSpanB = Image->RowSpans[NextTexelY];
+
+    u32 MinX = RowSpanA.MinX;
+    u32 EndX = RowSpanA.EndX;
+    if (MinX >= EndX)
+    {
+        MinX = RowSpanB.MinX;
+        EndX = RowSpanB.EndX;
+    }
+    else if (RowSpanB.MinX < RowSpanB.EndX)
+    {
+        if (RowSpanB.MinX < MinX) { MinX = RowSpanB.MinX; }
+        if (RowSpanB.EndX > EndX) { EndX = RowSpanB.EndX; }
+    }
+
+    const u32 OpaqueMinX = (RowSpanA.OpaqueMinX > RowSpanB.OpaqueMinX) ? RowSpanA.OpaqueMinX : RowSpanB.OpaqueMinX;
+    const u32 OpaqueEndX = (RowSpanA.OpaqueEndX < RowSpanB.OpaqueEndX) ? RowSpanA.OpaqueEndX : RowSpanB.OpaqueEndX;
+
+    renderer_span_pixel_ranges Result = {};
+    if (MinX < EndX)
+    {
+        // NOTE(Traian): The pixel whose left texel is just before the range still samples its first texel.
+        Result.FirstVisiblePixelIndex = Renderer_FindFirstPixelAtTexelX(Span, Image, (MinX > 0) ? (MinX - 1) : 0);
+        Result.EndVisiblePixelIndex = Renderer_FindFirstPixelAtTexelX(Span, Image, EndX);
+        if (Result.FirstVisiblePixelIndex > 0) { --Result.FirstVisiblePixelIndex; }
+        if (Result.EndVisiblePixelIndex < Span->PixelCount) { ++Result.EndVisiblePixelIndex; }
+    }
+
+    Result.FirstOpaquePixelIndex = Result.EndVisiblePixelIndex;
+    Result.EndOpaquePixelIndex = Result.EndVisiblePixelIndex;
+    if (OpaqueMinX + 1 < OpaqueEndX)
+    {
+        // NOTE(Traian): The right texel of the pixel must be inside of the opaque range as well.
+        const u32 FirstOpaquePixelIndex = Renderer_FindFirstPixelAtTexelX(Span, Image, OpaqueMinX) + 1;
+        const u32 EndOpaquePixelIndex = Renderer_FindFirstPixelAtTexelX(Span, Image, OpaqueEndX - 1);
+        if (FirstOpaquePixelIndex + 1 < EndOpaquePixelIndex)
+        {
+            Result.FirstOpaquePixelIndex = FirstOpaquePixelIndex;
+            Result.EndOpaquePixelIndex = EndOpaquePixelIndex - 1;
+        }
+    }
+
+    return Result;
+}
+
+internal renderer_span_pixel_ranges
+Renderer_CombineSpanPixelRanges(renderer_span_pixel_ranges RangesA, renderer_span_pixel_ranges RangesB)
+{
+    renderer_span_pixel_ranges Result = {};
+    if (RangesA.FirstVisiblePixelIndex >= RangesA.EndVisiblePixelIndex)
+    {
+        Result.FirstVisiblePixelIndex = RangesB.FirstVisiblePixelIndex;
+        Result.EndVisiblePixelIndex = RangesB.EndVisiblePixelIndex;
+    }
+    else if (RangesB.FirstVisiblePixelIndex >= RangesB.EndVisiblePixelIndex)
+    {
+        Result.FirstVisiblePixelIndex = RangesA.FirstVisiblePixelIndex;
+        Result.EndVisiblePixelIndex = RangesA.EndVisiblePixelIndex;
+    }
+    else
+    {
+        Result.FirstVisiblePixelIndex = (RangesA.FirstVisiblePixelIndex < RangesB.FirstVisiblePixelIndex) ?
+                                        RangesA.FirstVisiblePixelIndex : RangesB.FirstVisiblePixelIndex;
+        Result.EndVisiblePixelIndex = (RangesA.EndVisiblePixelIndex > RangesB.EndVisiblePixelIndex) ?
+                                      RangesA.EndVisiblePixelIndex : RangesB.EndVisiblePixelIndex;
+    }
+
+    Result.FirstOpaquePixelIndex = (RangesA.FirstOpaquePixelIndex > RangesB.FirstOpaquePixelIndex) ?
+                                   RangesA.FirstOpaquePixelIndex : RangesB.FirstOpaquePixelIndex;
+    Result.EndOpaquePixelIndex = (RangesA.EndOpaquePixelIndex < RangesB.EndOpaquePixelIndex) ?
+                                 RangesA.EndOpaquePixelIndex : RangesB.EndOpaquePixelIndex;
+    if (Result.FirstOpaquePixelIndex >= Result.EndOpaquePixelIndex)
+    {
+        Result.FirstOpaquePixelIndex = Result.EndOpaquePixelIndex = Result.EndVisiblePixelIndex;
+    }
+    return Result;
+}
+
+internal void
+Renderer_AlignSpanPixelRanges(renderer_span_pixel_ranges* Ranges, u32 PixelCount, u32 Width)
 {
-    const u32 PrimitivePixelCountX = (FindInfo.NDCPrimitiveSizeX * FindInfo.ViewportSizeX) + 1;
-    const u32 PrimitivePixelCountY = (FindInfo.NDCPrimitiveSizeY * FindInfo.ViewportSizeY) + 1;
-    const f32 UVDeltaX = FindInfo.UVDeltaX;
-    const f32 UVDeltaY = FindInfo.UVDeltaY;
+    //
+    // NOTE(Traian): Splitting a span would leave each part with its own remainder of pixels that the kernel processes
+    // one by one. The visible range is thus widened and the opaque range shrunk, such that the parts before the end
+    // of the visible range are all multiples of the kernel width (drawing a few more transparent pixels, or blending
+    // a few more opaque ones, doesn't change the result).
+    //
 
-    u32 MipLevel;
-    b8 FoundMipLevel = false;
+    if (Ranges->FirstVisiblePixelIndex >= Ranges->EndVisiblePixelIndex)
+    {
+        return;
+    }
 
-    for (u32 MipIndex = 0; MipIndex < Texture->MipCount; ++MipIndex)
+    const u32 FirstPixelIndex = Ranges->FirstVisiblePixelIndex - (Ranges->FirstVisiblePixelIndex % Width);
+    const u32 VisiblePixelCount = Ranges->EndVisiblePixelIndex - FirstPixelIndex;
+    u32 EndPixelIndex = FirstPixelIndex + ((VisiblePixelCount + Width - 1) / Width) * Width;
+    if (EndPixelIndex > PixelCount)
     {
-        const renderer_image* MipImage = Texture->Mips + MipIndex;
-        if ((UVDeltaX * MipImage->SizeX) <= PrimitivePixelCountX && (UVDeltaY * MipImage->SizeY) <= PrimitivePixelCountY)
-        {
-            MipLevel = MipIndex;
-            FoundMipLevel = true;
-            break;
-        }
+        EndPixelIndex = PixelCount;
     }
 
-    renderer_find_mip_levels_result Result = {};
-    if (FoundMipLevel)
+    u32 FirstOpaquePixelIndex = EndPixelIndex;
+    u32 EndOpaquePixelIndex = EndPixelIndex;
+    if (Ranges->FirstOpaquePixelIndex < Ranges->EndOpaquePixelIndex)
     {
-        if (MipLevel == 0)
-        {
-            // NOTE(Traian): We have to just "upsample" the first mip.
-            Result.BlendBetweenMips = false;
-            Result.MipLevelA = MipLevel;
-        }
-        else
+        const u32 OpaqueOffset = Ranges->FirstOpaquePixelIndex - FirstPixelIndex;
+        const u32 OpaqueEndOffset = Ranges->EndOpaquePixelIndex - FirstPixelIndex;
+        const u32 AlignedOpaqueOffset = ((OpaqueOffset + Width - 1) / Width) * Width;
+        const u32 AlignedOpaqueEndOffset = (OpaqueEndOffset / Width) * Width;
+        if (AlignedOpaqueOffset < AlignedOpaqueEndOffset)
         {
-            // NOTE(Traian): We should blend between the current mip level and the previous mip level.
-            Result.BlendBetweenMips = true;
-            Result.MipLevelA = MipLevel;
-            Result.MipLevelB = MipLevel - 1;
-            const renderer_image* MipImageA = Texture->Mips + Result.MipLevelA;
-            const renderer_image* MipImageB = Texture->Mips + Result.MipLevelB;
-
-            if ((UVDeltaX * MipImageB->SizeX) > PrimitivePixelCountX && (UVDeltaY * MipImageB->SizeY) > PrimitivePixelCountY)
-            {
-                // NOTE(Traian): Determine the interpolation factor by calculating the interpolation factors on the
-                // X-axis (width) and Y-axis (height) and take their average value.
-                const f32 InterpolationFactorX = Math_InverseLerp(UVDeltaX * MipImageA->SizeX, UVDeltaX * MipImageB->SizeX,
-                                                                  PrimitivePixelCountX);
-                const f32 InterpolationFactorY = Math_InverseLerp(UVDeltaY * MipImageA->SizeY, UVDeltaY * MipImageB->SizeY,
-                                                                  PrimitivePixelCountY);
-                Result.InterpolationFactorAB = 0.5F * (InterpolationFactorX + InterpolationFactorY);
-            }
-            else if ((UVDeltaY * MipImageB->SizeX) > PrimitivePixelCountX)
-            {
-                // NOTE(Traian): Determine the interpolation factor based on the size on the X-axis (width).
-                Result.InterpolationFactorAB = Math_InverseLerp(UVDeltaX * MipImageA->SizeX, UVDeltaX * MipImageB->SizeX,
-                                                                PrimitivePixelCountX);
-            }
-            else if ((UVDeltaY * MipImageB->SizeY) > PrimitivePixelCountY)
-            {
-                // NOTE(Traian): Determine the interpolation factor based on the size on the Y-axis (height).
-                Result.InterpolationFactorAB = Math_InverseLerp(UVDeltaY * MipImageA->SizeY, UVDeltaY * MipImageB->SizeY,
-                                                                PrimitivePixelCountY);
-            }
+            FirstOpaquePixelIndex = FirstPixelIndex + AlignedOpaqueOffset;
+            EndOpaquePixelIndex = FirstPixelIndex + AlignedOpaqueEndOffset;
         }
     }
-    else
+
+    Ranges->FirstVisiblePixelIndex = FirstPixelIndex;
+    Ranges->EndVisiblePixelIndex = EndPixelIndex;
+    Ranges->FirstOpaquePixelIndex = FirstOpaquePixelIndex;
+    Ranges->EndOpaquePixelIndex = EndOpaquePixelIndex;
+}
+
+internal inline void
+Renderer_DrawTexturedSubSpan(renderer* Renderer, const renderer_textured_span* Span,
+                             u32 FirstPixelIndex, u32 EndPixelIndex, b8 IsOpaque)
+{
+    if (FirstPixelIndex >= EndPixelIndex)
     {
-        // NOTE(Traian): We are forced to "downsample" the last mip - sad!
-        Result.BlendBetweenMips = false;
-        Result.MipLevelA = Texture->MipCount - 1;
+        return;
     }
 
-    return Result;
+    // NOTE(Traian): Moving the first pixel and the first step index together keeps the texture coordinates of every
+    // pixel exactly the same.
+    renderer_textured_span SubSpan = *Span;
+    SubSpan.Pixels += FirstPixelIndex;
+    SubSpan.PixelCount = EndPixelIndex - FirstPixelIndex;
+    SubSpan.FirstStepIndex += FirstPixelIndex;
+    SubSpan.IsOpaque = IsOpaque;
+    Renderer->SpanKernels.TexturedSpan(&SubSpan);
 }
 
-internal void
-Renderer_DrawTexturedPrimitive(renderer* Renderer, renderer_image* RenderTarget, renderer_cluster* Cluster,
-                               u32 PrimitiveIndex, rect2D ClusterDrawRegion)
-{
-    const renderer_primitive* Primitive = Cluster->Primitives + PrimitiveIndex;
-    const rect2D PrimitiveRegion = Rect2D_Intersect({ Primitive->MinPoint, Primitive->MaxPoint }, ClusterDrawRegion);
-    const renderer_texture* PrimitiveTexture = Renderer->TextureSlots[Primitive->TextureSlotIndex];
-
-    renderer_rasterization_area RasterizationArea = Renderer_GetRasterizationArea(RenderTarget->SizeX,
-                                                                                  RenderTarget->SizeY,
-                                                                                  PrimitiveRegion);
-
-    renderer_find_mip_levels_info FindMipsInfo = {};
-    FindMipsInfo.NDCPrimitiveSizeX = Primitive->MaxPoint.X - Primitive->MinPoint.X;
-    FindMipsInfo.NDCPrimitiveSizeY = Primitive->MaxPoint.Y - Primitive->MinPoint.Y;
-    FindMipsInfo.ViewportSizeX = (f32)Renderer->ViewportSizeX;
-    FindMipsInfo.ViewportSizeY = (f32)Renderer->ViewportSizeY;
-    FindMipsInfo.UVDeltaX = Primitive->MaxUV.X - Primitive->MinUV.X;
-    FindMipsInfo.UVDeltaY = Primitive->MaxUV.Y - Primitive->MinUV.Y;
-    const renderer_find_mip_levels_result FindMipsResult = Renderer_FindMipLevels(PrimitiveTexture, FindMipsInfo);
-
-    const vec2 MinGeometricPrimitive = Vec2(Primitive->MinPoint.X * RenderTarget->SizeX,
-                                            Primitive->MinPoint.Y * RenderTarget->SizeY);
-    const vec2 MaxGeometricPrimitive = Vec2(Primitive->MaxPoint.X * RenderTarget->SizeX,
-                                            Primitive->MaxPoint.Y * RenderTarget->SizeY);
+// NOTE(Traian): Returns the number of rasterized pixels.
+internal u32
+Renderer_DrawTexturedPrimitive(renderer* Renderer, renderer_image* RenderTarget, u32 PrimitiveIndex,
+                               renderer_rasterization_area RasterizationArea)
+{
+    const renderer_primitive_setups* Setups = &Renderer->PrimitiveSetups;
+    const u8 Flags = Setups->Flags[PrimitiveIndex];
 
     if (RenderTarget->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8)
     {
@@ -734,182 +2443,655 @@ Renderer_DrawTexturedPrimitive(renderer* Renderer, renderer_image* RenderTarget,
                                                                RasterizationArea.PixelOffsetX,
                                                                RasterizationArea.PixelOffsetY);
 
+        // NOTE(Traian): The steps are always counted from the first covered pixel of the primitive (rather than from
+        // the first pixel of the cluster), so the result doesn't depend on how the viewport is partitioned.
+        const f32 MinV = Setups->MinV[PrimitiveIndex];
+        const f32 VPerSubPixel = Setups->VPerSubPixel[PrimitiveIndex];
+        const s32 SubPixelMinY = Setups->SubPixelMinY[PrimitiveIndex];
+
+        renderer_textured_span Span = {};
+        Span.PixelCount = RasterizationArea.PixelCountX;
+        Span.U = Setups->FirstU[PrimitiveIndex];
+        Span.FirstStepIndex = RasterizationArea.PixelOffsetX - RasterizationArea.FirstCoveredPixelIndexX;
+        Span.DeltaU = Setups->DeltaU[PrimitiveIndex];
+        Span.MipImageA = Setups->MipImagesA[PrimitiveIndex];
+        Span.MipImageB = Setups->MipImagesB[PrimitiveIndex];
+        Span.BlendBetweenMips = (Span.MipImageB != NULL);
+        Span.InterpolationFactorAB = Setups->MipInterpolationFactors[PrimitiveIndex];
+        Span.Format = Span.MipImageA->Format;
+        Span.IsAlphaPremultiplied = Span.MipImageA->IsAlphaPremultiplied;
+        Span.Color = Setups->Colors[PrimitiveIndex];
+
+        const b8 CanClipSpans = (Flags & RENDERER_PRIMITIVE_SETUP_FLAG_CLIP_SPANS) != 0;
+        const b8 CanSkipBlending = (Flags & RENDERER_PRIMITIVE_SETUP_FLAG_SKIP_BLENDING) != 0;
+
+        u32 DrawnPixelCount = 0;
         for (u32 PixelPositionY = RasterizationArea.PixelOffsetY;
              PixelPositionY < RasterizationArea.PixelOffsetY + RasterizationArea.PixelCountY;
              ++PixelPositionY)
         {
-            u32* CurrentPixelAddress = CurrentRowAddress;
-            for (u32 PixelPositionX = RasterizationArea.PixelOffsetX;
-                 PixelPositionX < RasterizationArea.PixelOffsetX + RasterizationArea.PixelCountX;
-                 ++PixelPositionX)
+            const s32 SubPixelCenterY = ((s32)PixelPositionY << RENDERER_SUBPIXEL_BITS) + RENDERER_SUBPIXEL_HALF;
+
+            Span.Pixels = CurrentRowAddress;
+            Span.V = MinV + (f32)(SubPixelCenterY - SubPixelMinY) * VPerSubPixel;
+
+            if (CanClipSpans)
             {
-                // NOTE(Traian): Unfortunately, this shenanigan is a caused by the error tolerance in the rasterization
-                // function (otherwise, an out-of-bounds texture read might occur) - no easy fix!
-                const f32 ERROR_TOLERANCE = 0.001F;
-                const f32 PercentageX = Math_InverseLerp(MinGeometricPrimitive.X, MaxGeometricPrimitive.X + ERROR_TOLERANCE,
-                                                         (f32)PixelPositionX + 0.5F);
-                const f32 PercentageY = Math_InverseLerp(MinGeometricPrimitive.Y, MaxGeometricPrimitive.Y + ERROR_TOLERANCE,
-                                                         (f32)PixelPositionY + 0.5F);
-
-                // NOTE(Traian): Calculate the UV coordinate of this fragment.
-                vec2 UV;
-                UV.X = Math_Lerp(Primitive->MinUV.X, Primitive->MaxUV.X, PercentageX);
-                UV.Y = Math_Lerp(Primitive->MinUV.Y, Primitive->MaxUV.Y, PercentageY);
-
-                // NOTE(Traian): Sample from the mips.
-                color4 SampledColor;
-                if (PrimitiveTexture->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8)
+                renderer_span_pixel_ranges Ranges = Renderer_GetSpanPixelRanges(&Span, Span.MipImageA);
+                if (Span.BlendBetweenMips)
                 {
-                    if (FindMipsResult.BlendBetweenMips)
-                    {
-                        const renderer_image* MipImageA = PrimitiveTexture->Mips + FindMipsResult.MipLevelA;
-                        const renderer_image* MipImageB = PrimitiveTexture->Mips + FindMipsResult.MipLevelB;
-                        const color4 SampledA = Image_SampleBilinearB8G8R8A8(MipImageA, UV);
-                        const color4 SampledB = Image_SampleBilinearB8G8R8A8(MipImageB, UV);
-                        SampledColor = Math_LerpColor4(SampledA, SampledB, FindMipsResult.InterpolationFactorAB);
-                    }
-                    else
-                    {
-                        const renderer_image* MipImage = PrimitiveTexture->Mips + FindMipsResult.MipLevelA;
-                        SampledColor = Image_SampleBilinearB8G8R8A8(MipImage, UV);
-                    }
-
-                    SampledColor.R *= Primitive->Color.R;
-                    SampledColor.G *= Primitive->Color.G;
-                    SampledColor.B *= Primitive->Color.B;
-                    SampledColor.A *= Primitive->Color.A;
+                    const renderer_span_pixel_ranges RangesB = Renderer_GetSpanPixelRanges(&Span, Span.MipImageB);
+                    Ranges = Renderer_CombineSpanPixelRanges(Ranges, RangesB);
                 }
-                else
+                if (!CanSkipBlending)
                 {
-                    f32 SampledAlpha;
-                    if (FindMipsResult.BlendBetweenMips)
-                    {
-                        const renderer_image* MipImageA = PrimitiveTexture->Mips + FindMipsResult.MipLevelA;
-                        const renderer_image* MipImageB = PrimitiveTexture->Mips + FindMipsResult.MipLevelB;
-                        const f32 SampledA = Image_SampleBilinearA8(MipImageA, UV);
-                        const f32 SampledB = Image_SampleBilinearA8(MipImageB, UV);
-                        SampledAlpha = Math_Lerp(SampledA, SampledB, FindMipsResult.InterpolationFactorAB);
-                    }
-                    else
-                    {
-                        const renderer_image* MipImage = PrimitiveTexture->Mips + FindMipsResult.MipLevelA;
-                        SampledAlpha = Image_SampleBilinearA8(MipImage, UV);
-                    }
-                    
-                    SampledColor = Primitive->Color;
-                    SampledColor.A *= SampledAlpha;
+                    Ranges.FirstOpaquePixelIndex = Ranges.EndOpaquePixelIndex = Ranges.EndVisiblePixelIndex;
                 }
-
-                // NOTE(Traian): Output the color to the render target buffer.
-                const color4 CurrentColor = Color4_FromLinear(LinearColor_UnpackFromBGRA(*CurrentPixelAddress));
-                const color4 BlendedColor = Color4(Math_Lerp(CurrentColor.R, SampledColor.R, SampledColor.A),
-                                                   Math_Lerp(CurrentColor.G, SampledColor.G, SampledColor.A),
-                                                   Math_Lerp(CurrentColor.B, SampledColor.B, SampledColor.A));
-
-                *CurrentPixelAddress = LinearColor_PackToBGRA(Color4_ToLinear(BlendedColor));
-                ++CurrentPixelAddress;
+                Renderer_AlignSpanPixelRanges(&Ranges, Span.PixelCount, Renderer->SpanKernels.TexturedSpanWidth);
+
+                Renderer_DrawTexturedSubSpan(Renderer, &Span, Ranges.FirstVisiblePixelIndex,
+                                             Ranges.FirstOpaquePixelIndex, false);
+                Renderer_DrawTexturedSubSpan(Renderer, &Span, Ranges.FirstOpaquePixelIndex,
+                                             Ranges.EndOpaquePixelIndex, true);
+                Renderer_DrawTexturedSubSpan(Renderer, &Span, Ranges.EndOpaquePixelIndex,
+                                             Ranges.EndVisiblePixelIndex, false);
+                DrawnPixelCount += Ranges.EndVisiblePixelIndex - Ranges.FirstVisiblePixelIndex;
+            }
+            else
+            {
+                Renderer->SpanKernels.TexturedSpan(&Span);
+                DrawnPixelCount += Span.PixelCount;
             }
-            CurrentRowAddress += RenderTarget->SizeX;
+
+            CurrentRowAddress += RenderTarget->Stride;
         }
+
+        return DrawnPixelCount;
     }
     else
     {
         // TODO(Traian): Eventually support more texture formats?
         PANIC("Image with non supported fomat was used as render target!");
     }
+
+    return 0;
+}
+
+//
+// NOTE(Traian): A primitive is opaque if the pixels it draws don't depend on the pixels below it. For filled primitives
+// that is an alpha of one, and for textured ones it also requires a fully opaque texture, whose premultiplied texels
+// are blended with an inverse alpha of exactly zero.
+//
+internal inline b8
+Renderer_IsPrimitiveOpaque(const renderer_primitive* Primitive)
+{
+    if (Primitive->Color.A != 1.0F)
+    {
+        return false;
+    }
+    if (Primitive->Texture == NULL)
+    {
+        return true;
+    }
+
+    const renderer_texture* Texture = Primitive->Texture;
+    const b8 Result = Texture->IsOpaque && Texture->IsAlphaPremultiplied &&
+                      (Texture->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8);
+    return Result;
+}
+
+//
+// NOTE(Traian): Computes everything needed to draw the primitive that doesn't depend on the cluster it is drawn in, so
+// that the clusters don't repeat it for each primitive they draw.
+//
+internal void
+Renderer_SetupPrimitive(renderer* Renderer, u32 PrimitiveIndex)
+{
+    const renderer_primitive* Primitive = Renderer->Primitives + PrimitiveIndex;
+    renderer_primitive_setups* Setups = &Renderer->PrimitiveSetups;
+
+    u32 FirstPixelIndexX, EndPixelIndexX;
+    Renderer_GetCoveredPixelRange(Primitive->SubPixelMinX, Primitive->SubPixelMaxX, Renderer->ViewportSizeX,
+                                  &FirstPixelIndexX, &EndPixelIndexX);
+    u32 FirstPixelIndexY, EndPixelIndexY;
+    Renderer_GetCoveredPixelRange(Primitive->SubPixelMinY, Primitive->SubPixelMaxY, Renderer->ViewportSizeY,
+                                  &FirstPixelIndexY, &EndPixelIndexY);
+    Setups->FirstPixelIndexX[PrimitiveIndex] = FirstPixelIndexX;
+    Setups->EndPixelIndexX[PrimitiveIndex] = EndPixelIndexX;
+    Setups->FirstPixelIndexY[PrimitiveIndex] = FirstPixelIndexY;
+    Setups->EndPixelIndexY[PrimitiveIndex] = EndPixelIndexY;
+
+    u8 Flags = RENDERER_PRIMITIVE_SETUP_FLAG_NONE;
+    if (Renderer_IsPrimitiveOpaque(Primitive))
+    {
+        Flags |= RENDERER_PRIMITIVE_SETUP_FLAG_OPAQUE;
+    }
+
+    color4 Color = Primitive->Color;
+    const renderer_texture* Texture = Primitive->Texture;
+    if (Texture != NULL)
+    {
+        Flags |= RENDERER_PRIMITIVE_SETUP_FLAG_TEXTURED;
+
+        renderer_find_mip_levels_info FindMipsInfo = {};
+        FindMipsInfo.NDCPrimitiveSizeX = Primitive->MaxPoint.X - Primitive->MinPoint.X;
+        FindMipsInfo.NDCPrimitiveSizeY = Primitive->MaxPoint.Y - Primitive->MinPoint.Y;
+        FindMipsInfo.ViewportSizeX = (f32)Renderer->ViewportSizeX;
+        FindMipsInfo.ViewportSizeY = (f32)Renderer->ViewportSizeY;
+        FindMipsInfo.UVDeltaX = Primitive->MaxUV.X - Primitive->MinUV.X;
+        FindMipsInfo.UVDeltaY = Primitive->MaxUV.Y - Primitive->MinUV.Y;
+        const renderer_find_mip_levels_result FindMipsResult = Renderer_FindMipLevels(Texture, FindMipsInfo);
+
+        const renderer_image* MipImageA = Texture->Mips + FindMipsResult.MipLevelA;
+        const renderer_image* MipImageB = FindMipsResult.BlendBetweenMips ? Texture->Mips + FindMipsResult.MipLevelB
+                                                                          : NULL;
+        Setups->MipImagesA[PrimitiveIndex] = MipImageA;
+        Setups->MipImagesB[PrimitiveIndex] = MipImageB;
+        Setups->MipInterpolationFactors[PrimitiveIndex] = FindMipsResult.InterpolationFactorAB;
+
+        //
+        // NOTE(Traian): The texture coordinates are interpolated from the fixed-point edges of the primitive. The
+        // distance (in sub-pixels) between a pixel center and the minimum edge is an exact integer, and the fill rules
+        // guarantee that it is always smaller than the size of the primitive, so the coordinates never leave the
+        // [MinUV, MaxUV) range. U varies linearly along a row, so it is computed only once for the first covered pixel
+        // and then stepped by a constant per-pixel delta inside the span kernel.
+        //
+
+        const f32 UVPerSubPixelX = (Primitive->MaxUV.X - Primitive->MinUV.X) /
+                                   (f32)(Primitive->SubPixelMaxX - Primitive->SubPixelMinX);
+        const f32 UVPerSubPixelY = (Primitive->MaxUV.Y - Primitive->MinUV.Y) /
+                                   (f32)(Primitive->SubPixelMaxY - Primitive->SubPixelMinY);
+        const s32 FirstSubPixelCenterX = ((s32)FirstPixelIndexX << RENDERER_SUBPIXEL_BITS) + RENDERER_SUBPIXEL_HALF;
+        const f32 DeltaU = (f32)RENDERER_SUBPIXEL_SCALE * UVPerSubPixelX;
+        Setups->FirstU[PrimitiveIndex] = Primitive->MinUV.X +
+                                         (f32)(FirstSubPixelCenterX - Primitive->SubPixelMinX) * UVPerSubPixelX;
+        Setups->DeltaU[PrimitiveIndex] = DeltaU;
+        Setups->MinV[PrimitiveIndex] = Primitive->MinUV.Y;
+        Setups->VPerSubPixel[PrimitiveIndex] = UVPerSubPixelY;
+        Setups->SubPixelMinY[PrimitiveIndex] = Primitive->SubPixelMinY;
+
+        if (Texture->IsAlphaPremultiplied)
+        {
+            // NOTE(Traian): Tinting a premultiplied texel by a straight color requires the color to be premultiplied.
+            Color.R *= Color.A;
+            Color.G *= Color.A;
+            Color.B *= Color.A;
+        }
+
+        //
+        // NOTE(Traian): When the mips describe their rows, each span is clipped to the pixels that sample texels which
+        // aren't fully transparent (a premultiplied transparent texel leaves the destination unchanged), and the pixels
+        // that sample only fully opaque texels are drawn without reading the destination. This requires the texture
+        // coordinates to increase along the span, so that the sampled texel columns are sorted.
+        //
+
+        const b8 CanClipSpans = Texture->IsAlphaPremultiplied && (Texture->Format == RENDERER_IMAGE_FORMAT_B8G8R8A8) &&
+                                (DeltaU > 0.0F) && (MipImageA->RowSpans != NULL) &&
+                                (MipImageB == NULL || MipImageB->RowSpans != NULL);
+        if (CanClipSpans)
+        {
+            Flags |= RENDERER_PRIMITIVE_SETUP_FLAG_CLIP_SPANS;
+            if (Color.A == 1.0F)
+            {
+                Flags |= RENDERER_PRIMITIVE_SETUP_FLAG_SKIP_BLENDING;
+            }
+        }
+    }
+
+    Setups->Flags[PrimitiveIndex] = Flags;
+    Setups->Colors[PrimitiveIndex] = Color;
+}
+
+// NOTE(Traian): Setting up a primitive is cheap, so each task sets up a batch of them.
+#define RENDERER_PRIMITIVE_SETUP_GRAIN (64)
+
+internal void
+Renderer_SetupPrimitiveRange(s32 LogicalThreadIndex, u32 FirstPrimitiveIndex, u32 EndPrimitiveIndex,
+                             void* OpaqueRenderer)
+{
+    renderer* Renderer = (renderer*)OpaqueRenderer;
+    for (u32 PrimitiveIndex = FirstPrimitiveIndex; PrimitiveIndex < EndPrimitiveIndex; ++PrimitiveIndex)
+    {
+        Renderer_SetupPrimitive(Renderer, PrimitiveIndex);
+    }
+}
+
+internal void
+Renderer_SetupGatheredPrimitiveRange(s32 LogicalThreadIndex, u32 FirstGatheredIndex, u32 EndGatheredIndex,
+                                     void* OpaqueRenderer)
+{
+    renderer* Renderer = (renderer*)OpaqueRenderer;
+    for (u32 GatheredIndex = FirstGatheredIndex; GatheredIndex < EndGatheredIndex; ++GatheredIndex)
+    {
+        Renderer_SetupPrimitive(Renderer, Renderer->GatheredPrimitiveIndices[GatheredIndex]);
+    }
+}
+
+// NOTE(Traian): Gathers each primitive that is binned to at least one of the active clusters exactly once.
+internal void
+Renderer_GatherActivePrimitives(renderer* Renderer)
+{
+    ZERO_STRUCT_ARRAY(Renderer->IsPrimitiveGathered, Renderer->CurrentPrimitiveIndex);
+    Renderer->GatheredPrimitiveCount = 0;
+
+    for (u32 OrderIndex = 0; OrderIndex < Renderer->ActiveClusterCount; ++OrderIndex)
+    {
+        const renderer_cluster* Cluster = Renderer->Clusters + Renderer->ActiveClusterIndices[OrderIndex];
+        u32 BinIndex = 0;
+        for (u32 ChunkIndex = Cluster->FirstChunkIndex; BinIndex < Cluster->PrimitiveCount;
+             ChunkIndex = Renderer->BinChunks[ChunkIndex].NextChunkIndex)
+        {
+            const renderer_bin_chunk* Chunk = Renderer->BinChunks + ChunkIndex;
+            for (u32 ChunkPrimitiveIndex = 0; ChunkPrimitiveIndex < Chunk->PrimitiveCount; ++ChunkPrimitiveIndex)
+            {
+                const u32 PrimitiveIndex = Chunk->PrimitiveIndices[ChunkPrimitiveIndex];
+                if (!Renderer->IsPrimitiveGathered[PrimitiveIndex])
+                {
+                    Renderer->IsPrimitiveGathered[PrimitiveIndex] = true;
+                    Renderer->GatheredPrimitiveIndices[Renderer->GatheredPrimitiveCount++] = PrimitiveIndex;
+                }
+            }
+            BinIndex += Chunk->PrimitiveCount;
+        }
+    }
 }
 
+//
+// NOTE(Traian): The cost of a cluster is estimated from the number of pixels it rasterized, where textured pixels are
+// considerably more expensive than filled ones, plus a fixed overhead per primitive (sorting, culling and
+// clipping, as the per-primitive setup is done before the clusters are dispatched).
+//
+
+#define RENDERER_FILLED_PIXEL_COST      (1)
+#define RENDERER_TEXTURED_PIXEL_COST    (4)
+#define RENDERER_PRIMITIVE_SETUP_COST   (64)
+// NOTE(Traian): Copying the background layer is a plain memory copy, so it is expressed per row of the cluster.
+#define RENDERER_LAYER_ROW_COPY_COST    (16)
+
 internal void
 Renderer_ExecuteCluster(renderer* Renderer, renderer_image* RenderTarget, u32 ClusterIndex)
 {
     renderer_cluster* Cluster = Renderer->Clusters + ClusterIndex;
 
     //
-    // NOTE(Traian): Push all primitives that intersect the cluster draw region to the primitives buffer.
+    // NOTE(Traian): Sort the cluster primitive bin.
+    //
+
+    u32 BinIndex = 0;
+    for (u32 ChunkIndex = Cluster->FirstChunkIndex; BinIndex < Cluster->PrimitiveCount;
+         ChunkIndex = Renderer->BinChunks[ChunkIndex].NextChunkIndex)
+    {
+        const renderer_bin_chunk* Chunk = Renderer->BinChunks + ChunkIndex;
+        for (u32 ChunkPrimitiveIndex = 0; ChunkPrimitiveIndex < Chunk->PrimitiveCount; ++ChunkPrimitiveIndex)
+        {
+            const u32 PrimitiveIndex = Chunk->PrimitiveIndices[ChunkPrimitiveIndex];
+            const renderer_primitive* Primitive = Renderer->Primitives + PrimitiveIndex;
+            Cluster->SortKeys[BinIndex++] = Renderer_GetPrimitiveSortKey(Primitive->ZOffset, PrimitiveIndex);
+        }
+    }
+
+    const u64* SortedKeys = Renderer_SortKeys(Cluster->SortKeys, Cluster->SortScratchKeys, Cluster->PrimitiveCount);
+
+    //
+    // NOTE(Traian): Walk the sorted primitives front-to-back and find the part of each one that isn't hidden by the
+    // opaque primitives drawn after it. The hidden pixels are tracked as a single covered interval per row (merging
+    // the opaque spans that touch it, or keeping the wider one when they don't), which is exact for the overlapping
+    // tiles and rectangles the game draws. Only the rows of a primitive between its first and last visible row are
+    // drawn, clipped to the visible X extents of those rows. The visible areas are stored (in cluster space) in the
+    // key buffer that isn't holding the sorted keys.
     //
 
-    rect2D ClusterDrawRegion;
-    const f32 InvViewportSizeX = 1.0F / (f32)Renderer->ViewportSizeX;
-    const f32 InvViewportSizeY = 1.0F / (f32)Renderer->ViewportSizeY;
-    ClusterDrawRegion.Min.X = (f32)Cluster->DrawRegionOffsetX * InvViewportSizeX;
-    ClusterDrawRegion.Min.Y = (f32)Cluster->DrawRegionOffsetY * InvViewportSizeY;
-    ClusterDrawRegion.Max.X = (f32)(Cluster->DrawRegionOffsetX + Cluster->DrawRegionSizeX) * InvViewportSizeX;
-    ClusterDrawRegion.Max.Y = (f32)(Cluster->DrawRegionOffsetY + Cluster->DrawRegionSizeY) * InvViewportSizeY;
+    u64* VisibleAreas = (SortedKeys == Cluster->SortKeys) ? Cluster->SortScratchKeys : Cluster->SortKeys;
+    u16 CoveredMinX[RENDERER_MAX_CLUSTER_SIZE];
+    u16 CoveredEndX[RENDERER_MAX_CLUSTER_SIZE];
+    b8 HasCoveredPixels = false;
+    // NOTE(Traian): The cluster size can exceed the maximum only for huge viewports, where nothing is culled.
+    const b8 CanCoverPixels = (Cluster->DrawRegionSizeY <= RENDERER_MAX_CLUSTER_SIZE);
 
-    for (u32 PrimitiveIndex = 0; PrimitiveIndex < Renderer->CurrentPrimitiveIndex; ++PrimitiveIndex)
+    for (u32 SortedIndex = Cluster->PrimitiveCount; SortedIndex > 0; --SortedIndex)
     {
-        const renderer_primitive* Primitive = Renderer->Primitives + PrimitiveIndex;
-        const rect2D PrimitiveRegion = Rect2D_Intersect({ Primitive->MinPoint, Primitive->MaxPoint },
-                                                        ClusterDrawRegion);
-        if (!Rect2D_IsDegenerated(PrimitiveRegion))
+        const u32 PrimitiveIndex = (u32)(SortedKeys[SortedIndex - 1] & 0xFFFFFFFF);
+        const renderer_rasterization_area Area = Renderer_GetRasterizationArea(Renderer, Cluster, PrimitiveIndex);
+        const u8 Flags = Renderer->PrimitiveSetups.Flags[PrimitiveIndex];
+
+        const u32 MinX = Area.PixelOffsetX - Cluster->DrawRegionOffsetX;
+        const u32 MinY = Area.PixelOffsetY - Cluster->DrawRegionOffsetY;
+        const u32 EndX = MinX + Area.PixelCountX;
+        const u32 EndY = MinY + Area.PixelCountY;
+
+        u32 VisibleMinX = MinX;
+        u32 VisibleMinY = MinY;
+        u32 VisibleEndX = EndX;
+        u32 VisibleEndY = EndY;
+
+        if (HasCoveredPixels)
+        {
+            VisibleMinX = EndX;
+            VisibleMinY = EndY;
+            VisibleEndX = MinX;
+            VisibleEndY = MinY;
+
+            for (u32 RowIndex = MinY; RowIndex < EndY; ++RowIndex)
+            {
+                const u32 CoveredMin = CoveredMinX[RowIndex];
+                const u32 CoveredEnd = CoveredEndX[RowIndex];
+                if (CoveredMin <= MinX && EndX <= CoveredEnd)
+                {
+                    continue;
+                }
+
+                // NOTE(Traian): The covered interval can only clip the row span from one of its ends. When it is
+                // strictly inside the span, the whole span stays visible.
+                const u32 RowMinX = (CoveredMin <= MinX && CoveredEnd > MinX) ? CoveredEnd : MinX;
+                const u32 RowEndX = (CoveredMin < EndX && CoveredEnd >= EndX) ? CoveredMin : EndX;
+
+                if (RowMinX < VisibleMinX) { VisibleMinX = RowMinX; }
+                if (RowEndX > VisibleEndX) { VisibleEndX = RowEndX; }
+                if (RowIndex < VisibleMinY) { VisibleMinY = RowIndex; }
+                VisibleEndY = RowIndex + 1;
+            }
+
+            if (VisibleMinY >= VisibleEndY)
+            {
+                VisibleMinX = VisibleEndX = VisibleMinY = VisibleEndY = 0;
+            }
+        }
+
+        VisibleAreas[SortedIndex - 1] = ((u64)VisibleMinX <<  0) | ((u64)VisibleEndX << 16) |
+                                        ((u64)VisibleMinY << 32) | ((u64)VisibleEndY << 48);
+
+        if (CanCoverPixels && (Flags & RENDERER_PRIMITIVE_SETUP_FLAG_OPAQUE) && MinX < EndX && MinY < EndY)
         {
-            if (Cluster->CurrentPrimitiveIndex >= Cluster->MaxPrimitiveCount)
+            if (!HasCoveredPixels)
             {
-                PANIC("Renderer cluster primitive buffer overflown!");
+                ZeroMemory(CoveredMinX, Cluster->DrawRegionSizeY * sizeof(u16));
+                ZeroMemory(CoveredEndX, Cluster->DrawRegionSizeY * sizeof(u16));
+                HasCoveredPixels = true;
             }
 
-            Cluster->Primitives[Cluster->CurrentPrimitiveIndex] = *Primitive;
-            Cluster->CurrentPrimitiveIndex++;
+            // NOTE(Traian): Every pixel of the primitive ends up hidden, even the ones it doesn't draw itself (as
+            // those are already hidden by the primitives in front of it).
+            for (u32 RowIndex = MinY; RowIndex < EndY; ++RowIndex)
+            {
+                const u32 CoveredMin = CoveredMinX[RowIndex];
+                const u32 CoveredEnd = CoveredEndX[RowIndex];
+                if (CoveredMin < CoveredEnd && MinX <= CoveredEnd && CoveredMin <= EndX)
+                {
+                    CoveredMinX[RowIndex] = (u16)((MinX < CoveredMin) ? MinX : CoveredMin);
+                    CoveredEndX[RowIndex] = (u16)((EndX > CoveredEnd) ? EndX : CoveredEnd);
+                }
+                else if (EndX - MinX > CoveredEnd - CoveredMin)
+                {
+                    CoveredMinX[RowIndex] = (u16)MinX;
+                    CoveredEndX[RowIndex] = (u16)EndX;
+                }
+            }
         }
     }
 
+    u64 Cost = 0;
+
     //
-    // NOTE(Traian): Sort the cluster primitive buffer.
+    // NOTE(Traian): Copy the region of the cluster from the background layer, except for the covered pixels.
     //
 
-    Renderer_SortPrimitiveBuffer(Cluster->Primitives, Cluster->CurrentPrimitiveIndex);
+    if (Renderer->BackgroundLayer)
+    {
+        const renderer_image* LayerImage = &Renderer->BackgroundLayer->Image;
+        const memory_size BytesPerPixel = Image_GetBytesPerPixelForFormat(LayerImage->Format);
+        for (u32 RowIndex = 0; RowIndex < Cluster->DrawRegionSizeY; ++RowIndex)
+        {
+            const u32 PixelIndexY = Cluster->DrawRegionOffsetY + RowIndex;
+            u32 CoveredMin = Cluster->DrawRegionSizeX;
+            u32 CoveredEnd = Cluster->DrawRegionSizeX;
+            if (HasCoveredPixels && CoveredMinX[RowIndex] < CoveredEndX[RowIndex])
+            {
+                CoveredMin = CoveredMinX[RowIndex];
+                CoveredEnd = CoveredEndX[RowIndex];
+            }
+
+            if (CoveredMin > 0)
+            {
+                CopyMemory(Image_GetPixelAddress(RenderTarget, Cluster->DrawRegionOffsetX, PixelIndexY),
+                           Image_GetPixelAddress(LayerImage, Cluster->DrawRegionOffsetX, PixelIndexY),
+                           CoveredMin * BytesPerPixel);
+            }
+            if (CoveredEnd < Cluster->DrawRegionSizeX)
+            {
+                CopyMemory(Image_GetPixelAddress(RenderTarget, Cluster->DrawRegionOffsetX + CoveredEnd, PixelIndexY),
+                           Image_GetPixelAddress(LayerImage, Cluster->DrawRegionOffsetX + CoveredEnd, PixelIndexY),
+                           (Cluster->DrawRegionSizeX - CoveredEnd) * BytesPerPixel);
+            }
+        }
+        Cost += RENDERER_LAYER_ROW_COPY_COST * Cluster->DrawRegionSizeY;
+    }
 
     //
-    // NOTE(Traian): Draw the primitives.
+    // NOTE(Traian): Draw the visible areas of the primitives, back-to-front.
     //
 
-    for (u32 PrimitiveIndex = 0; PrimitiveIndex < Cluster->CurrentPrimitiveIndex; ++PrimitiveIndex)
+    for (u32 SortedIndex = 0; SortedIndex < Cluster->PrimitiveCount; ++SortedIndex)
     {
-        const renderer_primitive* Primitive = Cluster->Primitives + PrimitiveIndex;
-        if (Primitive->TextureSlotIndex == -1)
+        Cost += RENDERER_PRIMITIVE_SETUP_COST;
+
+        const u64 VisibleArea = VisibleAreas[SortedIndex];
+        const u32 VisibleMinX = (u32)(VisibleArea >>  0) & 0xFFFF;
+        const u32 VisibleEndX = (u32)(VisibleArea >> 16) & 0xFFFF;
+        const u32 VisibleMinY = (u32)(VisibleArea >> 32) & 0xFFFF;
+        const u32 VisibleEndY = (u32)(VisibleArea >> 48) & 0xFFFF;
+        if (VisibleMinX >= VisibleEndX || VisibleMinY >= VisibleEndY)
         {
-            Renderer_DrawFilledPrimitive(Renderer, RenderTarget, Cluster, PrimitiveIndex, ClusterDrawRegion);
+            continue;
+        }
+
+        const u32 PrimitiveIndex = (u32)(SortedKeys[SortedIndex] & 0xFFFFFFFF);
+
+        // NOTE(Traian): Only the pixel range is replaced, the first covered pixel of the primitive is still needed to
+        // interpolate the texture coordinates.
+        renderer_rasterization_area Area = Renderer_GetRasterizationArea(Renderer, Cluster, PrimitiveIndex);
+        Area.PixelOffsetX = Cluster->DrawRegionOffsetX + VisibleMinX;
+        Area.PixelOffsetY = Cluster->DrawRegionOffsetY + VisibleMinY;
+        Area.PixelCountX = VisibleEndX - VisibleMinX;
+        Area.PixelCountY = VisibleEndY - VisibleMinY;
+
+        if ((Renderer->PrimitiveSetups.Flags[PrimitiveIndex] & RENDERER_PRIMITIVE_SETUP_FLAG_TEXTURED) == 0)
+        {
+            const u32 PixelCount = Renderer_DrawFilledPrimitive(Renderer, RenderTarget, PrimitiveIndex, Area);
+            Cost += RENDERER_FILLED_PIXEL_COST * PixelCount;
         }
         else
         {
-            Renderer_DrawTexturedPrimitive(Renderer, RenderTarget, Cluster, PrimitiveIndex, ClusterDrawRegion);
+            const u32 PixelCount = Renderer_DrawTexturedPrimitive(Renderer, RenderTarget, PrimitiveIndex, Area);
+            Cost += RENDERER_TEXTURED_PIXEL_COST * PixelCount;
         }
     }
+
+    Cluster->Cost = Cost;
 }
 
-struct renderer_cluster_task_info
+struct renderer_cluster_job
 {
     renderer*       Renderer;
     renderer_image* RenderTarget;
-    u32             ClusterIndex;
 };
 
 internal void
-Renderer_RunClusterTask(s32 LogicalThreadIndex, void* OpaqueTaskInfo)
+Renderer_RunClusterRange(s32 LogicalThreadIndex, u32 FirstOrderIndex, u32 EndOrderIndex, void* OpaqueJob)
 {
-    const renderer_cluster_task_info* TaskInfo = (const renderer_cluster_task_info*)OpaqueTaskInfo;
-    Renderer_ExecuteCluster(TaskInfo->Renderer, TaskInfo->RenderTarget, TaskInfo->ClusterIndex);
+    const renderer_cluster_job* Job = (const renderer_cluster_job*)OpaqueJob;
+    for (u32 OrderIndex = FirstOrderIndex; OrderIndex < EndOrderIndex; ++OrderIndex)
+    {
+        const u32 ClusterIndex = Job->Renderer->ActiveClusterIndices[OrderIndex];
+        Renderer_ExecuteCluster(Job->Renderer, Job->RenderTarget, ClusterIndex);
+    }
 }
 
 function void
 Renderer_DispatchClusters(renderer* Renderer, renderer_image* RenderTarget, platform_task_queue* TaskQueue)
 {
     ASSERT(RenderTarget->SizeX == Renderer->ViewportSizeX);
+    ASSERT(RenderTarget->Layout == RENDERER_IMAGE_LAYOUT_LINEAR);
     ASSERT(RenderTarget->SizeY == Renderer->ViewportSizeY);
 
-    const u32 MAX_TASK_INFO_COUNT = 64;
-    renderer_cluster_task_info TaskInfos[MAX_TASK_INFO_COUNT] = {};
-    u32 CurrentTaskInfoIndex = 0;
+    //
+    // NOTE(Traian): Only the clusters that have primitives binned to them are dispatched (or all of them, when the
+    // background layer has to be copied). Each one is given its range of the sort key buffer and an ordering key built
+    // from the cost measured during the previous frame, so that the most expensive clusters are started first and the
+    // cheap ones fill the gaps at the end of the frame.
+    //
+
+    if (Renderer->BackgroundLayer)
+    {
+        ASSERT(Renderer->BackgroundLayer->Image.Format == RenderTarget->Format);
+        ASSERT(Renderer->BackgroundLayer->Image.SizeX == RenderTarget->SizeX);
+        ASSERT(Renderer->BackgroundLayer->Image.SizeY == RenderTarget->SizeY);
+    }
+
+    //
+    // NOTE(Traian): In incremental mode, the clusters whose content is the same as during the previous frame are not
+    // dispatched at all, as their pixels from the previous frame are still in the render target.
+    //
 
+    const b8 HasHistory = Renderer->IsIncremental &&
+                          (Renderer->HistoryPixelBuffer == RenderTarget->PixelBuffer) &&
+                          (Renderer->HistorySizeX == RenderTarget->SizeX) &&
+                          (Renderer->HistorySizeY == RenderTarget->SizeY);
+
+    u32 SortKeyBufferOffset = 0;
+    Renderer->ActiveClusterCount = 0;
     for (u32 ClusterIndex = 0; ClusterIndex < Renderer->ClusterCount; ++ClusterIndex)
     {
-        renderer_cluster_task_info* TaskInfo = &TaskInfos[CurrentTaskInfoIndex++];
-        TaskInfo->Renderer = Renderer;
-        TaskInfo->RenderTarget = RenderTarget;
-        TaskInfo->ClusterIndex = ClusterIndex;
+        renderer_cluster* Cluster = Renderer->Clusters + ClusterIndex;
+        if (Renderer->IsIncremental)
+        {
+            u64 ContentHash = Renderer_MixHash(Cluster->ContentHash, Cluster->PrimitiveCount);
+            ContentHash = Renderer_MixHash(ContentHash, (memory_index)Renderer->BackgroundLayer);
+            if (Renderer->BackgroundLayer)
+            {
+                // NOTE(Traian): The layer keeps its address when its content is rendered again.
+                ContentHash = Renderer_MixHash(ContentHash, Renderer->BackgroundLayer->Generation);
+            }
+            const b8 IsUnchanged = HasHistory && (ContentHash == Cluster->PreviousContentHash);
+            Cluster->PreviousContentHash = ContentHash;
+            if (IsUnchanged)
+            {
+                // NOTE(Traian): The cost of the cluster is kept, as it is still the best estimate for when its content
+                // changes again.
+                continue;
+            }
+        }
+
+        if (Cluster->PrimitiveCount == 0 && Renderer->BackgroundLayer == NULL)
+        {
+            Cluster->Cost = 0;
+            continue;
+        }
+
+        Cluster->SortKeys = Renderer->SortKeyBuffer + SortKeyBufferOffset;
+        Cluster->SortScratchKeys = Cluster->SortKeys + Cluster->PrimitiveCount;
+        SortKeyBufferOffset += 2 * Cluster->PrimitiveCount;
+
+        const u32 ClampedCost = (Cluster->Cost < U32_MAX) ? (u32)Cluster->Cost : U32_MAX;
+        Renderer->ClusterOrderKeys[Renderer->ActiveClusterCount++] = ((u64)(U32_MAX - ClampedCost) << 32) |
+                                                                     (u64)ClusterIndex;
+    }
+
+    const u64* SortedOrderKeys = Renderer_SortKeys(Renderer->ClusterOrderKeys, Renderer->ClusterOrderScratchKeys,
+                                                   Renderer->ActiveClusterCount);
+    for (u32 OrderIndex = 0; OrderIndex < Renderer->ActiveClusterCount; ++OrderIndex)
+    {
+        Renderer->ActiveClusterIndices[OrderIndex] = (u32)(SortedOrderKeys[OrderIndex] & 0xFFFFFFFF);
+    }
+
+    //
+    // NOTE(Traian): Set up the primitives before any cluster is rasterized. Each primitive is set up exactly once, no
+    // matter how many clusters it is binned to. When some clusters are skipped by the incremental mode, only the
+    // primitives binned to the active clusters are set up (and none at all when nothing changed).
+    //
+
+    if (!HasHistory)
+    {
+        PlatformTaskQueue_ParallelFor(TaskQueue, Renderer->CurrentPrimitiveIndex, RENDERER_PRIMITIVE_SETUP_GRAIN,
+                                      Renderer_SetupPrimitiveRange, Renderer);
+    }
+    else if (Renderer->ActiveClusterCount > 0)
+    {
+        Renderer_GatherActivePrimitives(Renderer);
+        PlatformTaskQueue_ParallelFor(TaskQueue, Renderer->GatheredPrimitiveCount, RENDERER_PRIMITIVE_SETUP_GRAIN,
+                                      Renderer_SetupGatheredPrimitiveRange, Renderer);
+    }
+
+    //
+    // NOTE(Traian): The clusters are pulled (in order) from the shared counter of the parallel-for until none remain,
+    // so that the threads balance the load between themselves.
+    //
+
+    renderer_cluster_job Job = {};
+    Job.Renderer = Renderer;
+    Job.RenderTarget = RenderTarget;
+    PlatformTaskQueue_ParallelFor(TaskQueue, Renderer->ActiveClusterCount, 1, Renderer_RunClusterRange, &Job);
+
+    if (Renderer->IsIncremental)
+    {
+        Renderer->HistoryPixelBuffer = RenderTarget->PixelBuffer;
+        Renderer->HistorySizeX = RenderTarget->SizeX;
+        Renderer->HistorySizeY = RenderTarget->SizeY;
+    }
+}
+
+function void
+Renderer_SetIncrementalMode(renderer* Renderer, b8 IsIncremental)
+{
+    if (Renderer->IsIncremental != IsIncremental)
+    {
+        Renderer->IsIncremental = IsIncremental;
+        Renderer->HistoryPixelBuffer = NULL;
+    }
+}
+
+function void
+Renderer_CreateLayer(renderer_layer* Layer, memory_arena* Arena, u32 MaxSizeX, u32 MaxSizeY)
+{
+    ZERO_STRUCT_POINTER(Layer);
+    Layer->MaxPixelCount = MaxSizeX * MaxSizeY;
+    Layer->Image.Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
+    Layer->Image.PixelBuffer = MemoryArena_Allocate(Arena, Image_GetPixelBufferByteCount(MaxSizeX, MaxSizeY,
+                                                                                         Layer->Image.Format),
+                                                    alignof(u32));
+}
+
+function b8
+Renderer_PrepareLayer(renderer_layer* Layer, u32 ViewportSizeX, u32 ViewportSizeY)
+{
+    if ((u64)ViewportSizeX * (u64)ViewportSizeY > (u64)Layer->MaxPixelCount)
+    {
+        Layer->IsValid = false;
+        return false;
+    }
 
-        PlatformTaskQueue_Push(TaskQueue, Renderer_RunClusterTask, TaskInfo);
+    if (Layer->Image.SizeX != ViewportSizeX || Layer->Image.SizeY != ViewportSizeY)
+    {
+        Layer->Image.SizeX = ViewportSizeX;
+        Layer->Image.SizeY = ViewportSizeY;
+        Layer->Image.Stride = ViewportSizeX;
+        Layer->IsValid = false;
+        ++Layer->Generation;
     }
+    return true;
+}
+
+function void
+Renderer_MarkLayerRendered(renderer_layer* Layer)
+{
+    Layer->IsValid = true;
+    ++Layer->Generation;
+}
 
-    PlatformTaskQueue_WaitForAll(TaskQueue);
+function void
+Renderer_SetBackgroundLayer(renderer* Renderer, const renderer_layer* Layer)
+{
+    ASSERT(Layer->IsValid);
+    ASSERT(Layer->Image.SizeX == Renderer->ViewportSizeX);
+    ASSERT(Layer->Image.SizeY == Renderer->ViewportSizeY);
+    Renderer->BackgroundLayer = Layer;
 }
@@ -18,21 +18,78 @@ enum renderer_image_format : u8
     RENDERER_IMAGE_FORMAT_B8G8R8A8,
 };
 
+//
+// NOTE(Traian): In tiled images the pixels are grouped in square tiles of 'RENDERER_IMAGE_TILE_SIZE' pixels, stored one
+// after another in row-major order, with the pixels of each tile also in row-major order. A B8G8R8A8 tile occupies a
+// single cache line, so the texels of a minified sprite (which are sampled far apart on both axes) are fetched from
+// fewer cache lines than with the linear layout.
+//
+enum renderer_image_layout : u8
+{
+    RENDERER_IMAGE_LAYOUT_LINEAR = 0,
+    RENDERER_IMAGE_LAYOUT_TILED,
+};
+
+#define RENDERER_IMAGE_TILE_SIZE (4)
+
+//
+// NOTE(Traian): Describes which pixels of an image row are worth sampling. All pixels outside of the ['MinX', 'EndX')
+// range are fully transparent, while all pixels inside of the ['OpaqueMinX', 'OpaqueEndX') range (the longest run of
+// them in the row) are fully opaque. Either range is empty (zero) when the row doesn't have such pixels.
+//
+struct renderer_image_row_span
+{
+    u16 MinX;
+    u16 EndX;
+    u16 OpaqueMinX;
+    u16 OpaqueEndX;
+};
+
 struct renderer_image
 {
-    u32                     SizeX;
-    u32                     SizeY;
-    renderer_image_format   Format;
-    void*                   PixelBuffer;
+    u32                             SizeX;
+    u32                             SizeY;
+    // NOTE(Traian): The number of pixels between the start of a row and the start of the next one. Never less than
+    // 'SizeX', as the rows of padded images are followed by their border pixel. For tiled images it is the width of
+    // a row of tiles (in pixels), so the next row of tiles starts 'RENDERER_IMAGE_TILE_SIZE * Stride' pixels later.
+    u32                             Stride;
+    renderer_image_format           Format;
+    renderer_image_layout           Layout;
+    // NOTE(Traian): Whether the color channels of the image are already multiplied by the alpha channel.
+    b8                              IsAlphaPremultiplied;
+    // NOTE(Traian): Whether the image is followed by a border that replicates its edge pixels: one extra pixel at the
+    // end of each row and one extra row after the last one. Only padded images can be sampled, as the bilinear filter
+    // then always finds the pixels to the right and above the sampled one, without checking the image bounds.
+    // Tiled images are always padded, and their border extends up to the end of the last row and column of tiles.
+    b8                              IsPadded;
+    void*                           PixelBuffer;
+    // NOTE(Traian): One span for each row of the image. Optional, only generated for the premultiplied B8G8R8A8
+    // textures built by the asset packer.
+    const renderer_image_row_span*  RowSpans;
 };
 
 function memory_size    Image_GetBytesPerPixelForFormat (renderer_image_format Format);
 
 function memory_size    Image_GetPixelBufferByteCount   (u32 SizeX, u32 SizeY, renderer_image_format Format);
 
+// NOTE(Traian): The byte count of a padded image, including its border.
+function memory_size    Image_GetPaddedBufferByteCount  (u32 SizeX, u32 SizeY, renderer_image_format Format);
+
+// NOTE(Traian): The byte count of a tiled image, including its border.
+function memory_size    Image_GetTiledBufferByteCount   (u32 SizeX, u32 SizeY, renderer_image_format Format);
+
+// NOTE(Traian): The 'Stride' of a tiled image.
+function u32            Image_GetTiledStride            (u32 SizeX);
+
 function void           Image_AllocateFromArena         (renderer_image* Image, memory_arena* Arena,
                                                          renderer_image_format Format, u32 SizeX, u32 SizeY);
 
+// NOTE(Traian): The border of the image is not initialized. Call 'Image_ReplicateBorder' after writing the pixels.
+function void           Image_AllocatePaddedFromArena   (renderer_image* Image, memory_arena* Arena,
+                                                         renderer_image_format Format, u32 SizeX, u32 SizeY);
+
+function void           Image_ReplicateBorder           (renderer_image* Image);
+
 function void*          Image_GetPixelAddress           (renderer_image* Image, u32 PixelIndexX, u32 PixelIndexY);
 
 function const void*    Image_GetPixelAddress           (const renderer_image* Image, u32 PixelIndexX, u32 PixelIndexY);
@@ -50,6 +107,10 @@ struct renderer_texture
     u32                     SizeX;
     u32                     SizeY;
     renderer_image_format   Format;
+    b8                      IsAlphaPremultiplied;
+    // NOTE(Traian): Whether every texel of the texture is fully opaque. Primitives that sample such a texture (without
+    // making it translucent) hide everything below them, which allows the renderer to skip drawing the hidden pixels.
+    b8                      IsOpaque;
     u32                     MaxMipCount;
     u32                     MipCount;
     renderer_image*         Mips;
@@ -58,6 +119,9 @@ struct renderer_texture
 function void           Texture_Create                  (renderer_texture* Texture, memory_arena* Arena,
                                                          const renderer_image* SourceImage, u32 MaxMipCount);
 
+// NOTE(Traian): Creates a texture from an already generated mip chain. The mips are referenced, not copied.
+function void           Texture_CreateFromMipChain      (renderer_texture* Texture, renderer_image* Mips, u32 MipCount);
+
 //====================================================================================================================//
 //----------------------------------------------------- RENDERER -----------------------------------------------------//
 //====================================================================================================================//
@@ -71,37 +135,201 @@ struct renderer_primitive
     color4  Color;
     vec2    MinUV;
     vec2    MaxUV;
-    u32     TextureSlotIndex;
+    // NOTE(Traian): NULL for filled primitives. Textures are referenced directly (instead of through per-frame slots),
+    // as they stay alive for as long as the primitives that sample them.
+    const renderer_texture* Texture;
+    // NOTE(Traian): The edges of the primitive, snapped to the 24.8 fixed-point sub-pixel grid of the viewport.
+    s32     SubPixelMinX;
+    s32     SubPixelMinY;
+    s32     SubPixelMaxX;
+    s32     SubPixelMaxY;
+};
+
+enum renderer_primitive_setup_flags : u8
+{
+    RENDERER_PRIMITIVE_SETUP_FLAG_NONE          = 0,
+    // NOTE(Traian): The pixels drawn by the primitive don't depend on the pixels below it.
+    RENDERER_PRIMITIVE_SETUP_FLAG_OPAQUE        = (1 << 0),
+    RENDERER_PRIMITIVE_SETUP_FLAG_TEXTURED      = (1 << 1),
+    // NOTE(Traian): The spans are clipped to the pixels that sample visible texels (using the row spans of the mips).
+    RENDERER_PRIMITIVE_SETUP_FLAG_CLIP_SPANS    = (1 << 2),
+    // NOTE(Traian): The pixels that sample only fully opaque texels are drawn without reading the destination.
+    RENDERER_PRIMITIVE_SETUP_FLAG_SKIP_BLENDING = (1 << 3),
+};
+
+//
+// NOTE(Traian): Everything needed to draw a primitive that doesn't depend on the cluster it is drawn in. The setup is
+// computed once per frame for each primitive (in parallel, before the clusters are rasterized), instead of once for
+// each cluster the primitive is binned to. Each field is stored in its own array, indexed by the primitive index, so
+// the culling pass (which only reads the covered pixels and the flags) touches as few cache lines as possible.
+//
+struct renderer_primitive_setups
+{
+    // NOTE(Traian): The pixels covered by the primitive, clipped to the viewport.
+    u32*                    FirstPixelIndexX;
+    u32*                    EndPixelIndexX;
+    u32*                    FirstPixelIndexY;
+    u32*                    EndPixelIndexY;
+    u8*                     Flags;
+    // NOTE(Traian): The fill color, or the tint of the texels (premultiplied when the texture is premultiplied).
+    color4*                 Colors;
+    // NOTE(Traian): The remaining fields are only computed for textured primitives. U is given for the center of the
+    // first covered pixel on X, while V is computed for each row from the distance (in sub-pixels) between its center
+    // and the minimum edge of the primitive ('SubPixelMinY').
+    f32*                    FirstU;
+    f32*                    DeltaU;
+    f32*                    MinV;
+    f32*                    VPerSubPixel;
+    s32*                    SubPixelMinY;
+    // NOTE(Traian): The second mip is only set when the primitive blends between two mips.
+    const renderer_image**  MipImagesA;
+    const renderer_image**  MipImagesB;
+    f32*                    MipInterpolationFactors;
+};
+
+//
+// NOTE(Traian): The primitives binned to a cluster are stored as a linked list of fixed-size chunks, allocated from a
+// pool that is shared by all clusters. This way the bin memory is proportional to the number of binned primitives,
+// instead of the number of clusters times the maximum number of primitives.
+//
+#define RENDERER_BIN_CHUNK_CAPACITY (30)
+
+struct renderer_bin_chunk
+{
+    u32                 NextChunkIndex;
+    u32                 PrimitiveCount;
+    u32                 PrimitiveIndices[RENDERER_BIN_CHUNK_CAPACITY];
 };
 
 struct renderer_cluster
 {
-    u32                 MaxPrimitiveCount;
-    u32                 CurrentPrimitiveIndex;
-    renderer_primitive* Primitives;
+    u32                 PrimitiveCount;
+    u32                 FirstChunkIndex;
+    u32                 LastChunkIndex;
+    u64*                SortKeys;
+    u64*                SortScratchKeys;
     u32                 DrawRegionOffsetX;
     u32                 DrawRegionOffsetY;
     u32                 DrawRegionSizeX;
     u32                 DrawRegionSizeY;
+    // NOTE(Traian): The (approximate) cost of rasterizing the cluster during the previous frame, used to dispatch the
+    // most expensive clusters first.
+    u64                 Cost;
+    // NOTE(Traian): Hashes of the content binned to the cluster during the current and the previous frame. Only used
+    // in incremental mode, where a cluster whose content didn't change is not rasterized again.
+    u64                 ContentHash;
+    u64                 PreviousContentHash;
+};
+
+struct renderer_textured_span
+{
+    u32*                    Pixels;
+    u32                     PixelCount;
+    // NOTE(Traian): The texture coordinate of the first step and the per-pixel increment along X. The first pixel in
+    // the span is 'FirstStepIndex' steps away from the first step. The V coordinate is constant across a span, as
+    // primitives are axis-aligned.
+    f32                     U;
+    f32                     DeltaU;
+    u32                     FirstStepIndex;
+    f32                     V;
+    renderer_image_format   Format;
+    // NOTE(Traian): When set, the span color is premultiplied as well and the pixels are blended using the
+    // 'Dst = Src + Dst * (1 - SrcAlpha)' operator, instead of the straight alpha lerp.
+    b8                      IsAlphaPremultiplied;
+    // NOTE(Traian): Set (only together with 'IsAlphaPremultiplied') when every pixel of the span samples fully opaque
+    // texels with a fully opaque color. The blend then doesn't depend on the destination, so it isn't read at all.
+    b8                      IsOpaque;
+    const renderer_image*   MipImageA;
+    const renderer_image*   MipImageB;
+    b8                      BlendBetweenMips;
+    f32                     InterpolationFactorAB;
+    color4                  Color;
+};
+
+using renderer_fill_span_pfn        = void(*)(u32* Pixels, u32 PixelCount, color4 Color);
+using renderer_textured_span_pfn    = void(*)(const renderer_textured_span* Span);
+
+struct renderer_span_kernels
+{
+    renderer_fill_span_pfn      FillSpan;
+    renderer_textured_span_pfn  TexturedSpan;
+    // NOTE(Traian): The number of pixels the textured kernel processes at once. The remaining pixels of a span (fewer
+    // than this) are processed one by one, which is considerably slower.
+    u32                         TexturedSpanWidth;
+};
+
+// NOTE(Traian): The largest difference (in any channel) allowed between the output of the reference span kernels and
+// the output of the fixed-point ones.
+#define RENDERER_MAX_SPAN_KERNEL_DIFFERENCE (1)
+
+struct renderer_span_kernels_report
+{
+    u32 SpanCount;
+    // NOTE(Traian): The number of fixed-point kernel tables (scalar and SIMD) that were compared to the reference.
+    u32 KernelTableCount;
+    u32 MaxFillDifference;
+    u32 MaxTexturedDifference;
+    // NOTE(Traian): The largest difference between the scalar fixed-point kernels and the SIMD ones (must be zero).
+    u32 MaxFixedTableDifference;
+};
+
+//
+// NOTE(Traian): A layer caches the rasterized result of content that rarely changes (such as the background). When a
+// layer is set as the background of a frame, each cluster starts by copying its region from the layer, instead of
+// rasterizing the cached content again. The pixels are allocated once, for the largest supported viewport size.
+//
+struct renderer_layer
+{
+    u32             MaxPixelCount;
+    renderer_image  Image;
+    // NOTE(Traian): Cleared when the viewport size changes. The owner of the layer must also clear it whenever the
+    // cached content changes, and call 'Renderer_MarkLayerRendered' after the content was rendered into the layer.
+    b8              IsValid;
+    // NOTE(Traian): Incremented whenever the pixels of the layer change, so that the incremental mode can tell apart
+    // the content of the layer between frames (its address stays the same).
+    u32             Generation;
 };
 
 struct renderer
 {
+    u32                         MaxClusterCount;
     u32                         ClusterCount;
+    u32                         ClusterCountX;
+    u32                         ClusterCountY;
+    u32                         ClusterSize;
     renderer_cluster*           Clusters;
+    u32                         ActiveClusterCount;
+    u32*                        ActiveClusterIndices;
+    u64*                        ClusterOrderKeys;
+    u64*                        ClusterOrderScratchKeys;
+    u32                         MaxBinChunkCount;
+    u32                         CurrentBinChunkIndex;
+    renderer_bin_chunk*         BinChunks;
+    u64*                        SortKeyBuffer;
     u32                         MaxPrimitiveCount;
     u32                         CurrentPrimitiveIndex;
     renderer_primitive*         Primitives;
-    u32                         MaxTextureSlotCount;
-    u32                         CurrentTextureSlotIndex;
-    const renderer_texture**    TextureSlots;
+    renderer_primitive_setups   PrimitiveSetups;
+    // NOTE(Traian): The primitives binned to the active clusters, gathered only when some clusters are not dispatched.
+    u32                         GatheredPrimitiveCount;
+    u32*                        GatheredPrimitiveIndices;
+    b8*                         IsPrimitiveGathered;
     u32                         ViewportSizeX;
     u32                         ViewportSizeY;
+    renderer_span_kernels       SpanKernels;
+    const renderer_layer*       BackgroundLayer;
+    b8                          IsIncremental;
+    // NOTE(Traian): The render target the clusters were rasterized into during the previous (incremental) frame. The
+    // previous content hashes of the clusters describe its pixels, as long as it is the same render target.
+    const void*                 HistoryPixelBuffer;
+    u32                         HistorySizeX;
+    u32                         HistorySizeY;
 };
 
 function void   Renderer_Initialize         (renderer* Renderer, memory_arena* Arena);
 
-function void   Renderer_BeginFrame         (renderer* Renderer, u32 ViewportSizeX, u32 ViewportSizeY);
+function void   Renderer_BeginFrame         (renderer* Renderer, u32 ViewportSizeX, u32 ViewportSizeY,
+                                             u32 ThreadCount);
 
 function void   Renderer_EndFrame           (renderer* Renderer);
 
@@ -111,3 +339,33 @@ function void   Renderer_PushPrimitive      (renderer* Renderer, vec2 MinPoint,
 
 function void   Renderer_DispatchClusters   (renderer* Renderer, renderer_image* RenderTarget,
                                              platform_task_queue* TaskQueue);
+
+//
+// NOTE(Traian): In incremental mode, the renderer compares the primitives binned to each cluster with the ones binned
+// to it during the previous frame, and only the clusters whose content changed are rasterized again. The pixels of the
+// other clusters are left as they are, so the render target must keep its content between frames (and nothing else
+// must write to it). Changing the render target, the viewport size or the cluster grid redraws all clusters. The mode
+// must be set before 'Renderer_BeginFrame' is called.
+//
+function void   Renderer_SetIncrementalMode (renderer* Renderer, b8 IsIncremental);
+
+function void   Renderer_CreateLayer        (renderer_layer* Layer, memory_arena* Arena,
+                                             u32 MaxSizeX, u32 MaxSizeY);
+
+// NOTE(Traian): Resizes the layer to the viewport size. Returns false if the layer can't hold a viewport this large,
+// in which case it can't be used and its content must be rendered as part of each frame instead.
+function b8     Renderer_PrepareLayer       (renderer_layer* Layer, u32 ViewportSizeX, u32 ViewportSizeY);
+
+// NOTE(Traian): Must be called after the (cached) content was rendered into the layer.
+function void   Renderer_MarkLayerRendered  (renderer_layer* Layer);
+
+// NOTE(Traian): Must be called between 'Renderer_BeginFrame' and 'Renderer_DispatchClusters'. The layer must be valid
+// and have the same size as the viewport.
+function void   Renderer_SetBackgroundLayer (renderer* Renderer, const renderer_layer* Layer);
+
+// NOTE(Traian): Runs random spans through the reference kernels and through every fixed-point kernel table supported by
+// the CPU. Returns false if any channel differs by more than 'RENDERER_MAX_SPAN_KERNEL_DIFFERENCE', or if the SIMD
+// kernels don't match the scalar fixed-point ones exactly. The scratch textures are allocated from the arena, which is
+// reset to its initial state before returning.
+function b8     Renderer_VerifySpanKernels  (renderer_span_kernels_report* Report, memory_arena* Arena,
+                                             random_series* Series, u32 SpanCount);
@@ -0,0 +1,575 @@
+// Copyright (c) 2025 Traian Avram. All rights reserved.
+// This source file is part of the PvZ-Remake project and is distributed under the MIT license.
+
+#include "pvz_memory.h"
+#include "pvz_platform.h"
+
+//====================================================================================================================//
+//---------------------------------------------------- TASK QUEUE ----------------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): The task queue is a work-stealing scheduler. Every worker thread (and the main thread, which is the
+// one that creates the queue and calls 'PlatformTaskQueue_WaitForAll') owns a Chase-Lev deque. The owner pushes and
+// pops tasks at the bottom of its deque without any contention, while idle threads steal from the top of the other
+// deques. Tasks pushed by the main thread are thus distributed by stealing, and tasks pushed from inside a task stay
+// on the worker that pushed them (until somebody else runs out of work).
+//
+// Workers that find no work anywhere park on a semaphore. A push only signals the semaphore when a worker is actually
+// parked, so a frame that keeps all workers busy never enters the kernel.
+//
+// The scheduler is shared by all platforms. It is built entirely on the atomics, the wait-on-address functions and
+// the threads provided by the platform layer.
+//
+
+#define TASK_QUEUE_DEQUE_CAPACITY   (512)
+#define TASK_QUEUE_STEAL_SPIN_COUNT (64)
+
+struct task_queue_task
+{
+    platform_task_pfn       TaskFunction;
+    void*                   UserData;
+    platform_task_group*    TaskGroup;
+};
+
+// NOTE(Traian): 'Top' is written by the thieves and 'Bottom' by the owner, so they are kept on separate cache lines.
+// Both indices only ever grow (apart from the temporary decrement of 'Bottom' while popping), so they are compared as
+// signed integers.
+struct task_queue_deque
+{
+    alignas(64) volatile u64    Top;
+    alignas(64) volatile u64    Bottom;
+    task_queue_task*            Tasks;
+};
+
+struct task_queue_worker
+{
+    task_queue_deque        Deque;
+    platform_thread         Thread;
+    platform_task_queue*    TaskQueue;
+    s32                     LogicalIndex;
+    u32                     RandomState;
+};
+
+struct platform_task_queue
+{
+    u32                         ThreadCount;
+    // NOTE(Traian): There are 'ThreadCount + 1' workers. The last one represents the main thread.
+    u32                         WorkerCount;
+    task_queue_worker*          Workers;
+    // NOTE(Traian): The count of the semaphore that the parked threads wait on.
+    alignas(64) volatile u32    WorkAvailableCount;
+    alignas(64) volatile u32    UnfinishedTaskCount;
+    alignas(64) volatile u32    ParkedThreadCount;
+};
+
+// NOTE(Traian): The worker that the current thread represents, or NULL if the thread doesn't belong to any task queue.
+internal thread_local task_queue_worker* TaskQueue_CurrentWorker;
+
+internal b8
+TaskQueue_Deque_Push(task_queue_deque* Deque, task_queue_task Task)
+{
+    const s64 Bottom = (s64)Platform_AtomicLoad64(&Deque->Bottom);
+    const s64 Top = (s64)Platform_AtomicLoad64(&Deque->Top);
+    if (Bottom - Top >= TASK_QUEUE_DEQUE_CAPACITY)
+    {
+        // NOTE(Traian): The deque is full.
+        return false;
+    }
+
+    // NOTE(Traian): The store to 'Bottom' has release semantics, so the task is visible to any thief that sees it.
+    Deque->Tasks[Bottom & (TASK_QUEUE_DEQUE_CAPACITY - 1)] = Task;
+    Platform_AtomicStore64(&Deque->Bottom, (u64)(Bottom + 1));
+    return true;
+}
+
+internal b8
+TaskQueue_Deque_Pop(task_queue_deque* Deque, task_queue_task* OutTask)
+{
+    const s64 Bottom = (s64)Platform_AtomicLoad64(&Deque->Bottom) - 1;
+    // NOTE(Traian): The store to 'Bottom' must be visible to the thieves before 'Top' is read, which requires a full
+    // memory barrier (a store with release semantics could still be reordered after the load).
+    Platform_AtomicStore64(&Deque->Bottom, (u64)Bottom);
+    Platform_MemoryBarrier();
+    const s64 Top = (s64)Platform_AtomicLoad64(&Deque->Top);
+
+    if (Top > Bottom)
+    {
+        // NOTE(Traian): The deque is empty.
+        Platform_AtomicStore64(&Deque->Bottom, (u64)(Bottom + 1));
+        return false;
+    }
+
+    *OutTask = Deque->Tasks[Bottom & (TASK_QUEUE_DEQUE_CAPACITY - 1)];
+    if (Top == Bottom)
+    {
+        // NOTE(Traian): This is the last task in the deque, so the owner has to race against the thieves for it.
+        const b8 WonRace = (Platform_AtomicCompareExchange64(&Deque->Top, (u64)(Top + 1), (u64)Top) == (u64)Top);
+        Platform_AtomicStore64(&Deque->Bottom, (u64)(Bottom + 1));
+        return WonRace;
+    }
+
+    return true;
+}
+
+enum task_queue_steal_result : u8
+{
+    TASK_QUEUE_STEAL_RESULT_STOLEN,
+    TASK_QUEUE_STEAL_RESULT_EMPTY,
+    TASK_QUEUE_STEAL_RESULT_LOST_RACE,
+};
+
+internal task_queue_steal_result
+TaskQueue_Deque_Steal(task_queue_deque* Deque, task_queue_task* OutTask)
+{
+    const s64 Top = (s64)Platform_AtomicLoad64(&Deque->Top);
+    Platform_MemoryBarrier();
+    const s64 Bottom = (s64)Platform_AtomicLoad64(&Deque->Bottom);
+
+    if (Top >= Bottom)
+    {
+        return TASK_QUEUE_STEAL_RESULT_EMPTY;
+    }
+
+    // NOTE(Traian): The task must be read before claiming it. If the slot is overwritten in the meantime, the top
+    // index has already moved and the compare-exchange below fails, so the (possibly torn) copy is discarded.
+    const task_queue_task Task = Deque->Tasks[Top & (TASK_QUEUE_DEQUE_CAPACITY - 1)];
+    if (Platform_AtomicCompareExchange64(&Deque->Top, (u64)(Top + 1), (u64)Top) != (u64)Top)
+    {
+        return TASK_QUEUE_STEAL_RESULT_LOST_RACE;
+    }
+
+    *OutTask = Task;
+    return TASK_QUEUE_STEAL_RESULT_STOLEN;
+}
+
+internal b8
+TaskQueue_HasQueuedTasks(platform_task_queue* TaskQueue)
+{
+    for (u32 WorkerIndex = 0; WorkerIndex < TaskQueue->WorkerCount; ++WorkerIndex)
+    {
+        task_queue_deque* Deque = &TaskQueue->Workers[WorkerIndex].Deque;
+        if ((s64)Platform_AtomicLoad64(&Deque->Top) < (s64)Platform_AtomicLoad64(&Deque->Bottom))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+internal b8
+TaskQueue_StealTask(platform_task_queue* TaskQueue, task_queue_worker* Thief, task_queue_task* OutTask)
+{
+    b8 LostAnyRace;
+    do
+    {
+        LostAnyRace = false;
+
+        // NOTE(Traian): Start from a random victim, so that the thieves don't all contend on the same deque.
+        Thief->RandomState ^= Thief->RandomState << 13;
+        Thief->RandomState ^= Thief->RandomState >> 17;
+        Thief->RandomState ^= Thief->RandomState << 5;
+        const u32 FirstVictimIndex = Thief->RandomState % TaskQueue->WorkerCount;
+
+        for (u32 Offset = 0; Offset < TaskQueue->WorkerCount; ++Offset)
+        {
+            task_queue_worker* Victim = TaskQueue->Workers + ((FirstVictimIndex + Offset) % TaskQueue->WorkerCount);
+            if (Victim == Thief)
+            {
+                continue;
+            }
+
+            const task_queue_steal_result StealResult = TaskQueue_Deque_Steal(&Victim->Deque, OutTask);
+            if (StealResult == TASK_QUEUE_STEAL_RESULT_STOLEN)
+            {
+                return true;
+            }
+            if (StealResult == TASK_QUEUE_STEAL_RESULT_LOST_RACE)
+            {
+                LostAnyRace = true;
+            }
+        }
+    }
+    while (LostAnyRace);
+
+    return false;
+}
+
+internal void
+TaskQueue_ExecuteTask(platform_task_queue* TaskQueue, task_queue_worker* Worker, task_queue_task Task)
+{
+    if (Task.TaskFunction)
+    {
+        Task.TaskFunction(Worker->LogicalIndex, Task.UserData);
+    }
+
+    if (Task.TaskGroup)
+    {
+        if (Platform_AtomicAdd32(&Task.TaskGroup->UnfinishedTaskCount, (u32)-1) == 0)
+        {
+            // NOTE(Traian): Wake up the threads waiting for the group (any thread can wait for a group). The group
+            // might already be out of scope at this point, but waking an address never dereferences it.
+            Platform_WakeAllOnAddress32(&Task.TaskGroup->UnfinishedTaskCount);
+        }
+    }
+
+    const u32 UnfinishedTaskCount = Platform_AtomicAdd32(&TaskQueue->UnfinishedTaskCount, (u32)-1);
+    if (UnfinishedTaskCount == 0 && Worker->LogicalIndex != -1)
+    {
+        // NOTE(Traian): Wake up the main thread, in case it is waiting for all tasks to finish.
+        Platform_WakeAllOnAddress32(&TaskQueue->UnfinishedTaskCount);
+    }
+}
+
+internal b8
+TaskQueue_RunNextTask(platform_task_queue* TaskQueue, task_queue_worker* Worker)
+{
+    task_queue_task Task;
+    if (!TaskQueue_Deque_Pop(&Worker->Deque, &Task) && !TaskQueue_StealTask(TaskQueue, Worker, &Task))
+    {
+        return false;
+    }
+
+    TaskQueue_ExecuteTask(TaskQueue, Worker, Task);
+    return true;
+}
+
+internal void
+TaskQueue_SignalWorkAvailable(platform_task_queue* TaskQueue)
+{
+    Platform_AtomicAdd32(&TaskQueue->WorkAvailableCount, 1);
+    Platform_WakeOneOnAddress32(&TaskQueue->WorkAvailableCount);
+}
+
+internal void
+TaskQueue_WaitForWorkAvailable(platform_task_queue* TaskQueue)
+{
+    while (true)
+    {
+        const u32 WorkAvailableCount = Platform_AtomicLoad32(&TaskQueue->WorkAvailableCount);
+        if (WorkAvailableCount == 0)
+        {
+            Platform_WaitOnAddress32(&TaskQueue->WorkAvailableCount, 0);
+            continue;
+        }
+
+        if (Platform_AtomicCompareExchange32(&TaskQueue->WorkAvailableCount, WorkAvailableCount - 1,
+                                             WorkAvailableCount) == WorkAvailableCount)
+        {
+            break;
+        }
+    }
+}
+
+internal b8
+TaskQueue_TryClaimParkedThread(platform_task_queue* TaskQueue)
+{
+    u32 ParkedThreadCount = Platform_AtomicLoad32(&TaskQueue->ParkedThreadCount);
+    while (ParkedThreadCount > 0)
+    {
+        const u32 ActualParkedThreadCount = Platform_AtomicCompareExchange32(&TaskQueue->ParkedThreadCount,
+                                                                             ParkedThreadCount - 1,
+                                                                             ParkedThreadCount);
+        if (ActualParkedThreadCount == ParkedThreadCount)
+        {
+            return true;
+        }
+        ParkedThreadCount = ActualParkedThreadCount;
+    }
+    return false;
+}
+
+internal void
+TaskQueue_WakeParkedThread(platform_task_queue* TaskQueue)
+{
+    // NOTE(Traian): Claim one parked thread and signal the semaphore on its behalf. Claiming before signaling keeps the
+    // semaphore count bounded by the number of parked threads, so no thread is ever woken up for nothing.
+    if (TaskQueue_TryClaimParkedThread(TaskQueue))
+    {
+        TaskQueue_SignalWorkAvailable(TaskQueue);
+    }
+}
+
+internal void
+TaskQueue_Park(platform_task_queue* TaskQueue)
+{
+    Platform_AtomicAdd32(&TaskQueue->ParkedThreadCount, 1);
+
+    // NOTE(Traian): A task might have been pushed after the last steal attempt, but before this thread was counted as
+    // parked (in which case the pushing thread didn't signal anything). Check once more before going to sleep.
+    if (TaskQueue_HasQueuedTasks(TaskQueue))
+    {
+        if (TaskQueue_TryClaimParkedThread(TaskQueue))
+        {
+            return;
+        }
+
+        // NOTE(Traian): A pushing thread has already claimed this thread and the semaphore is (or is about to be)
+        // signaled, so consume that signal instead of leaving it around.
+    }
+
+    TaskQueue_WaitForWorkAvailable(TaskQueue);
+}
+
+internal void
+TaskQueue_PublishTask(platform_task_queue* TaskQueue, task_queue_worker* Worker, task_queue_task Task)
+{
+    if (!TaskQueue_Deque_Push(&Worker->Deque, Task))
+    {
+        // NOTE(Traian): The deque of this thread is full, so there is already more than enough work available for
+        // all the other threads. Instead of blocking (or dropping the task), execute it immediately.
+        TaskQueue_ExecuteTask(TaskQueue, Worker, Task);
+        return;
+    }
+
+    // NOTE(Traian): Pairs with the parked thread count increment in 'TaskQueue_Park' - either the parking thread sees
+    // the task that was just pushed, or this thread sees the parked thread and wakes it up.
+    Platform_MemoryBarrier();
+    TaskQueue_WakeParkedThread(TaskQueue);
+}
+
+internal void
+TaskQueue_WorkerThreadProcedure(void* OpaqueWorker)
+{
+    task_queue_worker* Worker = (task_queue_worker*)OpaqueWorker;
+    platform_task_queue* TaskQueue = Worker->TaskQueue;
+    TaskQueue_CurrentWorker = Worker;
+
+    while (true)
+    {
+        // NOTE(Traian): Try to execute tasks until none are available.
+        while (TaskQueue_RunNextTask(TaskQueue, Worker));
+
+        // NOTE(Traian): Spin for a short while before parking, as tasks are usually pushed in bursts.
+        b8 FoundTask = false;
+        for (u32 SpinIndex = 0; SpinIndex < TASK_QUEUE_STEAL_SPIN_COUNT && !FoundTask; ++SpinIndex)
+        {
+            Platform_SpinPause();
+            FoundTask = TaskQueue_RunNextTask(TaskQueue, Worker);
+        }
+
+        if (!FoundTask)
+        {
+            // NOTE(Traian): No tasks are currently available. Instead of busy-waiting and wasting the system
+            // resources, put this thread to "sleep" until a new task is pushed.
+            TaskQueue_Park(TaskQueue);
+        }
+    }
+}
+
+function platform_task_queue*
+PlatformTaskQueue_Create(memory_arena* Arena)
+{
+    platform_task_queue* TaskQueue = PUSH(Arena, platform_task_queue);
+    ZERO_STRUCT_POINTER(TaskQueue);
+
+    //
+    // NOTE(Traian): Determine the number of threads.
+    //
+
+    const u32 ProcessorCount = Platform_GetProcessorCount();
+    const f32 MAX_SYSTEM_USAGE_PERCENTAGE = 0.8F;
+    // NOTE(Traian): One thread is the main thread, which should not be included the the thread pool of the task queue.
+    TaskQueue->ThreadCount = (u32)(ProcessorCount * MAX_SYSTEM_USAGE_PERCENTAGE);
+    if (TaskQueue->ThreadCount < 1)
+    {
+        TaskQueue->ThreadCount = 1;
+    }
+
+    //
+    // NOTE(Traian): Allocate the workers and their deques. This must happen before the threads are created, as they
+    // immediately start stealing from each other.
+    //
+
+    TaskQueue->WorkerCount = TaskQueue->ThreadCount + 1;
+    TaskQueue->Workers = PUSH_ARRAY(Arena, task_queue_worker, TaskQueue->WorkerCount);
+    for (u32 WorkerIndex = 0; WorkerIndex < TaskQueue->WorkerCount; ++WorkerIndex)
+    {
+        task_queue_worker* Worker = TaskQueue->Workers + WorkerIndex;
+        ZERO_STRUCT_POINTER(Worker);
+        Worker->Deque.Tasks = PUSH_ARRAY(Arena, task_queue_task, TASK_QUEUE_DEQUE_CAPACITY);
+        Worker->TaskQueue = TaskQueue;
+        Worker->LogicalIndex = (WorkerIndex < TaskQueue->ThreadCount) ? (s32)WorkerIndex : -1;
+        Worker->RandomState = 0x9E3779B9 * (WorkerIndex + 1);
+    }
+
+    // NOTE(Traian): The thread that creates the task queue is the main thread.
+    TaskQueue_CurrentWorker = TaskQueue->Workers + TaskQueue->ThreadCount;
+
+    //
+    // NOTE(Traian): Create the threads.
+    //
+
+    for (u32 ThreadIndex = 0; ThreadIndex < TaskQueue->ThreadCount; ++ThreadIndex)
+    {
+        task_queue_worker* Worker = TaskQueue->Workers + ThreadIndex;
+        Worker->Thread.ThreadFunction = TaskQueue_WorkerThreadProcedure;
+        Worker->Thread.UserData = Worker;
+        Platform_CreateThread(&Worker->Thread);
+    }
+
+    return TaskQueue;
+}
+
+function void
+PlatformTaskQueue_Push(platform_task_queue* TaskQueue, platform_task_pfn TaskFunction, void* UserData,
+                       platform_task_group* TaskGroup)
+{
+    // NOTE(Traian): Tasks can only be pushed by the main thread or from inside other tasks.
+    task_queue_worker* Worker = TaskQueue_CurrentWorker;
+    ASSERT(Worker && Worker->TaskQueue == TaskQueue);
+
+    task_queue_task Task = {};
+    Task.TaskFunction = TaskFunction;
+    Task.UserData = UserData;
+    Task.TaskGroup = TaskGroup;
+
+    // NOTE(Traian): The unfinished task counts must be incremented before the task is published, otherwise a worker
+    // could finish the task (and decrement the counters) before they were ever incremented.
+    if (TaskGroup)
+    {
+        Platform_AtomicAdd32(&TaskGroup->UnfinishedTaskCount, 1);
+    }
+    Platform_AtomicAdd32(&TaskQueue->UnfinishedTaskCount, 1);
+
+    TaskQueue_PublishTask(TaskQueue, Worker, Task);
+}
+
+function void
+PlatformTaskQueue_WaitForAll(platform_task_queue* TaskQueue)
+{
+    task_queue_worker* Worker = TaskQueue_CurrentWorker;
+    ASSERT(Worker && Worker->TaskQueue == TaskQueue);
+
+    while (true)
+    {
+        // NOTE(Traian): Convert this thread to a worker thread until there are no tasks left to execute.
+        while (TaskQueue_RunNextTask(TaskQueue, Worker));
+
+        // NOTE(Traian): The remaining tasks are being executed by other threads. Sleep until the unfinished task
+        // count changes, instead of busy-waiting for it to reach zero.
+        const u32 UnfinishedTaskCount = Platform_AtomicLoad32(&TaskQueue->UnfinishedTaskCount);
+        if (UnfinishedTaskCount == 0)
+        {
+            break;
+        }
+        Platform_WaitOnAddress32(&TaskQueue->UnfinishedTaskCount, UnfinishedTaskCount);
+    }
+}
+
+function void
+PlatformTaskQueue_WaitForGroup(platform_task_queue* TaskQueue, platform_task_group* TaskGroup)
+{
+    task_queue_worker* Worker = TaskQueue_CurrentWorker;
+    ASSERT(Worker && Worker->TaskQueue == TaskQueue);
+
+    //
+    // NOTE(Traian): Help executing the tasks of the group while waiting, one at a time, so that this function returns
+    // as soon as the group is finished. Only the tasks of the group that are still at the bottom of the deque of this
+    // thread (the ones it pushed last) are executed, and never any other task. Otherwise, a long task (such as an asset
+    // load that was queued by the main thread) could be popped or stolen here and executed in the middle of a frame.
+    // The tasks of the group that are deeper in the deque are stolen by the other threads, as they steal from the top.
+    //
+
+    b8 MightOwnGroupTasks = true;
+    while (true)
+    {
+        const u32 UnfinishedTaskCount = Platform_AtomicLoad32(&TaskGroup->UnfinishedTaskCount);
+        if (UnfinishedTaskCount == 0)
+        {
+            break;
+        }
+
+        if (MightOwnGroupTasks)
+        {
+            task_queue_task Task;
+            if (TaskQueue_Deque_Pop(&Worker->Deque, &Task))
+            {
+                if (Task.TaskGroup == TaskGroup)
+                {
+                    TaskQueue_ExecuteTask(TaskQueue, Worker, Task);
+                    continue;
+                }
+
+                // NOTE(Traian): The task belongs to somebody else, so put it back for the other threads to steal. The
+                // slot it was popped from is free, so it always fits.
+                TaskQueue_PublishTask(TaskQueue, Worker, Task);
+            }
+
+            // NOTE(Traian): Nothing is pushed into the deque while waiting, so there is no point in checking it again.
+            MightOwnGroupTasks = false;
+            continue;
+        }
+
+        // NOTE(Traian): The remaining tasks of the group are being executed by other threads.
+        Platform_WaitOnAddress32(&TaskGroup->UnfinishedTaskCount, UnfinishedTaskCount);
+    }
+}
+
+function u32
+PlatformTaskQueue_GetThreadCount(platform_task_queue* TaskQueue)
+{
+    return TaskQueue->WorkerCount;
+}
+
+struct task_queue_parallel_for_job
+{
+    platform_parallel_for_pfn   Function;
+    void*                       UserData;
+    u32                         Count;
+    u32                         Grain;
+    alignas(64) volatile u64    NextIndex;
+};
+
+internal void
+TaskQueue_ParallelForTask(s32 ThreadLogicalIndex, void* OpaqueJob)
+{
+    task_queue_parallel_for_job* Job = (task_queue_parallel_for_job*)OpaqueJob;
+    while (true)
+    {
+        const u64 FirstIndex = Platform_AtomicAdd64(&Job->NextIndex, Job->Grain) - Job->Grain;
+        if (FirstIndex >= Job->Count)
+        {
+            break;
+        }
+
+        const u64 EndIndex = (FirstIndex + Job->Grain < Job->Count) ? (FirstIndex + Job->Grain) : Job->Count;
+        Job->Function(ThreadLogicalIndex, (u32)FirstIndex, (u32)EndIndex, Job->UserData);
+    }
+}
+
+function void
+PlatformTaskQueue_ParallelFor(platform_task_queue* TaskQueue, u32 Count, u32 Grain,
+                              platform_parallel_for_pfn Function, void* UserData)
+{
+    task_queue_worker* Worker = TaskQueue_CurrentWorker;
+    ASSERT(Worker && Worker->TaskQueue == TaskQueue);
+
+    if (Count == 0)
+    {
+        return;
+    }
+
+    task_queue_parallel_for_job Job = {};
+    Job.Function = Function;
+    Job.UserData = UserData;
+    Job.Count = Count;
+    Job.Grain = (Grain > 0) ? Grain : 1;
+    Job.NextIndex = 0;
+
+    // NOTE(Traian): Instead of pushing one task per chunk, push (at most) one task per thread. Each task pulls chunks
+    // from the shared index until none remain, so the threads balance the load between themselves.
+    const u32 ChunkCount = (u32)(((u64)Count + Job.Grain - 1) / Job.Grain);
+    const u32 HelperTaskCount = ((ChunkCount < TaskQueue->WorkerCount) ? ChunkCount : TaskQueue->WorkerCount) - 1;
+
+    platform_task_group TaskGroup = {};
+    for (u32 HelperTaskIndex = 0; HelperTaskIndex < HelperTaskCount; ++HelperTaskIndex)
+    {
+        PlatformTaskQueue_Push(TaskQueue, TaskQueue_ParallelForTask, &Job, &TaskGroup);
+    }
+
+    // NOTE(Traian): The calling thread processes chunks as well. The job lives on the stack of this function, which
+    // is safe because the helper tasks are guaranteed to finish before it returns.
+    TaskQueue_ParallelForTask(Worker->LogicalIndex, &Job);
+    PlatformTaskQueue_WaitForGroup(TaskQueue, &TaskGroup);
+}
@@ -13,194 +13,140 @@ Platform_Panic(const char* Message)
 }
 
 //====================================================================================================================//
-//---------------------------------------------------- TASK QUEUE ----------------------------------------------------//
+//------------------------------------------------------ ATOMICS -----------------------------------------------------//
 //====================================================================================================================//
 
-struct win32_task_thread_info
+function u32
+Platform_AtomicCompareExchange32(volatile u32* Destination, u32 Exchange, u32 Comparand)
 {
-    HANDLE                  Handle;
-    DWORD                   PlatformID;
-    platform_task_queue*    TaskQueue;
-    u32                     LogicalIndex;
-};
+    const u32 Result = (u32)InterlockedCompareExchange((volatile LONG*)Destination, (LONG)Exchange, (LONG)Comparand);
+    return Result;
+}
 
-enum win32_task_entry_state : u8
+function u32
+Platform_AtomicExchange32(volatile u32* Destination, u32 Value)
 {
-    WIN32_TASK_ENTRY_STATE_AVAILABLE = 0,
-    WIN32_TASK_ENTRY_STATE_PENDING_EXECUTION,
-    WIN32_TASK_ENTRY_STATE_IN_EXECUTION,
-};
+    const u32 Result = (u32)InterlockedExchange((volatile LONG*)Destination, (LONG)Value);
+    return Result;
+}
 
-struct win32_task_entry
+function u32
+Platform_AtomicAdd32(volatile u32* Destination, u32 Addend)
 {
-    win32_task_entry_state  State;
-    platform_task_pfn       TaskFunction;
-    void*                   UserData;
-};
+    const u32 Result = (u32)InterlockedAdd((volatile LONG*)Destination, (LONG)Addend);
+    return Result;
+}
 
-struct platform_task_queue
+function u32
+Platform_AtomicLoad32(volatile u32* Source)
 {
-    HANDLE                  TasksAvailableSemaphore;
-    u32                     ThreadCount;
-    win32_task_thread_info* Threads;
-    u32                     EntryCount;
-    win32_task_entry*       Entries;
-    volatile LONG64         NextEntryIndexToDispatch;
-    volatile LONG64         CurrentEntryIndex;
-    volatile LONG           UnfinishedTaskCount;
-};
+    // NOTE(Traian): On x64, aligned loads already have acquire semantics, so only the compiler has to be restrained.
+    const u32 Result = *Source;
+    _ReadWriteBarrier();
+    return Result;
+}
 
-enum win32_dispatch_task_result : u8
+function void
+Platform_AtomicStore32(volatile u32* Destination, u32 Value)
 {
-    WIN32_DISPATCH_TASK_RESULT_DISPATCHED,
-    WIN32_DISPATCH_TASK_RESULT_NO_AVAILABLE_TASKS,
-    WIN32_DISPATCH_TASK_RESULT_INDEX_ALREADY_ACQUIRED,
-};
+    // NOTE(Traian): On x64, aligned stores already have release semantics, so only the compiler has to be restrained.
+    _ReadWriteBarrier();
+    *Destination = Value;
+}
 
-internal win32_dispatch_task_result
-Win32_DispatchNextTask(platform_task_queue* TaskQueue, s32 ThreadLogicalIndex)
+function u64
+Platform_AtomicCompareExchange64(volatile u64* Destination, u64 Exchange, u64 Comparand)
 {
-    win32_dispatch_task_result DispatchResult;
-    const u64 EntryIndexToDispatch = TaskQueue->NextEntryIndexToDispatch;
-    
-    if (EntryIndexToDispatch < TaskQueue->CurrentEntryIndex)
-    {
-        const u64 ActualEntryIndex = InterlockedCompareExchange64(&TaskQueue->NextEntryIndexToDispatch,
-                                                                  TaskQueue->NextEntryIndexToDispatch + 1,
-                                                                  EntryIndexToDispatch);
-        if (EntryIndexToDispatch == ActualEntryIndex)
-        {
-            // NOTE(Traian): This thread has acquired the entry with index 'EntryIndexToDispatch'.
-            win32_task_entry* Task = TaskQueue->Entries + (EntryIndexToDispatch % TaskQueue->EntryCount);
-            ASSERT(Task->State == WIN32_TASK_ENTRY_STATE_PENDING_EXECUTION);
-            Task->State = WIN32_TASK_ENTRY_STATE_IN_EXECUTION;
-            
-            if (Task->TaskFunction)
-            {
-                Task->TaskFunction(ThreadLogicalIndex, Task->UserData);
-            }
-            
-            Task->State = WIN32_TASK_ENTRY_STATE_AVAILABLE;
-            InterlockedDecrement(&TaskQueue->UnfinishedTaskCount);
-            
-            DispatchResult = WIN32_DISPATCH_TASK_RESULT_DISPATCHED;
-        }
-        else
-        {
-            DispatchResult = WIN32_DISPATCH_TASK_RESULT_INDEX_ALREADY_ACQUIRED;
-        }
-    }
-    else
-    {
-        DispatchResult = WIN32_DISPATCH_TASK_RESULT_NO_AVAILABLE_TASKS;
-    }
-
-    return DispatchResult;
+    const u64 Result = (u64)InterlockedCompareExchange64((volatile LONG64*)Destination,
+                                                         (LONG64)Exchange, (LONG64)Comparand);
+    return Result;
 }
 
-internal DWORD CALLBACK
-Win32_TaskQueueThreadProcedure(void* OpaqueThreadInfo)
+function u64
+Platform_AtomicAdd64(volatile u64* Destination, u64 Addend)
 {
-    win32_task_thread_info* ThreadInfo = (win32_task_thread_info*)OpaqueThreadInfo;
-    platform_task_queue* TaskQueue = ThreadInfo->TaskQueue;
-    
-    while (true)
-    {
-        // NOTE(Traian): Try to dispatch tasks until none are available.
-        while (Win32_DispatchNextTask(TaskQueue, ThreadInfo->LogicalIndex) != WIN32_DISPATCH_TASK_RESULT_NO_AVAILABLE_TASKS);
-        
-        // NOTE(Traian): No tasks are currently available. Instead of busy-waiting and wasting the system resources,
-        // put this thread to "sleep" until the tasks available semaphore is signaled.
-        WaitForSingleObject(TaskQueue->TasksAvailableSemaphore, INFINITE);
-    }
-
-    return 0;
+    const u64 Result = (u64)InterlockedAdd64((volatile LONG64*)Destination, (LONG64)Addend);
+    return Result;
 }
 
-internal void
-Win32_PlatformTaskQueue_Initialize(platform_task_queue* TaskQueue, memory_arena* Arena)
+function u64
+Platform_AtomicLoad64(volatile u64* Source)
 {
-    ZERO_STRUCT_POINTER(TaskQueue);
-
-    //
-    // NOTE(Traian): Allocate the task entries.
-    //
-
-    TaskQueue->EntryCount = 32;
-    TaskQueue->Entries = PUSH_ARRAY(Arena, win32_task_entry, TaskQueue->EntryCount);
-
-    //
-    // NOTE(Traian): Determine the number of threads and create their handles.
-    //
-
-    SYSTEM_INFO SystemInfo = {};
-    GetSystemInfo(&SystemInfo);
-    const u32 HardwareThreadCount = SystemInfo.dwNumberOfProcessors;
+    const u64 Result = *Source;
+    _ReadWriteBarrier();
+    return Result;
+}
 
-    const f32 MAX_SYSTEM_USAGE_PERCENTAGE = 0.8F;
-    // NOTE(Traian): One thread is the main thread, which should not be included the the thread pool of the task queue.
-    TaskQueue->ThreadCount = Max(1, (u32)(HardwareThreadCount * MAX_SYSTEM_USAGE_PERCENTAGE));
-    TaskQueue->Threads = PUSH_ARRAY(Arena, win32_task_thread_info, TaskQueue->ThreadCount);
-    for (u32 ThreadIndex = 0; ThreadIndex < TaskQueue->ThreadCount; ++ThreadIndex)
-    {
-        win32_task_thread_info* ThreadInfo = TaskQueue->Threads + ThreadIndex;
-        ThreadInfo->Handle = CreateThread(NULL, MEGABYTES(1), Win32_TaskQueueThreadProcedure, ThreadInfo,
-                                          CREATE_SUSPENDED, &ThreadInfo->PlatformID);
-        if (ThreadInfo->Handle == NULL)
-        {
-            PANIC("Failed to create the Win32 thread for the platform task queue!");
-        }
+function void
+Platform_AtomicStore64(volatile u64* Destination, u64 Value)
+{
+    _ReadWriteBarrier();
+    *Destination = Value;
+}
 
-        ThreadInfo->TaskQueue = TaskQueue;
-        ThreadInfo->LogicalIndex = ThreadIndex;
+function void
+Platform_MemoryBarrier()
+{
+    MemoryBarrier();
+}
 
-        ResumeThread(ThreadInfo->Handle);
-    }
+function void
+Platform_SpinPause()
+{
+    YieldProcessor();
+}
 
-    //
-    // NOTE(Traian): Initialize the task queue counters.
-    //
+//====================================================================================================================//
+//----------------------------------------------------- THREADING ----------------------------------------------------//
+//====================================================================================================================//
 
-    TaskQueue->NextEntryIndexToDispatch = 0;
-    TaskQueue->CurrentEntryIndex = 0;
-    TaskQueue->UnfinishedTaskCount = 0;
+function void
+Platform_WaitOnAddress32(volatile u32* Address, u32 ExpectedValue)
+{
+    WaitOnAddress(Address, &ExpectedValue, sizeof(u32), INFINITE);
+}
 
-    TaskQueue->TasksAvailableSemaphore = CreateSemaphore(NULL, 0, TaskQueue->EntryCount, NULL);
-    if (TaskQueue->TasksAvailableSemaphore == NULL)
-    {
-        PANIC("Failed to create the Win32 semaphore that orchestrates the platform task queue!");
-    }
+function void
+Platform_WakeOneOnAddress32(volatile u32* Address)
+{
+    WakeByAddressSingle((void*)Address);
 }
 
 function void
-PlatformTaskQueue_Push(platform_task_queue* TaskQueue, platform_task_pfn TaskFunction, void* UserData)
+Platform_WakeAllOnAddress32(volatile u32* Address)
 {
-    const u32 EntryIndex = TaskQueue->CurrentEntryIndex % TaskQueue->EntryCount;
-    win32_task_entry* Entry = TaskQueue->Entries + EntryIndex;
-    ASSERT(Entry->State == WIN32_TASK_ENTRY_STATE_AVAILABLE);
-    
-    Entry->State = WIN32_TASK_ENTRY_STATE_PENDING_EXECUTION;
-    Entry->TaskFunction = TaskFunction;
-    Entry->UserData = UserData;
-    
-    TaskQueue->CurrentEntryIndex++;
-    ReleaseSemaphore(TaskQueue->TasksAvailableSemaphore, 1, NULL);
-    
-    InterlockedIncrement(&TaskQueue->UnfinishedTaskCount);
+    WakeByAddressAll((void*)Address);
+}
+
+internal DWORD CALLBACK
+Win32_ThreadProcedure(void* OpaqueThread)
+{
+    platform_thread* Thread = (platform_thread*)OpaqueThread;
+    Thread->ThreadFunction(Thread->UserData);
+    return 0;
 }
 
 function void
-PlatformTaskQueue_WaitForAll(platform_task_queue* TaskQueue)
+Platform_CreateThread(platform_thread* Thread)
 {
-    // NOTE(Traian): Convert this thread to a worker thread and don't exit this
-    // loop until there are no pending-execution tasks.
-    while (Win32_DispatchNextTask(TaskQueue, -1) != WIN32_DISPATCH_TASK_RESULT_NO_AVAILABLE_TASKS) {}
-    
-    // NOTE(Traian): With the current way the async task queue is implemented, some busy-waiting will happen,
-    // as long as we don't introduce other synchronization primitives.
-    while (TaskQueue->UnfinishedTaskCount > 0) {}
+    HANDLE Handle = CreateThread(NULL, MEGABYTES(1), Win32_ThreadProcedure, Thread, 0, NULL);
+    if (Handle == NULL)
+    {
+        PANIC("Failed to create a Win32 thread!");
+    }
+
+    // NOTE(Traian): The thread is never joined, so its handle is not needed.
+    CloseHandle(Handle);
 }
 
+function u32
+Platform_GetProcessorCount()
+{
+    SYSTEM_INFO SystemInfo = {};
+    GetSystemInfo(&SystemInfo);
+    const u32 Result = (SystemInfo.dwNumberOfProcessors > 0) ? (u32)SystemInfo.dwNumberOfProcessors : 1;
+    return Result;
+}
 
 //====================================================================================================================//
 //----------------------------------------------------- FILE API -----------------------------------------------------//
@@ -383,6 +329,46 @@ Platform_ReadFromFile(platform_file_handle FileHandle,
     return Result;
 }
 
+function platform_map_file_result
+Platform_MapFile(platform_file_handle FileHandle)
+{
+    win32_file_descriptor FileDescriptor = Win32_GetDescriptorFromFileHandle(FileHandle);
+    platform_map_file_result Result = {};
+    Result.IsValid = false;
+
+    // NOTE(Traian): Mapping a zero-sized file is not allowed by 'CreateFileMapping'.
+    if (Platform_IsFileHandleValid(FileHandle) && FileDescriptor.FileHandle != NULL && FileDescriptor.FileSize > 0)
+    {
+        HANDLE FileMappingHandle = CreateFileMappingA(FileDescriptor.FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (FileMappingHandle)
+        {
+            void* MappedData = MapViewOfFile(FileMappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+            // NOTE(Traian): The mapped view keeps a reference to the file mapping object, so the handle can be closed
+            // right away. The mapping object is destroyed once the view is unmapped.
+            CloseHandle(FileMappingHandle);
+
+            if (MappedData)
+            {
+                Result.IsValid = true;
+                Result.MappedData = MappedData;
+                Result.MappedByteCount = FileDescriptor.FileSize;
+            }
+        }
+    }
+
+    return Result;
+}
+
+function void
+Platform_UnmapFile(void* MappedData, memory_size MappedByteCount)
+{
+    if (MappedData)
+    {
+        UnmapViewOfFile(MappedData);
+    }
+}
+
 //====================================================================================================================//
 //----------------------------------------------------- GAME LOOP ----------------------------------------------------//
 //====================================================================================================================//
@@ -466,6 +452,7 @@ Win32_ReallocateOffscreenBitmap(win32_offscreen_bitmap* Bitmap, HWND WindowHandl
     {
         Bitmap->Image.SizeX = WindowSizeX;
         Bitmap->Image.SizeY = WindowSizeY;
+        Bitmap->Image.Stride = WindowSizeX;
         Bitmap->Image.Format = RENDERER_IMAGE_FORMAT_B8G8R8A8;
         const memory_size PixelBufferByteCount = Image_GetPixelBufferByteCount(Bitmap->Image.SizeX,
                                                                                Bitmap->Image.SizeY,
@@ -655,11 +642,11 @@ WinMain(HINSTANCE Instance, HINSTANCE PreviousInstance, LPSTR CommandLine, INT S
 
         // NOTE(Traian): Allocate the game memory.
         memory_arena PermanentArena = {};
-        PermanentArena.ByteCount = MEGABYTES(6);
+        PermanentArena.ByteCount = MEGABYTES(32);
         PermanentArena.MemoryBlock = VirtualAlloc(NULL, PermanentArena.ByteCount,
                                                   MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
         memory_arena TransientArena = {};
-        TransientArena.ByteCount = MEGABYTES(32);
+        TransientArena.ByteCount = MEGABYTES(64);
         TransientArena.MemoryBlock = VirtualAlloc(NULL, TransientArena.ByteCount,
                                                   MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
         platform_game_memory GameMemory = {};
@@ -667,11 +654,10 @@ WinMain(HINSTANCE Instance, HINSTANCE PreviousInstance, LPSTR CommandLine, INT S
         GameMemory.TransientArena = &TransientArena;
 
         // NOTE(Traian): Create the platform task queue.
-        platform_task_queue TaskQueue = {};
-        Win32_PlatformTaskQueue_Initialize(&TaskQueue, GameMemory.PermanentArena);
+        platform_task_queue* TaskQueue = PlatformTaskQueue_Create(GameMemory.PermanentArena);
 
         // NOTE(Traian): Initialize the game layer.
-        game_state* GameState = Game_Initialize(&GameMemory);
+        game_state* GameState = Game_Initialize(&GameMemory, TaskQueue);
 
         // NOTE(Traian): Initialize frame timers.
         const u64 PerformanceCounterFrequency = Win32_GetPerformanceCounterFrequency();
@@ -712,7 +698,7 @@ WinMain(HINSTANCE Instance, HINSTANCE PreviousInstance, LPSTR CommandLine, INT S
             game_platform_state PlatformState = {};
             PlatformState.Memory = &GameMemory;
             PlatformState.Input = &GameInputState;
-            PlatformState.TaskQueue = &TaskQueue;
+            PlatformState.TaskQueue = TaskQueue;
             PlatformState.RenderTarget = &OffscreenBitmap.Image;
             Game_UpdateAndRender(GameState, &PlatformState, LastFrameDeltaTime);
 
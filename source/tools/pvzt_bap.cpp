@@ -37,6 +37,7 @@ BAP_InternalPanicWithMessage(const char* Message)
 // TODO(Traian): Replace the 'fopen' and 'fwrite' calls with a custom file write stream!
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // NOTE(Traian): Currently, image and fonts are loaded from the raw data files using the STB libraries. Because this
 // tool only runs offline (when the game is packaged for distribution), there is no need for high-performant/custom
@@ -93,14 +94,102 @@ BAP_GetPixelBufferByteCount(u32 SizeX, u32 SizeY, memory_size BytesPerPixel)
     return Result;
 }
 
+// NOTE(Traian): The maximum number of mips that are generated for sprite textures and for font glyph textures.
+#define BAP_TEXTURE_MAX_MIP_COUNT   (6)
+#define BAP_GLYPH_MAX_MIP_COUNT     (4)
+
 struct bap_texture_buffer
 {
     u32         SizeX;
     u32         SizeY;
     memory_size BytesPerPixel;
+    u32         Flags;
+    // NOTE(Traian): The pixel buffer stores all the mips of the texture, one after another, starting with the full
+    // resolution mip. The size of each mip is half (rounded down) the size of the previous one.
+    u32         MipCount;
     void*       PixelBuffer;
 };
 
+internal inline memory_size
+BAP_GetMipChainByteCount(u32 SizeX, u32 SizeY, memory_size BytesPerPixel, u32 MipCount)
+{
+    memory_size Result = 0;
+    for (u32 MipLevel = 0; MipLevel < MipCount; ++MipLevel)
+    {
+        Result += BAP_GetPixelBufferByteCount(SizeX >> MipLevel, SizeY >> MipLevel, BytesPerPixel);
+    }
+    return Result;
+}
+
+//
+// NOTE(Traian): Generates the mip chain of a texture whose pixel buffer contains only the full resolution mip. Mips are
+// generated until either 'MaxMipCount' is reached or one of the dimensions would become zero, which is the same rule
+// the runtime used when it was building the mip chains at load time. Each texel of a mip is the rounded average of
+// the corresponding 2x2 block from the previous mip. As the textures are stored with premultiplied alpha, averaging
+// the channels independently is correct and transparent texels don't bleed their color into the lower mips.
+//
+internal void
+BAP_GenerateMipChain(bap_texture_buffer* TextureBuffer, u32 MaxMipCount)
+{
+    u32 MipCount = 1;
+    while (MipCount < MaxMipCount && (TextureBuffer->SizeX >> MipCount) > 0 && (TextureBuffer->SizeY >> MipCount) > 0)
+    {
+        ++MipCount;
+    }
+
+    const memory_size BytesPerPixel = TextureBuffer->BytesPerPixel;
+    const memory_size MipChainByteCount = BAP_GetMipChainByteCount(TextureBuffer->SizeX, TextureBuffer->SizeY,
+                                                                   BytesPerPixel, MipCount);
+    u8* MipChain = (u8*)malloc(MipChainByteCount > 0 ? MipChainByteCount : 1);
+    CopyMemory(MipChain, TextureBuffer->PixelBuffer,
+               BAP_GetPixelBufferByteCount(TextureBuffer->SizeX, TextureBuffer->SizeY, BytesPerPixel));
+
+    u8* SrcMip = MipChain;
+    for (u32 MipLevel = 1; MipLevel < MipCount; ++MipLevel)
+    {
+        const u32 SrcSizeX = TextureBuffer->SizeX >> (MipLevel - 1);
+        const u32 SrcSizeY = TextureBuffer->SizeY >> (MipLevel - 1);
+        const u32 DstSizeX = TextureBuffer->SizeX >> MipLevel;
+        const u32 DstSizeY = TextureBuffer->SizeY >> MipLevel;
+        u8* DstMip = SrcMip + BAP_GetPixelBufferByteCount(SrcSizeX, SrcSizeY, BytesPerPixel);
+
+        for (u32 DstPixelY = 0; DstPixelY < DstSizeY; ++DstPixelY)
+        {
+            const u8* SrcRow0 = SrcMip + ((memory_size)(2 * DstPixelY + 0) * SrcSizeX * BytesPerPixel);
+            const u8* SrcRow1 = SrcMip + ((memory_size)(2 * DstPixelY + 1) * SrcSizeX * BytesPerPixel);
+            u8* DstRow = DstMip + ((memory_size)DstPixelY * DstSizeX * BytesPerPixel);
+
+            for (u32 DstPixelX = 0; DstPixelX < DstSizeX; ++DstPixelX)
+            {
+                // NOTE(Traian): The channels of a pixel are all bytes, so each one is filtered on its own.
+                for (memory_size ChannelIndex = 0; ChannelIndex < BytesPerPixel; ++ChannelIndex)
+                {
+                    const memory_size SrcOffset0 = ((2 * DstPixelX + 0) * BytesPerPixel) + ChannelIndex;
+                    const memory_size SrcOffset1 = ((2 * DstPixelX + 1) * BytesPerPixel) + ChannelIndex;
+                    const u32 Sum = (u32)SrcRow0[SrcOffset0] + (u32)SrcRow0[SrcOffset1] +
+                                    (u32)SrcRow1[SrcOffset0] + (u32)SrcRow1[SrcOffset1];
+                    DstRow[(DstPixelX * BytesPerPixel) + ChannelIndex] = (u8)((Sum + 2) / 4);
+                }
+            }
+        }
+
+        SrcMip = DstMip;
+    }
+
+    free(TextureBuffer->PixelBuffer);
+    TextureBuffer->PixelBuffer = MipChain;
+    TextureBuffer->MipCount = MipCount;
+}
+
+internal inline u32
+BAP_PremultiplyChannel(u32 Channel, u32 Alpha)
+{
+    // NOTE(Traian): Computes 'Channel * Alpha / 255', rounded to the nearest integer.
+    const u32 Biased = (Channel * Alpha) + 128;
+    const u32 Result = (Biased + (Biased >> 8)) >> 8;
+    return Result;
+}
+
 internal bap_texture_buffer
 BAP_LoadTextureFromFile(const char* AssetRootDirectoryPath, const char* FileName, memory_size ExpectedBytesPerPixel)
 {
@@ -130,18 +219,31 @@ BAP_LoadTextureFromFile(const char* AssetRootDirectoryPath, const char* FileName
             u32* DstPixels = (u32*)TextureBuffer.PixelBuffer;
             const u32* SrcPixels = (const u32*)ImageData;
             const memory_size PixelCount = PixelBufferByteCount / TextureBuffer.BytesPerPixel;
+            b8 IsOpaque = true;
 
             for (memory_size PixelIndex = 0; PixelIndex < PixelCount; ++PixelIndex)
             {
                 // NOTE(Traian): STBI outputs the pixel data in RGBA format, but our renderer assumes all
                 // texture data is in the BGRA format. Convert the byte-ordering before packaging the asset.
+                // The color channels are also premultiplied by the alpha channel, which the renderer blends
+                // with a cheaper operator and which makes the bilinear filtering and the mip chain correct
+                // around the transparent edges of the sprites.
 
                 const u32 RGBAPixel = SrcPixels[PixelIndex];
-                const u32 BGRAPixel = ((RGBAPixel & 0x000000FF) << 16) |
-                                      ((RGBAPixel & 0x0000FF00) <<  0) |
-                                      ((RGBAPixel & 0x00FF0000) >> 16) |
-                                      ((RGBAPixel & 0xFF000000) >>  0);
+                const u32 A = (RGBAPixel >> 24) & 0xFF;
+                const u32 R = BAP_PremultiplyChannel((RGBAPixel >>  0) & 0xFF, A);
+                const u32 G = BAP_PremultiplyChannel((RGBAPixel >>  8) & 0xFF, A);
+                const u32 B = BAP_PremultiplyChannel((RGBAPixel >> 16) & 0xFF, A);
+                const u32 BGRAPixel = (B << 0) | (G << 8) | (R << 16) | (A << 24);
                 DstPixels[PixelIndex] = BGRAPixel;
+                IsOpaque = IsOpaque && (A == 0xFF);
+            }
+
+            TextureBuffer.Flags |= ASSET_TEXTURE_FLAG_PREMULTIPLIED_ALPHA;
+            if (IsOpaque)
+            {
+                // NOTE(Traian): The mips are averages of opaque pixels, so they are opaque as well.
+                TextureBuffer.Flags |= ASSET_TEXTURE_FLAG_OPAQUE;
             }
         }
         else
@@ -149,6 +251,8 @@ BAP_LoadTextureFromFile(const char* AssetRootDirectoryPath, const char* FileName
             PANIC("Invalid/unsupported texture bytes per pixel value!");
         }
 
+        BAP_GenerateMipChain(&TextureBuffer, BAP_TEXTURE_MAX_MIP_COUNT);
+
         stbi_image_free(ImageData);
         free(ReadResult.FileData);
         return TextureBuffer;
@@ -170,20 +274,98 @@ struct bap_font_glyph
     s32                 LeftSideBearing;
     s32                 TextureOffsetX;
     s32                 TextureOffsetY;
+    u32                 AtlasOffsetX;
+    u32                 AtlasOffsetY;
+    // NOTE(Traian): Only the full resolution glyph bitmap. The mips are generated for the whole atlas.
     bap_texture_buffer  Texture;
 };
 
 struct bap_font_buffer
 {
-    f32             Height;
-    s32             Ascent;
-    s32             Descent;
-    s32             LineGap;
-    u32             GlyphCount;
-    bap_font_glyph* Glyphs;
-    s32*            KerningTable;
+    f32                         Height;
+    s32                         Ascent;
+    s32                         Descent;
+    s32                         LineGap;
+    u32                         GlyphCount;
+    bap_font_glyph*             Glyphs;
+    // NOTE(Traian): Stored exactly as in the asset file (see 'asset_font::KerningPairOffsets').
+    u32*                        KerningPairOffsets;
+    u32                         KerningPairCount;
+    asset_font_kerning_pair*    KerningPairs;
+    u32                         FirstCodepoint;
+    u32                         CodepointCount;
+    u32*                        GlyphIndices;
+    bap_texture_buffer          Atlas;
 };
 
+// NOTE(Traian): The glyphs are packed in rows into an atlas of this width.
+#define BAP_FONT_ATLAS_SIZE_X (512)
+
+//
+// NOTE(Traian): Packs the bitmaps of all glyphs into a single atlas texture and generates its mip chain. Every glyph
+// starts on a multiple of the mip block size (the number of texels that the last mip collapses into one) and glyphs
+// are separated by at least that many empty texels, so a texel of any mip never contains pixels from two glyphs.
+//
+internal void
+BAP_PackFontAtlas(bap_font_buffer* FontBuffer)
+{
+    const u32 MipBlockSize = 1 << (BAP_GLYPH_MAX_MIP_COUNT - 1);
+    const u32 Padding = MipBlockSize;
+
+    u32 CursorX = 0;
+    u32 CursorY = 0;
+    u32 RowSizeY = 0;
+    for (u32 GlyphIndex = 0; GlyphIndex < FontBuffer->GlyphCount; ++GlyphIndex)
+    {
+        bap_font_glyph* Glyph = FontBuffer->Glyphs + GlyphIndex;
+        if (Glyph->Texture.SizeX == 0 || Glyph->Texture.SizeY == 0)
+        {
+            continue;
+        }
+        if (Glyph->Texture.SizeX > BAP_FONT_ATLAS_SIZE_X)
+        {
+            PANIC("A glyph is wider than the font atlas!");
+        }
+
+        if (CursorX + Glyph->Texture.SizeX > BAP_FONT_ATLAS_SIZE_X)
+        {
+            CursorX = 0;
+            CursorY += RowSizeY + Padding;
+            CursorY = (CursorY + MipBlockSize - 1) & ~(MipBlockSize - 1);
+            RowSizeY = 0;
+        }
+
+        Glyph->AtlasOffsetX = CursorX;
+        Glyph->AtlasOffsetY = CursorY;
+        CursorX += Glyph->Texture.SizeX + Padding;
+        CursorX = (CursorX + MipBlockSize - 1) & ~(MipBlockSize - 1);
+        RowSizeY = (Glyph->Texture.SizeY > RowSizeY) ? Glyph->Texture.SizeY : RowSizeY;
+    }
+
+    bap_texture_buffer* Atlas = &FontBuffer->Atlas;
+    Atlas->SizeX = BAP_FONT_ATLAS_SIZE_X;
+    Atlas->SizeY = (CursorY + RowSizeY + MipBlockSize - 1) & ~(MipBlockSize - 1);
+    Atlas->SizeY = (Atlas->SizeY > 0) ? Atlas->SizeY : MipBlockSize;
+    Atlas->BytesPerPixel = 1;
+    Atlas->MipCount = 1;
+    Atlas->PixelBuffer = malloc(BAP_GetPixelBufferByteCount(Atlas->SizeX, Atlas->SizeY, Atlas->BytesPerPixel));
+    ZeroMemory(Atlas->PixelBuffer, BAP_GetPixelBufferByteCount(Atlas->SizeX, Atlas->SizeY, Atlas->BytesPerPixel));
+
+    for (u32 GlyphIndex = 0; GlyphIndex < FontBuffer->GlyphCount; ++GlyphIndex)
+    {
+        const bap_font_glyph* Glyph = FontBuffer->Glyphs + GlyphIndex;
+        for (u32 RowIndex = 0; RowIndex < Glyph->Texture.SizeY; ++RowIndex)
+        {
+            u8* DstRow = (u8*)Atlas->PixelBuffer + ((memory_size)(Glyph->AtlasOffsetY + RowIndex) * Atlas->SizeX) +
+                         Glyph->AtlasOffsetX;
+            const u8* SrcRow = (const u8*)Glyph->Texture.PixelBuffer + ((memory_size)RowIndex * Glyph->Texture.SizeX);
+            CopyMemory(DstRow, SrcRow, Glyph->Texture.SizeX);
+        }
+    }
+
+    BAP_GenerateMipChain(Atlas, BAP_GLYPH_MAX_MIP_COUNT);
+}
+
 internal bap_font_buffer
 BAP_LoadFontFromFile(const char* AssetRootDirectoryPath, const char* FileName, float FontHeight,
                      const char* Codepoints, u32 CodepointCount)
@@ -210,25 +392,46 @@ BAP_LoadFontFromFile(const char* AssetRootDirectoryPath, const char* FileName, f
             FontBuffer.GlyphCount = CodepointCount;
             FontBuffer.Glyphs = (bap_font_glyph*)malloc(CodepointCount * sizeof(bap_font_glyph));
             ZERO_STRUCT_ARRAY(FontBuffer.Glyphs, CodepointCount);
-            FontBuffer.KerningTable = (s32*)malloc(CodepointCount * CodepointCount * sizeof(s32));
-            ZERO_STRUCT_ARRAY(FontBuffer.KerningTable, CodepointCount * CodepointCount);
 
             //
-            // NOTE(Traian): Generate the kerning table.
+            // NOTE(Traian): Generate the kerning pairs. Querying every pair is quadratic, but it only happens offline,
+            // while the game only stores (and loads) the pairs that actually have a kerning advance.
             //
 
+            FontBuffer.KerningPairOffsets = (u32*)malloc((CodepointCount + 1) * sizeof(u32));
+            u32 KerningPairCapacity = 64;
+            FontBuffer.KerningPairs = (asset_font_kerning_pair*)malloc(KerningPairCapacity *
+                                                                       sizeof(asset_font_kerning_pair));
+
             for (u32 FirstCodepointIndex = 0; FirstCodepointIndex < CodepointCount; ++FirstCodepointIndex)
             {
+                FontBuffer.KerningPairOffsets[FirstCodepointIndex] = FontBuffer.KerningPairCount;
                 for (u32 SecondCodepointIndex = 0; SecondCodepointIndex < CodepointCount; ++SecondCodepointIndex)
                 {
                     const u32 FirstCodepoint = Codepoints[FirstCodepointIndex];
                     const u32 SecondCodepoint = Codepoints[SecondCodepointIndex];
                     const int KernAdvance = stbtt_GetCodepointKernAdvance(&FontInfo, FirstCodepoint, SecondCodepoint);
 
-                    const u32 KerningTableIndex = (FirstCodepointIndex * CodepointCount) + SecondCodepointIndex;
-                    FontBuffer.KerningTable[KerningTableIndex] = Scale * KernAdvance;
+                    const s32 ScaledKernAdvance = Scale * KernAdvance;
+                    if (ScaledKernAdvance != 0)
+                    {
+                        if (FontBuffer.KerningPairCount == KerningPairCapacity)
+                        {
+                            KerningPairCapacity *= 2;
+                            const memory_size KerningPairsByteCount = KerningPairCapacity *
+                                                                      sizeof(asset_font_kerning_pair);
+                            FontBuffer.KerningPairs = (asset_font_kerning_pair*)realloc(FontBuffer.KerningPairs,
+                                                                                        KerningPairsByteCount);
+                        }
+
+                        asset_font_kerning_pair* KerningPair = FontBuffer.KerningPairs + FontBuffer.KerningPairCount;
+                        KerningPair->SecondGlyphIndex = SecondCodepointIndex;
+                        KerningPair->Advance = ScaledKernAdvance;
+                        ++FontBuffer.KerningPairCount;
+                    }
                 }
             }
+            FontBuffer.KerningPairOffsets[CodepointCount] = FontBuffer.KerningPairCount;
 
             //
             // NOTE(Traian): Generate glyph metrics and textures.
@@ -276,9 +479,41 @@ BAP_LoadFontFromFile(const char* AssetRootDirectoryPath, const char* FileName, f
                     }
 
                     stbtt_FreeBitmap(GlyphTextureData, NULL);
+                    Glyph->Texture.MipCount = 1;
+                }
+            }
+
+            //
+            // NOTE(Traian): Generate the codepoint to glyph index table. Codepoints that are missing from the font
+            // don't map to any glyph.
+            //
+
+            FontBuffer.FirstCodepoint = 0xFFFFFFFF;
+            u32 LastCodepoint = 0;
+            for (u32 CodepointIndex = 0; CodepointIndex < CodepointCount; ++CodepointIndex)
+            {
+                const u32 Codepoint = Codepoints[CodepointIndex];
+                FontBuffer.FirstCodepoint = (Codepoint < FontBuffer.FirstCodepoint) ? Codepoint : FontBuffer.FirstCodepoint;
+                LastCodepoint = (Codepoint > LastCodepoint) ? Codepoint : LastCodepoint;
+            }
+            FontBuffer.CodepointCount = (CodepointCount > 0) ? (LastCodepoint - FontBuffer.FirstCodepoint + 1) : 0;
+            FontBuffer.FirstCodepoint = (CodepointCount > 0) ? FontBuffer.FirstCodepoint : 0;
+            FontBuffer.GlyphIndices = (u32*)malloc(FontBuffer.CodepointCount * sizeof(u32));
+            for (u32 CodepointOffset = 0; CodepointOffset < FontBuffer.CodepointCount; ++CodepointOffset)
+            {
+                FontBuffer.GlyphIndices[CodepointOffset] = ASSET_FONT_INVALID_GLYPH_INDEX;
+            }
+            for (u32 CodepointIndex = 0; CodepointIndex < CodepointCount; ++CodepointIndex)
+            {
+                const bap_font_glyph* Glyph = FontBuffer.Glyphs + CodepointIndex;
+                if (Glyph->Codepoint != 0)
+                {
+                    FontBuffer.GlyphIndices[Glyph->Codepoint - FontBuffer.FirstCodepoint] = CodepointIndex;
                 }
             }
 
+            BAP_PackFontAtlas(&FontBuffer);
+
             free(ReadResult.FileData);
             return FontBuffer;  
         }
@@ -302,6 +537,12 @@ struct bap_asset_texture
     game_asset_id               AssetID;
     asset_pack_entry_header*    EntryHeader;
     bap_texture_buffer          TextureBuffer;
+    // NOTE(Traian): When the texture is packed into the sprite atlas, only its rectangle in the atlas page (and its
+    // row spans) are written to the asset pack, as its pixels are written as part of the page.
+    b8                          IsInAtlas;
+    u32                         AtlasPageIndex;
+    u32                         AtlasOffsetX;
+    u32                         AtlasOffsetY;
 };
 
 struct bap_asset_font
@@ -311,12 +552,28 @@ struct bap_asset_font
     bap_font_buffer             FontBuffer;
 };
 
+// NOTE(Traian): The width of all sprite atlas pages, and the maximum height a page can grow to before a new page
+// is started. The page height is only as large as needed for the sprites it contains.
+#define BAP_SPRITE_ATLAS_PAGE_SIZE_X        (2048)
+#define BAP_SPRITE_ATLAS_MAX_PAGE_SIZE_Y    (4096)
+#define BAP_SPRITE_ATLAS_MAX_PAGE_COUNT     (8)
+
+struct bap_sprite_atlas
+{
+    asset_pack_entry_header*    EntryHeader;
+    u32                         PageCount;
+    // NOTE(Traian): All pages have 'BAP_TEXTURE_MAX_MIP_COUNT' mips.
+    bap_texture_buffer          Pages[BAP_SPRITE_ATLAS_MAX_PAGE_COUNT];
+};
+
 struct bap_asset_pack
 {
     u32                 TextureCount;
     bap_asset_texture*  Textures;
     u32                 FontCount;
     bap_asset_font*     Fonts;
+    b8                  HasSpriteAtlas;
+    bap_sprite_atlas    SpriteAtlas;
 };
 
 internal void
@@ -386,41 +643,557 @@ BAP_GenerateAssetPack(bap_asset_pack* AssetPack, const char* AssetRootDirectoryP
     }
 }
 
+//====================================================================================================================//
+//------------------------------------------------ SPRITE ATLAS PACKING ----------------------------------------------//
+//====================================================================================================================//
+
+//
+// NOTE(Traian): Copies the given mip of the sprite into the corresponding mip of its page. The two columns to the right
+// and the two rows above the rectangle of the mip replicate its edges, which is exactly what the runtime samplers read
+// from the border of a standalone (padded) mip.
+//
+internal void
+BAP_CopySpriteMipToAtlasPage(bap_texture_buffer* Page, const bap_asset_texture* Texture, u32 MipLevel)
+{
+    const memory_size BytesPerPixel = Page->BytesPerPixel;
+    const bap_texture_buffer* TextureBuffer = &Texture->TextureBuffer;
+
+    const u8* SrcMip = (const u8*)TextureBuffer->PixelBuffer +
+                       BAP_GetMipChainByteCount(TextureBuffer->SizeX, TextureBuffer->SizeY, BytesPerPixel, MipLevel);
+    const u32 SrcSizeX = TextureBuffer->SizeX >> MipLevel;
+    const u32 SrcSizeY = TextureBuffer->SizeY >> MipLevel;
+
+    u8* DstMip = (u8*)Page->PixelBuffer + BAP_GetMipChainByteCount(Page->SizeX, Page->SizeY, BytesPerPixel, MipLevel);
+    const u32 DstSizeX = Page->SizeX >> MipLevel;
+    const u32 DstOffsetX = Texture->AtlasOffsetX >> MipLevel;
+    const u32 DstOffsetY = Texture->AtlasOffsetY >> MipLevel;
+
+    for (u32 PixelIndexY = 0; PixelIndexY < SrcSizeY + 2; ++PixelIndexY)
+    {
+        const u32 SrcPixelY = (PixelIndexY < SrcSizeY) ? PixelIndexY : (SrcSizeY - 1);
+        for (u32 PixelIndexX = 0; PixelIndexX < SrcSizeX + 2; ++PixelIndexX)
+        {
+            const u32 SrcPixelX = (PixelIndexX < SrcSizeX) ? PixelIndexX : (SrcSizeX - 1);
+            const memory_size SrcPixelIndex = ((memory_size)SrcPixelY * SrcSizeX) + SrcPixelX;
+            const memory_size DstPixelIndex = ((memory_size)(DstOffsetY + PixelIndexY) * DstSizeX) +
+                                              (DstOffsetX + PixelIndexX);
+            CopyMemory(DstMip + (DstPixelIndex * BytesPerPixel), SrcMip + (SrcPixelIndex * BytesPerPixel),
+                       BytesPerPixel);
+        }
+    }
+}
+
+//
+// NOTE(Traian): Packs all sprite textures into the pages of the sprite atlas, using a simple shelf packer (the sprites
+// are placed from the tallest to the shortest). The sprite offsets are aligned to the size of a texel of the last mip,
+// so the rectangle of each mip starts exactly at half the offset of the previous one, and the sprites are separated by
+// enough texels that each one keeps a two texel border even in the last mip.
+//
+internal void
+BAP_PackSpriteAtlas(bap_asset_pack* AssetPack)
+{
+    const u32 MipBlockSize = 1 << (BAP_TEXTURE_MAX_MIP_COUNT - 1);
+    const u32 Padding = 2 * MipBlockSize;
+    const memory_size BytesPerPixel = 4;
+
+    u32* SortedTextureIndices = (u32*)malloc(AssetPack->TextureCount * sizeof(u32));
+    for (u32 TextureIndex = 0; TextureIndex < AssetPack->TextureCount; ++TextureIndex)
+    {
+        const bap_texture_buffer* TextureBuffer = &AssetPack->Textures[TextureIndex].TextureBuffer;
+        if (TextureBuffer->BytesPerPixel != BytesPerPixel)
+        {
+            PANIC("Invalid sprite texture BPP when trying to pack it into the sprite atlas!");
+        }
+        if (TextureBuffer->SizeX + Padding > BAP_SPRITE_ATLAS_PAGE_SIZE_X ||
+            TextureBuffer->SizeY + Padding > BAP_SPRITE_ATLAS_MAX_PAGE_SIZE_Y)
+        {
+            PANIC("Sprite texture is too large to be packed into the sprite atlas!");
+        }
+
+        // NOTE(Traian): Insertion sort, as there are only a few sprites.
+        u32 InsertIndex = TextureIndex;
+        while (InsertIndex > 0 &&
+               AssetPack->Textures[SortedTextureIndices[InsertIndex - 1]].TextureBuffer.SizeY < TextureBuffer->SizeY)
+        {
+            SortedTextureIndices[InsertIndex] = SortedTextureIndices[InsertIndex - 1];
+            --InsertIndex;
+        }
+        SortedTextureIndices[InsertIndex] = TextureIndex;
+    }
+
+    bap_sprite_atlas* Atlas = &AssetPack->SpriteAtlas;
+    ZERO_STRUCT_POINTER(Atlas);
+    AssetPack->HasSpriteAtlas = true;
+
+    // NOTE(Traian): Place the sprites on shelves, starting a new page when a shelf would exceed the page height.
+    u32 PageIndex = 0;
+    u32 ShelfOffsetY = 0;
+    u32 ShelfSizeY = 0;
+    u32 CursorX = 0;
+    u32 PageSizeX[BAP_SPRITE_ATLAS_MAX_PAGE_COUNT] = {};
+    u32 PageSizeY[BAP_SPRITE_ATLAS_MAX_PAGE_COUNT] = {};
+    for (u32 SortedIndex = 0; SortedIndex < AssetPack->TextureCount; ++SortedIndex)
+    {
+        bap_asset_texture* Texture = AssetPack->Textures + SortedTextureIndices[SortedIndex];
+        // NOTE(Traian): The smallest aligned cell that keeps a two texel border to the right and above the rectangle
+        // of every mip, as the last mip is the one that requires the largest border (relative to its texel size).
+        const u32 CellSizeX = (Texture->TextureBuffer.SizeX & ~(MipBlockSize - 1)) + Padding;
+        const u32 CellSizeY = (Texture->TextureBuffer.SizeY & ~(MipBlockSize - 1)) + Padding;
+
+        if (CursorX + CellSizeX > BAP_SPRITE_ATLAS_PAGE_SIZE_X)
+        {
+            ShelfOffsetY += ShelfSizeY;
+            ShelfSizeY = 0;
+            CursorX = 0;
+        }
+        if (ShelfOffsetY + CellSizeY > BAP_SPRITE_ATLAS_MAX_PAGE_SIZE_Y)
+        {
+            ++PageIndex;
+            ShelfOffsetY = 0;
+            ShelfSizeY = 0;
+            CursorX = 0;
+        }
+        if (PageIndex >= BAP_SPRITE_ATLAS_MAX_PAGE_COUNT)
+        {
+            PANIC("The sprites don't fit in the maximum number of sprite atlas pages!");
+        }
+
+        Texture->IsInAtlas = true;
+        Texture->AtlasPageIndex = PageIndex;
+        Texture->AtlasOffsetX = CursorX;
+        Texture->AtlasOffsetY = ShelfOffsetY;
+
+        CursorX += CellSizeX;
+        ShelfSizeY = (ShelfSizeY > CellSizeY) ? ShelfSizeY : CellSizeY;
+        PageSizeX[PageIndex] = (PageSizeX[PageIndex] > CursorX) ? PageSizeX[PageIndex] : CursorX;
+        PageSizeY[PageIndex] = (PageSizeY[PageIndex] > ShelfOffsetY + ShelfSizeY) ? PageSizeY[PageIndex]
+                                                                                    : (ShelfOffsetY + ShelfSizeY);
+    }
+    Atlas->PageCount = (AssetPack->TextureCount > 0) ? (PageIndex + 1) : 0;
+    free(SortedTextureIndices);
+
+    // NOTE(Traian): Build the mip chain of each page from the mips of its sprites. The texels that are not covered by
+    // any sprite (or by its border) are left transparent.
+    for (u32 AtlasPageIndex = 0; AtlasPageIndex < Atlas->PageCount; ++AtlasPageIndex)
+    {
+        bap_texture_buffer* Page = Atlas->Pages + AtlasPageIndex;
+        Page->SizeX = PageSizeX[AtlasPageIndex];
+        Page->SizeY = PageSizeY[AtlasPageIndex];
+        Page->BytesPerPixel = BytesPerPixel;
+        Page->Flags = ASSET_TEXTURE_FLAG_PREMULTIPLIED_ALPHA;
+        Page->MipCount = BAP_TEXTURE_MAX_MIP_COUNT;
+
+        const memory_size MipChainByteCount = BAP_GetMipChainByteCount(Page->SizeX, Page->SizeY, BytesPerPixel,
+                                                                       Page->MipCount);
+        Page->PixelBuffer = malloc(MipChainByteCount);
+        ZeroMemory(Page->PixelBuffer, MipChainByteCount);
+    }
+
+    for (u32 TextureIndex = 0; TextureIndex < AssetPack->TextureCount; ++TextureIndex)
+    {
+        const bap_asset_texture* Texture = AssetPack->Textures + TextureIndex;
+        for (u32 MipLevel = 0; MipLevel < Texture->TextureBuffer.MipCount; ++MipLevel)
+        {
+            BAP_CopySpriteMipToAtlasPage(Atlas->Pages + Texture->AtlasPageIndex, Texture, MipLevel);
+        }
+    }
+}
+
+//====================================================================================================================//
+//------------------------------------------------- ASSET COMPRESSION ------------------------------------------------//
+//====================================================================================================================//
+
+// NOTE(Traian): Entries smaller than this are never compressed, as they are too small to benefit from it.
+#define BAP_COMPRESSION_MIN_ENTRY_BYTE_COUNT    KILOBYTES(64)
+#define BAP_LZ4_HASH_TABLE_SIZE                 (1 << 16)
+#define BAP_LZ4_MAX_MATCH_OFFSET                (65535)
+// NOTE(Traian): Restrictions imposed by the LZ4 block format: the last 5 bytes of a block are always literals, and
+// the last match must start at least 12 bytes before the end of the block.
+#define BAP_LZ4_LAST_LITERALS                   (5)
+#define BAP_LZ4_MATCH_FIND_LIMIT                (12)
+
+internal inline memory_size
+BAP_GetLZ4MaxCompressedByteCount(memory_size ByteCount)
+{
+    const memory_size Result = ByteCount + (ByteCount / 255) + 16;
+    return Result;
+}
+
+internal inline u8*
+BAP_EmitLZ4Length(u8* Dst, memory_size Length)
+{
+    // NOTE(Traian): Only the part of the length that doesn't fit in the token nibble is emitted here.
+    while (Length >= 255)
+    {
+        *Dst++ = 255;
+        Length -= 255;
+    }
+    *Dst++ = (u8)Length;
+    return Dst;
+}
+
+internal u8*
+BAP_EmitLZ4Sequence(u8* Dst, const u8* Literals, memory_size LiteralLength, memory_size MatchOffset,
+                    memory_size MatchLength)
+{
+    u8* Token = Dst++;
+    *Token = (u8)((LiteralLength < 15 ? LiteralLength : 15) << 4);
+    if (LiteralLength >= 15)
+    {
+        Dst = BAP_EmitLZ4Length(Dst, LiteralLength - 15);
+    }
+    CopyMemory(Dst, Literals, LiteralLength);
+    Dst += LiteralLength;
+
+    // NOTE(Traian): The last sequence of a block only contains literals.
+    if (MatchLength > 0)
+    {
+        *Dst++ = (u8)(MatchOffset & 0xFF);
+        *Dst++ = (u8)(MatchOffset >> 8);
+        const memory_size EncodedMatchLength = MatchLength - 4;
+        *Token |= (u8)(EncodedMatchLength < 15 ? EncodedMatchLength : 15);
+        if (EncodedMatchLength >= 15)
+        {
+            Dst = BAP_EmitLZ4Length(Dst, EncodedMatchLength - 15);
+        }
+    }
+
+    return Dst;
+}
+
+//
+// NOTE(Traian): Compresses a block using the LZ4 block format, with a simple greedy parser that finds matches using
+// a hash table of the last position of each 4-byte sequence. The compression ratio is not as good as the one of the
+// reference implementation, but the output is decoded by exactly the same (fast) decoder.
+// The destination must have at least 'BAP_GetLZ4MaxCompressedByteCount(SrcByteCount)' bytes available.
+//
+internal memory_size
+BAP_CompressLZ4(const u8* Src, memory_size SrcByteCount, u8* Dst, u32* HashTable)
+{
+    u8* DstBegin = Dst;
+    for (u32 HashIndex = 0; HashIndex < BAP_LZ4_HASH_TABLE_SIZE; ++HashIndex)
+    {
+        HashTable[HashIndex] = 0xFFFFFFFF;
+    }
+
+    memory_size AnchorPosition = 0;
+    memory_size Position = 0;
+    if (SrcByteCount > BAP_LZ4_MATCH_FIND_LIMIT)
+    {
+        const memory_size MatchFindEnd = SrcByteCount - BAP_LZ4_MATCH_FIND_LIMIT;
+        const memory_size MatchEnd = SrcByteCount - BAP_LZ4_LAST_LITERALS;
+
+        while (Position < MatchFindEnd)
+        {
+            u32 Sequence;
+            CopyMemory(&Sequence, Src + Position, sizeof(u32));
+            const u32 HashIndex = (Sequence * 2654435761U) >> 16;
+            const u32 CandidatePosition = HashTable[HashIndex];
+            HashTable[HashIndex] = (u32)Position;
+
+            u32 CandidateSequence = 0;
+            if (CandidatePosition != 0xFFFFFFFF)
+            {
+                CopyMemory(&CandidateSequence, Src + CandidatePosition, sizeof(u32));
+            }
+
+            if (CandidatePosition != 0xFFFFFFFF &&
+                Position - CandidatePosition <= BAP_LZ4_MAX_MATCH_OFFSET &&
+                CandidateSequence == Sequence)
+            {
+                memory_size MatchLength = 4;
+                while (Position + MatchLength < MatchEnd && Src[CandidatePosition + MatchLength] == Src[Position + MatchLength])
+                {
+                    ++MatchLength;
+                }
+
+                Dst = BAP_EmitLZ4Sequence(Dst, Src + AnchorPosition, Position - AnchorPosition,
+                                          Position - CandidatePosition, MatchLength);
+                Position += MatchLength;
+                AnchorPosition = Position;
+            }
+            else
+            {
+                ++Position;
+            }
+        }
+    }
+
+    Dst = BAP_EmitLZ4Sequence(Dst, Src + AnchorPosition, SrcByteCount - AnchorPosition, 0, 0);
+    const memory_size Result = Dst - DstBegin;
+    return Result;
+}
+
+//
+// NOTE(Traian): Replaces the (already written) entry with its compressed version, but only when compression actually
+// reduces its size by a meaningful amount. Otherwise, the entry is left untouched, so it can still be used in place
+// from the mapped asset file. The compressed entry is written at the same byte offset, so the uncompressed data keeps
+// its alignment when the game decompresses it.
+//
+internal void
+BAP_CompressEntry(memory_stream* Stream, asset_pack_entry_header* EntryHeader)
+{
+    if (EntryHeader->ByteCount < BAP_COMPRESSION_MIN_ENTRY_BYTE_COUNT)
+    {
+        return;
+    }
+
+    const memory_size UncompressedByteCount = EntryHeader->ByteCount;
+    u8* UncompressedData = (u8*)malloc(UncompressedByteCount);
+    CopyMemory(UncompressedData, (u8*)Stream->MemoryBlock + EntryHeader->ByteOffset, UncompressedByteCount);
+
+    const u32 ChunkCount = (u32)((UncompressedByteCount + ASSET_COMPRESSION_CHUNK_BYTE_COUNT - 1) /
+                                 ASSET_COMPRESSION_CHUNK_BYTE_COUNT);
+    asset_compressed_chunk* Chunks = (asset_compressed_chunk*)malloc(ChunkCount * sizeof(asset_compressed_chunk));
+    u8* CompressedData = (u8*)malloc(ChunkCount * BAP_GetLZ4MaxCompressedByteCount(ASSET_COMPRESSION_CHUNK_BYTE_COUNT));
+    u32* HashTable = (u32*)malloc(BAP_LZ4_HASH_TABLE_SIZE * sizeof(u32));
+
+    // NOTE(Traian): Compress each chunk independently. The chunk byte offsets are made relative to the entry after
+    // the size of the chunk table is known.
+    memory_size CompressedByteCount = 0;
+    for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+    {
+        const memory_size ChunkByteOffset = ChunkIndex * ASSET_COMPRESSION_CHUNK_BYTE_COUNT;
+        memory_size ChunkByteCount = UncompressedByteCount - ChunkByteOffset;
+        if (ChunkByteCount > ASSET_COMPRESSION_CHUNK_BYTE_COUNT)
+        {
+            ChunkByteCount = ASSET_COMPRESSION_CHUNK_BYTE_COUNT;
+        }
+
+        Chunks[ChunkIndex].ByteOffset = (u32)CompressedByteCount;
+        Chunks[ChunkIndex].ByteCount = (u32)BAP_CompressLZ4(UncompressedData + ChunkByteOffset, ChunkByteCount,
+                                                            CompressedData + CompressedByteCount, HashTable);
+        CompressedByteCount += Chunks[ChunkIndex].ByteCount;
+    }
+
+    // NOTE(Traian): Keep the entry uncompressed unless compression saves at least an eighth of its size.
+    const memory_size ChunkTableByteCount = ChunkCount * sizeof(asset_compressed_chunk) + alignof(asset_compressed_chunk);
+    if (ChunkTableByteCount + CompressedByteCount <= UncompressedByteCount - (UncompressedByteCount / 8))
+    {
+        // NOTE(Traian): Rewind the stream to the start of the entry and overwrite it with the compressed version.
+        Stream->ByteOffset = EntryHeader->ByteOffset;
+        asset_compressed_chunk* ChunkTable = PEEK_ARRAY(Stream, asset_compressed_chunk, ChunkCount);
+        EMIT_ARRAY(Stream, Chunks, ChunkCount);
+
+        const memory_size ChunkDataByteOffset = Stream->ByteOffset - EntryHeader->ByteOffset;
+        for (u32 ChunkIndex = 0; ChunkIndex < ChunkCount; ++ChunkIndex)
+        {
+            ChunkTable[ChunkIndex].ByteOffset += (u32)ChunkDataByteOffset;
+        }
+        EMIT_ARRAY(Stream, CompressedData, CompressedByteCount);
+
+        // NOTE(Traian): Clear the bytes of the uncompressed entry that were not overwritten, so they don't end up in the
+        // padding between the entries.
+        ZeroMemory((u8*)Stream->MemoryBlock + Stream->ByteOffset,
+                   EntryHeader->ByteOffset + UncompressedByteCount - Stream->ByteOffset);
+
+        EntryHeader->Compression = ASSET_COMPRESSION_LZ4;
+        EntryHeader->ByteCount = Stream->ByteOffset - EntryHeader->ByteOffset;
+        EntryHeader->UncompressedByteCount = UncompressedByteCount;
+    }
+
+    free(HashTable);
+    free(CompressedData);
+    free(Chunks);
+    free(UncompressedData);
+}
+
 //====================================================================================================================//
 //------------------------------------------------ ASSET PACK WRITING ------------------------------------------------//
 //====================================================================================================================//
 
+//
+// NOTE(Traian): Emits the mips of the texture with the border the runtime samplers expect: each row is followed by a
+// copy of its last pixel, and the last row (including its border pixel) is emitted once more. Tiled mips extend the
+// border up to a whole number of tiles and store the pixels in the tile order described by 'renderer_image_layout'.
+// The pixels of a mip are aligned to the size of a pixel, matching how the runtime consumes them from the asset pack.
+//
+internal void
+BAP_EmitPaddedMipChain(memory_stream* Stream, const bap_texture_buffer* TextureBuffer, b8 IsTiled)
+{
+    const memory_size BytesPerPixel = TextureBuffer->BytesPerPixel;
+    const u32 TileMask = RENDERER_IMAGE_TILE_SIZE - 1;
+    const u8* SrcMip = (const u8*)TextureBuffer->PixelBuffer;
+    for (u32 MipLevel = 0; MipLevel < TextureBuffer->MipCount; ++MipLevel)
+    {
+        const u32 MipSizeX = TextureBuffer->SizeX >> MipLevel;
+        const u32 MipSizeY = TextureBuffer->SizeY >> MipLevel;
+        const u32 PaddedSizeX = IsTiled ? ((MipSizeX + RENDERER_IMAGE_TILE_SIZE) & ~TileMask) : (MipSizeX + 1);
+        const u32 PaddedSizeY = IsTiled ? ((MipSizeY + RENDERER_IMAGE_TILE_SIZE) & ~TileMask) : (MipSizeY + 1);
+
+        u8* DstMip = (u8*)MemoryStream_Consume(Stream, BAP_GetPixelBufferByteCount(PaddedSizeX, PaddedSizeY,
+                                                                                   BytesPerPixel),
+                                               BytesPerPixel);
+        for (u32 PixelIndexY = 0; PixelIndexY < PaddedSizeY; ++PixelIndexY)
+        {
+            const u32 SrcPixelY = (PixelIndexY < MipSizeY) ? PixelIndexY : (MipSizeY - 1);
+            for (u32 PixelIndexX = 0; PixelIndexX < PaddedSizeX; ++PixelIndexX)
+            {
+                const u32 SrcPixelX = (PixelIndexX < MipSizeX) ? PixelIndexX : (MipSizeX - 1);
+                const memory_size SrcPixelIndex = ((memory_size)SrcPixelY * MipSizeX) + SrcPixelX;
+
+                memory_size DstPixelIndex = ((memory_size)PixelIndexY * PaddedSizeX) + PixelIndexX;
+                if (IsTiled)
+                {
+                    DstPixelIndex = ((memory_size)(PixelIndexY & ~TileMask) * PaddedSizeX) +
+                                    ((memory_size)(PixelIndexY & TileMask) * RENDERER_IMAGE_TILE_SIZE) +
+                                    ((memory_size)(PixelIndexX & ~TileMask) * RENDERER_IMAGE_TILE_SIZE) +
+                                    (memory_size)(PixelIndexX & TileMask);
+                }
+
+                CopyMemory(DstMip + (DstPixelIndex * BytesPerPixel), SrcMip + (SrcPixelIndex * BytesPerPixel),
+                           BytesPerPixel);
+            }
+        }
+
+        SrcMip += BAP_GetPixelBufferByteCount(MipSizeX, MipSizeY, BytesPerPixel);
+    }
+}
+
+internal renderer_image_row_span
+BAP_GetTextureRowSpan(const u32* RowPixels, u32 SizeX)
+{
+    if (SizeX > 0xFFFF)
+    {
+        PANIC("Texture is too wide to describe its rows!");
+    }
+
+    renderer_image_row_span RowSpan = {};
+    b8 HasVisiblePixels = false;
+    u32 OpaqueRunMinX = 0;
+    for (u32 PixelIndexX = 0; PixelIndexX < SizeX; ++PixelIndexX)
+    {
+        const u32 Alpha = RowPixels[PixelIndexX] >> 24;
+        if (Alpha > 0)
+        {
+            if (!HasVisiblePixels)
+            {
+                RowSpan.MinX = (u16)PixelIndexX;
+                HasVisiblePixels = true;
+            }
+            RowSpan.EndX = (u16)(PixelIndexX + 1);
+        }
+
+        if (Alpha == 0xFF)
+        {
+            if (PixelIndexX + 1 - OpaqueRunMinX > (u32)(RowSpan.OpaqueEndX - RowSpan.OpaqueMinX))
+            {
+                RowSpan.OpaqueMinX = (u16)OpaqueRunMinX;
+                RowSpan.OpaqueEndX = (u16)(PixelIndexX + 1);
+            }
+        }
+        else
+        {
+            OpaqueRunMinX = PixelIndexX + 1;
+        }
+    }
+
+    return RowSpan;
+}
+
+internal void
+BAP_EmitTextureRowSpans(memory_stream* Stream, const bap_texture_buffer* TextureBuffer)
+{
+    const u32* MipPixels = (const u32*)TextureBuffer->PixelBuffer;
+    for (u32 MipLevel = 0; MipLevel < TextureBuffer->MipCount; ++MipLevel)
+    {
+        const u32 MipSizeX = TextureBuffer->SizeX >> MipLevel;
+        const u32 MipSizeY = TextureBuffer->SizeY >> MipLevel;
+        for (u32 RowIndex = 0; RowIndex < MipSizeY; ++RowIndex)
+        {
+            const u32* RowPixels = MipPixels + ((memory_size)RowIndex * MipSizeX);
+            const renderer_image_row_span RowSpan = BAP_GetTextureRowSpan(RowPixels, MipSizeX);
+            EMIT(Stream, RowSpan);
+        }
+        MipPixels += (memory_size)MipSizeX * MipSizeY;
+    }
+}
+
 internal void
 BAP_WriteTexture(memory_stream* Stream, const bap_asset_texture* Texture)
 {
     // NOTE(Traian): Fill available information in the entry header.
     asset_pack_entry_header* EntryHeader = Texture->EntryHeader;
     EntryHeader->AssetID = Texture->AssetID;
-    EntryHeader->Type = ASSET_TYPE_TEXTURE;
+    EntryHeader->Type = Texture->IsInAtlas ? ASSET_TYPE_ATLAS_TEXTURE : ASSET_TYPE_TEXTURE;
+    EntryHeader->Compression = ASSET_COMPRESSION_NONE;
     EntryHeader->ByteOffset = Stream->ByteOffset;
 
-    // NOTE(Traian): Emit the header.
-    asset_header_texture TextureHeader = {};
-    TextureHeader.SizeX = Texture->TextureBuffer.SizeX;
-    TextureHeader.SizeY = Texture->TextureBuffer.SizeY;
-    TextureHeader.BytesPerPixel = Texture->TextureBuffer.BytesPerPixel;
-    EMIT(Stream, TextureHeader);
+    if (Texture->TextureBuffer.BytesPerPixel != 4)
+    {
+        PANIC("Invalid texture BPP when trying to write it to the asset pack!");
+    }
 
-    // NOTE(Traian): Emit the pixel buffer.
-    const memory_size PixelBufferByteCount = BAP_GetPixelBufferByteCount(TextureHeader.SizeX,
-                                                                         TextureHeader.SizeY,
-                                                                         TextureHeader.BytesPerPixel);
-    if (TextureHeader.BytesPerPixel == 4)
+    if (Texture->IsInAtlas)
     {
-        EMIT_ARRAY(Stream, (u32*)Texture->TextureBuffer.PixelBuffer, PixelBufferByteCount / sizeof(u32));
+        // NOTE(Traian): Emit the header. The pixels are already written as part of the sprite atlas page.
+        asset_header_atlas_texture TextureHeader = {};
+        TextureHeader.PageIndex = Texture->AtlasPageIndex;
+        TextureHeader.OffsetX = Texture->AtlasOffsetX;
+        TextureHeader.OffsetY = Texture->AtlasOffsetY;
+        TextureHeader.SizeX = Texture->TextureBuffer.SizeX;
+        TextureHeader.SizeY = Texture->TextureBuffer.SizeY;
+        TextureHeader.Flags = Texture->TextureBuffer.Flags;
+        TextureHeader.MipCount = Texture->TextureBuffer.MipCount;
+        EMIT(Stream, TextureHeader);
     }
     else
     {
-        PANIC("Invalid texture BPP when trying to write it to the asset pack!");
+        // NOTE(Traian): Emit the header.
+        asset_header_texture TextureHeader = {};
+        TextureHeader.SizeX = Texture->TextureBuffer.SizeX;
+        TextureHeader.SizeY = Texture->TextureBuffer.SizeY;
+        TextureHeader.BytesPerPixel = Texture->TextureBuffer.BytesPerPixel;
+        TextureHeader.Flags = Texture->TextureBuffer.Flags;
+        TextureHeader.MipCount = Texture->TextureBuffer.MipCount;
+        EMIT(Stream, TextureHeader);
+
+        // NOTE(Traian): Emit the pixel buffer (which contains the whole mip chain).
+        BAP_EmitPaddedMipChain(Stream, &Texture->TextureBuffer,
+                               (TextureHeader.Flags & ASSET_TEXTURE_FLAG_TILED) != 0);
     }
 
+    // NOTE(Traian): Emit the row spans of all mips.
+    BAP_EmitTextureRowSpans(Stream, &Texture->TextureBuffer);
+
     // NOTE(Traian): Finalize the entry header.
     EntryHeader->ByteCount = Stream->ByteOffset - EntryHeader->ByteOffset;
+    EntryHeader->UncompressedByteCount = EntryHeader->ByteCount;
+}
+
+internal void
+BAP_WriteSpriteAtlas(memory_stream* Stream, const bap_sprite_atlas* Atlas)
+{
+    // NOTE(Traian): Fill available information in the entry header.
+    asset_pack_entry_header* EntryHeader = Atlas->EntryHeader;
+    EntryHeader->AssetID = GAME_ASSET_ID_SPRITE_ATLAS;
+    EntryHeader->Type = ASSET_TYPE_SPRITE_ATLAS;
+    EntryHeader->Compression = ASSET_COMPRESSION_NONE;
+    EntryHeader->ByteOffset = Stream->ByteOffset;
+
+    // NOTE(Traian): Emit the header and the page headers.
+    asset_header_sprite_atlas AtlasHeader = {};
+    AtlasHeader.PageCount = Atlas->PageCount;
+    AtlasHeader.MipCount = BAP_TEXTURE_MAX_MIP_COUNT;
+    EMIT(Stream, AtlasHeader);
+
+    for (u32 PageIndex = 0; PageIndex < Atlas->PageCount; ++PageIndex)
+    {
+        asset_sprite_atlas_page_header PageHeader = {};
+        PageHeader.SizeX = Atlas->Pages[PageIndex].SizeX;
+        PageHeader.SizeY = Atlas->Pages[PageIndex].SizeY;
+        EMIT(Stream, PageHeader);
+    }
+
+    // NOTE(Traian): Emit the pixel buffer of each page (which contains the whole mip chain).
+    for (u32 PageIndex = 0; PageIndex < Atlas->PageCount; ++PageIndex)
+    {
+        BAP_EmitPaddedMipChain(Stream, Atlas->Pages + PageIndex, false);
+    }
+
+    // NOTE(Traian): Finalize the entry header.
+    EntryHeader->ByteCount = Stream->ByteOffset - EntryHeader->ByteOffset;
+    EntryHeader->UncompressedByteCount = EntryHeader->ByteCount;
 }
 
 internal void
@@ -430,6 +1203,7 @@ BAP_WriteFont(memory_stream* Stream, const bap_asset_font* Font)
     asset_pack_entry_header* EntryHeader = Font->EntryHeader;
     EntryHeader->AssetID = Font->AssetID;
     EntryHeader->Type = ASSET_TYPE_FONT;
+    EntryHeader->Compression = ASSET_COMPRESSION_NONE;
     EntryHeader->ByteOffset = Stream->ByteOffset;
 
     // NOTE(Traian): Emit the header.
@@ -439,45 +1213,54 @@ BAP_WriteFont(memory_stream* Stream, const bap_asset_font* Font)
     FontHeader.Descent = Font->FontBuffer.Descent;
     FontHeader.LineGap = Font->FontBuffer.LineGap;
     FontHeader.GlyphCount = Font->FontBuffer.GlyphCount;
+    FontHeader.FirstCodepoint = Font->FontBuffer.FirstCodepoint;
+    FontHeader.CodepointCount = Font->FontBuffer.CodepointCount;
+    FontHeader.AtlasSizeX = Font->FontBuffer.Atlas.SizeX;
+    FontHeader.AtlasSizeY = Font->FontBuffer.Atlas.SizeY;
+    FontHeader.AtlasMipCount = Font->FontBuffer.Atlas.MipCount;
+    FontHeader.KerningPairCount = Font->FontBuffer.KerningPairCount;
     EMIT(Stream, FontHeader);
 
-    // NOTE(Traian): Emit the glyphs.
+    // NOTE(Traian): Emit the glyph headers.
     for (u32 GlyphIndex = 0; GlyphIndex < Font->FontBuffer.GlyphCount; ++GlyphIndex)
     {
         const bap_font_glyph* Glyph = Font->FontBuffer.Glyphs + GlyphIndex;
 
-        // NOTE(Traian): Emit the glyph header.
         asset_font_glyph_header GlyphHeader = {};
         GlyphHeader.Codepoint = Glyph->Codepoint;
         GlyphHeader.AdvanceWidth = Glyph->AdvanceWidth;
         GlyphHeader.LeftSideBearing = Glyph->LeftSideBearing;
         GlyphHeader.TextureOffsetX = Glyph->TextureOffsetX;
         GlyphHeader.TextureOffsetY = Glyph->TextureOffsetY;
-        GlyphHeader.TextureSizeX = Glyph->Texture.SizeX;
-        GlyphHeader.TextureSizeY = Glyph->Texture.SizeY;
+        GlyphHeader.AtlasOffsetX = Glyph->AtlasOffsetX;
+        GlyphHeader.AtlasOffsetY = Glyph->AtlasOffsetY;
+        GlyphHeader.SizeX = Glyph->Texture.SizeX;
+        GlyphHeader.SizeY = Glyph->Texture.SizeY;
         EMIT(Stream, GlyphHeader);
-
-        // NOTE(Traian): Emit the glyph texture pixel buffer.
-        const memory_size PixelBufferByteCount = BAP_GetPixelBufferByteCount(Glyph->Texture.SizeX,
-                                                                             Glyph->Texture.SizeY,
-                                                                             Glyph->Texture.BytesPerPixel);
-        EMIT_ARRAY(Stream, (u8*)Glyph->Texture.PixelBuffer, PixelBufferByteCount / sizeof(u8));
     }
 
-    // NOTE(Traian): Emit the kerning table.
-    EMIT_ARRAY(Stream, Font->FontBuffer.KerningTable, Font->FontBuffer.GlyphCount * Font->FontBuffer.GlyphCount);
+    // NOTE(Traian): Emit the codepoint to glyph index table.
+    EMIT_ARRAY(Stream, Font->FontBuffer.GlyphIndices, Font->FontBuffer.CodepointCount);
+
+    // NOTE(Traian): Emit the atlas pixel buffer (which contains the whole mip chain).
+    BAP_EmitPaddedMipChain(Stream, &Font->FontBuffer.Atlas, false);
+
+    // NOTE(Traian): Emit the kerning pairs.
+    EMIT_ARRAY(Stream, Font->FontBuffer.KerningPairOffsets, Font->FontBuffer.GlyphCount + 1);
+    EMIT_ARRAY(Stream, Font->FontBuffer.KerningPairs, Font->FontBuffer.KerningPairCount);
 
     // NOTE(Traian): Finalize the entry header.
     EntryHeader->ByteCount = Stream->ByteOffset - EntryHeader->ByteOffset;
+    EntryHeader->UncompressedByteCount = EntryHeader->ByteCount;
 }
 
 internal void
-BAP_WriteAssetPack(memory_stream* Stream, const bap_asset_pack* AssetPack)
+BAP_WriteAssetPack(memory_stream* Stream, bap_asset_pack* AssetPack, b8 CompressEntries)
 {
     // NOTE(Traian): Emit the asset pack header to the stream.
     asset_pack_header Header = {};
     Header.MagicWord = PVZ_ASSET_PACK_MAGIC_WORD;
-    Header.EntryCount = AssetPack->TextureCount + AssetPack->FontCount;
+    Header.EntryCount = AssetPack->TextureCount + AssetPack->FontCount + (AssetPack->HasSpriteAtlas ? 1 : 0);
     EMIT(Stream, Header);
 
     // NOTE(Traian): Emit all entry headers, without filling any information. They will be finalized
@@ -494,17 +1277,41 @@ BAP_WriteAssetPack(memory_stream* Stream, const bap_asset_pack* AssetPack)
         AssetPack->Fonts[FontIndex].EntryHeader = PEEK(Stream, asset_pack_entry_header);
         EMIT(Stream, EntryHeader);
     }
+    if (AssetPack->HasSpriteAtlas)
+    {
+        asset_pack_entry_header EntryHeader = {};
+        AssetPack->SpriteAtlas.EntryHeader = PEEK(Stream, asset_pack_entry_header);
+        EMIT(Stream, EntryHeader);
+    }
+
+    // NOTE(Traian): Write the sprite atlas to the stream.
+    if (AssetPack->HasSpriteAtlas)
+    {
+        BAP_WriteSpriteAtlas(Stream, &AssetPack->SpriteAtlas);
+        if (CompressEntries)
+        {
+            BAP_CompressEntry(Stream, AssetPack->SpriteAtlas.EntryHeader);
+        }
+    }
 
     // NOTE(Traian): Write texture assets to the stream.
     for (u32 TextureIndex = 0; TextureIndex < AssetPack->TextureCount; ++TextureIndex)
     {
         BAP_WriteTexture(Stream, AssetPack->Textures + TextureIndex);
+        if (CompressEntries)
+        {
+            BAP_CompressEntry(Stream, AssetPack->Textures[TextureIndex].EntryHeader);
+        }
     }
 
     // NOTE(Traian): Write font assets to the stream.
     for (u32 FontIndex = 0; FontIndex < AssetPack->FontCount; ++FontIndex)
     {
         BAP_WriteFont(Stream, AssetPack->Fonts + FontIndex);
+        if (CompressEntries)
+        {
+            BAP_CompressEntry(Stream, AssetPack->Fonts[FontIndex].EntryHeader);
+        }
     }
 }
 
@@ -515,7 +1322,7 @@ BAP_WriteAssetPack(memory_stream* Stream, const bap_asset_pack* AssetPack)
 function int
 main(int ArgumentCount, char** Arguments)
 {
-    if (ArgumentCount != 3)
+    if (ArgumentCount < 3)
     {
         printf("Incorrect number of arguments provided!\n");
         return 1;
@@ -523,16 +1330,54 @@ main(int ArgumentCount, char** Arguments)
     const char* AssetRootDirectoryPath = Arguments[1];
     const char* OutputFileName = Arguments[2];
 
+    // NOTE(Traian): Entries are stored uncompressed by default, so the game uses them in place from the mapped asset
+    // file and all running instances share the same (cached) pages. Compressing the large entries reduces the number
+    // of bytes that have to be read from disk, but each instance then decompresses them into its own memory.
+    b8 CompressEntries = false;
+    // NOTE(Traian): Sprite textures can be stored in the tiled layout, which keeps the texels sampled by minified
+    // sprites in fewer cache lines. As the mip selection already keeps the sampling close to one texel per pixel, the
+    // linear layout (whose texel pairs are fetched with single loads) is still faster for our scenes and the default.
+    b8 TileTextures = false;
+    for (int ArgumentIndex = 3; ArgumentIndex < ArgumentCount; ++ArgumentIndex)
+    {
+        if (strcmp(Arguments[ArgumentIndex], "--compress") == 0)
+        {
+            CompressEntries = true;
+        }
+        else if (strcmp(Arguments[ArgumentIndex], "--tiled-textures") == 0)
+        {
+            TileTextures = true;
+        }
+        else
+        {
+            printf("Unknown argument '%s' provided!\n", Arguments[ArgumentIndex]);
+            return 1;
+        }
+    }
+
     // NOTE(Traian): Generate the asset pack from the raw data files.
     bap_asset_pack AssetPack = {};
     BAP_GenerateAssetPack(&AssetPack, AssetRootDirectoryPath);
+    if (TileTextures)
+    {
+        // NOTE(Traian): A tiled mip can't be referenced as a rectangle of a larger image, so tiled sprites are kept
+        // as standalone textures instead of being packed into the sprite atlas.
+        for (u32 TextureIndex = 0; TextureIndex < AssetPack.TextureCount; ++TextureIndex)
+        {
+            AssetPack.Textures[TextureIndex].TextureBuffer.Flags |= ASSET_TEXTURE_FLAG_TILED;
+        }
+    }
+    else
+    {
+        BAP_PackSpriteAtlas(&AssetPack);
+    }
 
     // NOTE(Traian): Serialize the asset pack to a memory stream.
     memory_stream OutputStream = {};
-    OutputStream.ByteCount = MEGABYTES(32);
+    OutputStream.ByteCount = MEGABYTES(64);
     OutputStream.MemoryBlock = malloc(OutputStream.ByteCount);
     ZeroMemory(OutputStream.MemoryBlock, OutputStream.ByteCount);
-    BAP_WriteAssetPack(&OutputStream, &AssetPack);
+    BAP_WriteAssetPack(&OutputStream, &AssetPack, CompressEntries);
 
     // NOTE(Traian): Write the contents of the memory stream to the output file.
     FILE* OutputFile = fopen(OutputFileName, "wb");
@@ -11,6 +11,7 @@ SET SourceFiles=../source/pvz.cpp ^
 				../source/pvz_asset.cpp ^
 				../source/pvz_memory.cpp ^
 				../source/pvz_renderer.cpp ^
+				../source/pvz_task_queue.cpp ^
 				../source/pvz_windows.cpp
 
 ::
@@ -28,7 +29,7 @@ SET CommonCompilerFlags=/nologo /std:c++17 /GR- /D_HAS_EXCEPTIONS=0 /Zi /Ox
 SET CommonLinkerFlags=/nologo
 
 ECHO Compiling game source...
-cl %CommonCompilerFlags% %CommonCompilerDefines% %SourceFiles% /link %CommonLinkerFlags% user32.lib gdi32.lib /OUT:PVZ-Remake.exe
+cl %CommonCompilerFlags% %CommonCompilerDefines% %SourceFiles% /link %CommonLinkerFlags% user32.lib gdi32.lib synchronization.lib /OUT:PVZ-Remake.exe
 ECHO Done.
 
 ECHO.